@@ -42,7 +42,9 @@
 #include "config/preferences.h"
 #include "log.h"
 #include "xmpp/xmpp.h"
+#include "tools/intern.h"
 
+// sessions keyed on their own interned barejid
 static GHashTable *sessions;
 
 static void
@@ -53,20 +55,20 @@ _chat_session_new(const char * const barejid, const char * const resource,
     assert(resource != NULL);
 
     ChatSession *new_session = malloc(sizeof(struct chat_session_t));
-    new_session->barejid = strdup(barejid);
-    new_session->resource = strdup(resource);
+    new_session->barejid = (char*)intern_ref(barejid);
+    new_session->resource = (char*)intern_ref(resource);
     new_session->resource_override = resource_override;
     new_session->send_states = send_states;
 
-    g_hash_table_replace(sessions, strdup(barejid), new_session);
+    g_hash_table_replace(sessions, new_session->barejid, new_session);
 }
 
 static void
 _chat_session_free(ChatSession *session)
 {
     if (session != NULL) {
-        free(session->barejid);
-        free(session->resource);
+        intern_unref(session->barejid);
+        intern_unref(session->resource);
         free(session);
     }
 }
@@ -74,7 +76,7 @@ _chat_session_free(ChatSession *session)
 void
 chat_sessions_init(void)
 {
-    sessions = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+    sessions = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
         (GDestroyNotify)_chat_session_free);
 }
 
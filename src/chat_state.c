@@ -33,25 +33,36 @@
  */
 
 #include <stdlib.h>
+#include <string.h>
 
 #include <glib.h>
 
 #include "chat_state.h"
 #include "chat_session.h"
+#include "timers.h"
 #include "xmpp/xmpp.h"
 #include "config/preferences.h"
 
-#define PAUSED_TIMEOUT 10.0
-#define INACTIVE_TIMEOUT 30.0
+#define PAUSED_TIMEOUT 10000
+#define INACTIVE_TIMEOUT 30000
 
 static void _send_if_supported(const char * const barejid, void(*send_func)(const char * const));
+static void _chat_state_restart(ChatState *state);
+static gint _chat_state_idle_delay(ChatState *state);
+static gint _chat_state_idle_timeout(void *data);
+static void _chat_state_handle_idle(ChatState *state);
 
 ChatState*
-chat_state_new(void)
+chat_state_new(const char * const barejid)
 {
     ChatState *new_state = malloc(sizeof(struct prof_chat_state_t));
     new_state->type = CHAT_STATE_GONE;
-    new_state->timer = g_timer_new();
+    new_state->barejid = strdup(barejid);
+
+    GString *name = g_string_new("chat state ");
+    g_string_append(name, barejid);
+    new_state->timer = timers_add(name->str, TIMER_STOP, _chat_state_idle_timeout, new_state);
+    g_string_free(name, TRUE);
 
     return new_state;
 }
@@ -59,21 +70,54 @@ chat_state_new(void)
 void
 chat_state_free(ChatState *state)
 {
-    if (state && state->timer!= NULL) {
-        g_timer_destroy(state->timer);
+    if (state) {
+        timers_remove(state->timer);
+        free(state->barejid);
     }
     free(state);
 }
 
 void
-chat_state_handle_idle(const char * const barejid, ChatState *state)
+chat_state_handle_typing(const char * const barejid, ChatState *state)
+{
+    // ACTIVE|INACTIVE|PAUSED|GONE -> COMPOSING
+    if (state->type != CHAT_STATE_COMPOSING) {
+        state->type = CHAT_STATE_COMPOSING;
+        _chat_state_restart(state);
+        if (prefs_get_boolean(PREF_STATES) && prefs_get_boolean(PREF_OUTTYPE)) {
+            _send_if_supported(barejid, message_send_composing);
+        }
+    }
+}
+
+void
+chat_state_active(ChatState *state)
+{
+    state->type = CHAT_STATE_ACTIVE;
+    _chat_state_restart(state);
+}
+
+void
+chat_state_gone(const char * const barejid, ChatState *state)
+{
+    if (state->type != CHAT_STATE_GONE) {
+        if (prefs_get_boolean(PREF_STATES)) {
+            _send_if_supported(barejid, message_send_gone);
+        }
+        state->type = CHAT_STATE_GONE;
+        _chat_state_restart(state);
+    }
+}
+
+static void
+_chat_state_handle_idle(ChatState *state)
 {
-    gdouble elapsed = g_timer_elapsed(state->timer, NULL);
+    const char * const barejid = state->barejid;
 
     // TYPING -> PAUSED
-    if (state->type == CHAT_STATE_COMPOSING && elapsed > PAUSED_TIMEOUT) {
+    if (state->type == CHAT_STATE_COMPOSING) {
         state->type = CHAT_STATE_PAUSED;
-        g_timer_start(state->timer);
+        _chat_state_restart(state);
         if (prefs_get_boolean(PREF_STATES) && prefs_get_boolean(PREF_OUTTYPE)) {
             _send_if_supported(barejid, message_send_paused);
         }
@@ -81,9 +125,9 @@ chat_state_handle_idle(const char * const barejid, ChatState *state)
     }
 
     // PAUSED|ACTIVE -> INACTIVE
-    if ((state->type == CHAT_STATE_PAUSED || state->type == CHAT_STATE_ACTIVE) && elapsed > INACTIVE_TIMEOUT) {
+    if (state->type == CHAT_STATE_PAUSED || state->type == CHAT_STATE_ACTIVE) {
         state->type = CHAT_STATE_INACTIVE;
-        g_timer_start(state->timer);
+        _chat_state_restart(state);
         if (prefs_get_boolean(PREF_STATES)) {
             _send_if_supported(barejid, message_send_inactive);
         }
@@ -93,7 +137,7 @@ chat_state_handle_idle(const char * const barejid, ChatState *state)
 
     // INACTIVE -> GONE
     if (state->type == CHAT_STATE_INACTIVE) {
-        if (prefs_get_gone() != 0 && (elapsed > (prefs_get_gone() * 60.0))) {
+        if (prefs_get_gone() != 0) {
             ChatSession *session = chat_session_get(barejid);
             if (session) {
                 // never move to GONE when resource override
@@ -103,50 +147,59 @@ chat_state_handle_idle(const char * const barejid, ChatState *state)
                     }
                     chat_session_remove(barejid);
                     state->type = CHAT_STATE_GONE;
-                    g_timer_start(state->timer);
+                    _chat_state_restart(state);
                 }
             } else {
                 if (prefs_get_boolean(PREF_STATES)) {
                     message_send_gone(barejid);
                 }
                 state->type = CHAT_STATE_GONE;
-                g_timer_start(state->timer);
+                _chat_state_restart(state);
             }
             return;
         }
     }
 }
 
-void
-chat_state_handle_typing(const char * const barejid, ChatState *state)
+// the timer runs when the current state has timed out
+static gint
+_chat_state_idle_timeout(void *data)
 {
-    // ACTIVE|INACTIVE|PAUSED|GONE -> COMPOSING
-    if (state->type != CHAT_STATE_COMPOSING) {
-        state->type = CHAT_STATE_COMPOSING;
-        g_timer_start(state->timer);
-        if (prefs_get_boolean(PREF_STATES) && prefs_get_boolean(PREF_OUTTYPE)) {
-            _send_if_supported(barejid, message_send_composing);
-        }
+    ChatState *state = data;
+    if (jabber_get_connection_status() == JABBER_CONNECTED) {
+        _chat_state_handle_idle(state);
     }
+
+    // no transition, look again once the state could time out
+    return _chat_state_idle_delay(state);
 }
 
-void
-chat_state_active(ChatState *state)
+static gint
+_chat_state_idle_delay(ChatState *state)
 {
-    state->type = CHAT_STATE_ACTIVE;
-    g_timer_start(state->timer);
+    switch (state->type)
+    {
+        case CHAT_STATE_COMPOSING:
+            return PAUSED_TIMEOUT;
+        case CHAT_STATE_PAUSED:
+        case CHAT_STATE_ACTIVE:
+            return INACTIVE_TIMEOUT;
+        case CHAT_STATE_INACTIVE:
+            if (prefs_get_gone() != 0) {
+                return prefs_get_gone() * 60000;
+            } else {
+                // /gone may be switched on later
+                return 60000;
+            }
+        default:
+            return TIMER_STOP;
+    }
 }
 
-void
-chat_state_gone(const char * const barejid, ChatState *state)
+static void
+_chat_state_restart(ChatState *state)
 {
-    if (state->type != CHAT_STATE_GONE) {
-        if (prefs_get_boolean(PREF_STATES)) {
-            _send_if_supported(barejid, message_send_gone);
-        }
-        state->type = CHAT_STATE_GONE;
-        g_timer_start(state->timer);
-    }
+    timers_reset(state->timer, _chat_state_idle_delay(state));
 }
 
 static void
@@ -37,6 +37,8 @@
 
 #include <glib.h>
 
+#include "tools/timerwheel.h"
+
 typedef enum {
     CHAT_STATE_ACTIVE,
     CHAT_STATE_COMPOSING,
@@ -47,13 +49,13 @@ typedef enum {
 
 typedef struct prof_chat_state_t {
     chat_state_type_t type;
-    GTimer *timer;
+    char *barejid;
+    ProfTimer timer;
 } ChatState;
 
-ChatState* chat_state_new(void);
+ChatState* chat_state_new(const char * const barejid);
 void chat_state_free(ChatState *state);
 
-void chat_state_handle_idle(const char * const barejid, ChatState *state);
 void chat_state_handle_typing(const char * const barejid, ChatState *state);
 void chat_state_active(ChatState *state);
 void chat_state_gone(const char * const barejid, ChatState *state);
@@ -63,6 +63,7 @@
 #include "tools/autocomplete.h"
 #include "tools/parser.h"
 #include "tools/tinyurl.h"
+#include "tools/trie.h"
 #include "xmpp/xmpp.h"
 #include "xmpp/bookmark.h"
 #include "ui/ui.h"
@@ -74,7 +75,30 @@ static gboolean _cmd_execute(const char * const command, const char * const inp)
 static gboolean _cmd_execute_default(const char * inp);
 static gboolean _cmd_execute_alias(const char * const inp, gboolean *ran);
 
+// how the argument after a command is completed
+typedef enum {
+    COMPLETE_FUNC,      // func on the argument
+    COMPLETE_AC,        // ac on the argument, quoting the result
+    COMPLETE_NICK,      // nick in the current room, quotes stripped
+    COMPLETE_CONTACT,   // roster contact outside rooms, quotes stripped
+    COMPLETE_RESOURCE,  // full jid outside rooms
+    COMPLETE_INPUT      // func on the whole input, for commands with subcommands
+} completion_t;
+
+typedef struct cmd_completion_t {
+    char *cmd;
+    completion_t type;
+    autocomplete_func func;
+    Autocomplete *ac;
+    // match any input starting with cmd, not just cmd and a space
+    gboolean prefix;
+} CommandCompletion;
+
+static guint _command_slot(const char * const cmd, guint32 seed);
+static gboolean _fill_command_slots(guint32 seed);
+
 static char * _cmd_complete_parameters(const char * const input);
+static char * _complete_rule(const char * const input, int len, CommandCompletion *rule, char **unquoted);
 
 static char * _sub_autocomplete(const char * const input);
 static char * _notify_autocomplete(const char * const input);
@@ -101,9 +125,6 @@ static char * _affiliation_autocomplete(const char * const input);
 static char * _role_autocomplete(const char * const input);
 static char * _resource_autocomplete(const char * const input);
 static char * _titlebar_autocomplete(const char * const input);
-static char * _inpblock_autocomplete(const char * const input);
-
-GHashTable *commands = NULL;
 
 /*
  * Command list
@@ -472,6 +493,27 @@ static struct cmd_t command_defs[] =
           "swap source target : Swap windows, target may be an empty position.",
           NULL } } },
 
+    { "/stats",
+        cmd_stats, parse_args, 0, 0, NULL,
+        { "/stats", "Show resource usage statistics.",
+        { "/stats",
+          "------",
+          "Show memory and other resource usage of the user interface.",
+          "Window pads are only kept for the most recently focused windows,",
+          "other windows are rendered from their buffer when next focused.",
+          "Frames counts screen redraws, and wakeups that needed none.",
+          "Interned strings are the jids and nicks shared by roster, rooms and windows.",
+          NULL } } },
+
+    { "/timers",
+        cmd_timers, parse_args, 0, 0, NULL,
+        { "/timers", "List pending timers.",
+        { "/timers",
+          "-------",
+          "Show the periodic work waiting to run, such as autoaway checks,",
+          "reminders and reconnect attempts, with the time until each is due.",
+          NULL } } },
+
     { "/sub",
         cmd_sub, parse_args, 1, 2, NULL,
         { "/sub command [jid]", "Manage subscriptions.",
@@ -587,6 +629,15 @@ static struct cmd_t command_defs[] =
           "Enable or disable word wrapping in the main window.",
           NULL } } },
 
+    { "/fuzzy",
+        cmd_fuzzy, parse_args, 1, 1, &cons_fuzzy_setting,
+        { "/fuzzy on|off", "Fuzzy completion.",
+        { "/fuzzy on|off",
+          "-------------",
+          "When nothing starts with what has been typed, complete commands, contacts and room",
+          "nicks that contain the typed characters in order, best and most recently used first.",
+          NULL } } },
+
     { "/time",
         cmd_time, parse_args, 1, 1, &cons_time_setting,
         { "/time minutes|seconds", "Time display.",
@@ -595,21 +646,6 @@ static struct cmd_t command_defs[] =
           "Configure time precision for the main window.",
           NULL } } },
 
-    { "/inpblock",
-        cmd_inpblock, parse_args, 2, 2, &cons_inpblock_setting,
-        { "/inpblock timeout|dynamic [millis|on|off]", "Input blocking delay (dynamic or static).",
-        { "/inpblock timeout|dynamic [millis|on|off]",
-          "-----------------------------------------",
-          "How long to wait for input before checking for new messages or checking for state changes such as 'idle'.",
-          "timeout : Time to wait in milliseconds before reading input from the terminal buffer, defaults to 500.",
-          "        : Valid values are 1-1000.",
-          "dynamic : Start with a 0 timeout and increase the value dynamically up to the specified 'timeout'.",
-          "        : on|off",
-          "A higher timeout will result in less CPU usage, but a noticable delay for response to input.",
-          "A lower timeout will result in higher CPU usage, but faster response to input.",
-          "Using the dynamic setting, higher CPU usage will occur during activity, but over time the CPU usage will decrease whilst there is no activity.",
-          NULL } } },
-
     { "/notify",
         cmd_notify, parse_args, 2, 3, &cons_notify_setting,
         { "/notify [type value]|[type setting value]", "Control various desktop noficiations.",
@@ -708,6 +744,16 @@ static struct cmd_t command_defs[] =
           "goodbye - Show a message in the title when exiting profanity.",
           NULL  } } },
 
+    { "/framerate",
+        cmd_framerate, parse_args, 1, 1, &cons_frame_rate_setting,
+        { "/framerate fps", "Limit how often the screen is redrawn.",
+        { "/framerate fps",
+          "--------------",
+          "Set the maximum number of times per second the screen is redrawn.",
+          "Changes arriving faster than this are drawn together in the next frame.",
+          "A value of 0 redraws on every change.",
+          NULL  } } },
+
     { "/mouse",
         cmd_mouse, parse_args, 1, 1, &cons_mouse_setting,
         { "/mouse on|off", "Use profanity mouse handling.",
@@ -1042,6 +1088,15 @@ static struct cmd_t command_defs[] =
           NULL } } },
 };
 
+// command_defs by a hash of their name, each slot holds the command's
+// index plus one, or 0 when empty, no two commands share a slot
+#define COMMAND_SLOT_BITS 10
+static guint8 command_slots[1 << COMMAND_SLOT_BITS];
+
+// a seed that gives each command its own slot, cmd_init moves on to
+// the next one that does if a new command collides
+static guint32 command_seed = 2166136288U;
+
 static Autocomplete commands_ac;
 static Autocomplete who_room_ac;
 static Autocomplete who_roster_ac;
@@ -1059,6 +1114,7 @@ static Autocomplete autoconnect_ac;
 static Autocomplete titlebar_ac;
 static Autocomplete theme_ac;
 static Autocomplete theme_load_ac;
+static guint theme_load_generation;
 static Autocomplete account_ac;
 static Autocomplete account_set_ac;
 static Autocomplete account_clear_ac;
@@ -1092,7 +1148,82 @@ static Autocomplete occupants_ac;
 static Autocomplete occupants_default_ac;
 static Autocomplete time_ac;
 static Autocomplete resource_ac;
-static Autocomplete inpblock_ac;
+
+// tried in order for the command the input starts with
+static CommandCompletion completion_grammar[] = {
+    { "/beep",          COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/intype",        COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/states",        COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/outtype",       COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/flash",         COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/splash",        COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/chlog",         COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/grlog",         COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/mouse",         COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/history",       COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/vercheck",      COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/privileges",    COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/presence",      COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/wrap",          COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+    { "/fuzzy",         COMPLETE_FUNC,      prefs_autocomplete_boolean_choice },
+
+    { "/msg",           COMPLETE_NICK },
+    { "/msg",           COMPLETE_CONTACT },
+    { "/info",          COMPLETE_NICK },
+    { "/info",          COMPLETE_CONTACT },
+    { "/status",        COMPLETE_NICK },
+    { "/status",        COMPLETE_CONTACT },
+    { "/caps",          COMPLETE_NICK },
+    { "/caps",          COMPLETE_RESOURCE },
+    { "/software",      COMPLETE_NICK },
+    { "/software",      COMPLETE_RESOURCE },
+    { "/ping",          COMPLETE_RESOURCE },
+
+    { "/invite",        COMPLETE_FUNC,      roster_contact_autocomplete },
+    { "/decline",       COMPLETE_FUNC,      muc_invites_find },
+    { "/join",          COMPLETE_FUNC,      muc_invites_find },
+
+    { "/help",          COMPLETE_AC,        NULL, &help_ac },
+    { "/prefs",         COMPLETE_AC,        NULL, &prefs_ac },
+    { "/disco",         COMPLETE_AC,        NULL, &disco_ac },
+    { "/close",         COMPLETE_AC,        NULL, &close_ac },
+    { "/wins",          COMPLETE_AC,        NULL, &wins_ac },
+    { "/subject",       COMPLETE_AC,        NULL, &subject_ac },
+    { "/room",          COMPLETE_AC,        NULL, &room_ac },
+    { "/time",          COMPLETE_AC,        NULL, &time_ac },
+
+    { "/who",           COMPLETE_INPUT,     _who_autocomplete },
+    { "/sub",           COMPLETE_INPUT,     _sub_autocomplete },
+    { "/notify",        COMPLETE_INPUT,     _notify_autocomplete },
+    { "/autoaway",      COMPLETE_INPUT,     _autoaway_autocomplete },
+    { "/theme",         COMPLETE_INPUT,     _theme_autocomplete },
+    { "/log",           COMPLETE_INPUT,     _log_autocomplete },
+    { "/account",       COMPLETE_INPUT,     _account_autocomplete },
+    { "/roster",        COMPLETE_INPUT,     _roster_autocomplete },
+    { "/group",         COMPLETE_INPUT,     _group_autocomplete },
+    { "/bookmark",      COMPLETE_INPUT,     _bookmark_autocomplete },
+    { "/autoconnect",   COMPLETE_INPUT,     _autoconnect_autocomplete },
+    { "/otr",           COMPLETE_INPUT,     _otr_autocomplete },
+    { "/connect",       COMPLETE_INPUT,     _connect_autocomplete },
+    { "/statuses",      COMPLETE_INPUT,     _statuses_autocomplete },
+    { "/alias",         COMPLETE_INPUT,     _alias_autocomplete },
+    { "/join",          COMPLETE_INPUT,     _join_autocomplete },
+    { "/form",          COMPLETE_INPUT,     _form_autocomplete },
+    { "/occupants",     COMPLETE_INPUT,     _occupants_autocomplete },
+    { "/kick",          COMPLETE_INPUT,     _kick_autocomplete },
+    { "/ban",           COMPLETE_INPUT,     _ban_autocomplete },
+    { "/affiliation",   COMPLETE_INPUT,     _affiliation_autocomplete },
+    { "/role",          COMPLETE_INPUT,     _role_autocomplete },
+    { "/resource",      COMPLETE_INPUT,     _resource_autocomplete },
+    { "/titlebar",      COMPLETE_INPUT,     _titlebar_autocomplete },
+
+    // form fields are commands named after the field
+    { "/field",         COMPLETE_INPUT,     _form_field_autocomplete, NULL, TRUE },
+};
+
+// completion_grammar compiled by cmd_init, each command followed by a
+// space, or alone for prefix rules, maps to a list of its rules
+static Trie completion_trie;
 
 /*
  * Initialise command autocompleter and history
@@ -1102,7 +1233,8 @@ cmd_init(void)
 {
     log_info("Initialising commands");
 
-    commands_ac = autocomplete_new();
+    autocomplete_set_fuzzy(prefs_get_boolean(PREF_FUZZY));
+    commands_ac = autocomplete_new_fuzzy();
     aliases_ac = autocomplete_new();
 
     help_ac = autocomplete_new();
@@ -1116,15 +1248,16 @@ cmd_init(void)
     autocomplete_add(help_ac, "settings");
     autocomplete_add(help_ac, "navigation");
 
-    // load command defs into hash table
-    commands = g_hash_table_new(g_str_hash, g_str_equal);
+    // index command defs, command_defs itself is the table
+    G_STATIC_ASSERT(ARRAY_SIZE(command_defs) < G_MAXUINT8);
+    while (!_fill_command_slots(command_seed)) {
+        command_seed++;
+    }
+
     unsigned int i;
     for (i = 0; i < ARRAY_SIZE(command_defs); i++) {
         Command *pcmd = command_defs+i;
 
-        // add to hash
-        g_hash_table_insert(commands, pcmd->cmd, pcmd);
-
         // add to commands and help autocompleters
         autocomplete_add(commands_ac, pcmd->cmd);
         autocomplete_add(help_ac, pcmd->cmd+1);
@@ -1441,9 +1574,15 @@ cmd_init(void)
     autocomplete_add(resource_ac, "title");
     autocomplete_add(resource_ac, "message");
 
-    inpblock_ac = autocomplete_new();
-    autocomplete_add(inpblock_ac, "timeout");
-    autocomplete_add(inpblock_ac, "dynamic");
+    completion_trie = trie_new((GDestroyNotify)g_slist_free);
+    for (i = 0; i < ARRAY_SIZE(completion_grammar); i++) {
+        CommandCompletion *rule = &completion_grammar[i];
+        gchar *key = rule->prefix ? g_strdup(rule->cmd) : g_strconcat(rule->cmd, " ", NULL);
+        GSList *rules = trie_lookup(completion_trie, key);
+        rules = g_slist_append(rules, rule);
+        trie_insert(completion_trie, key, rules);
+        g_free(key);
+    }
 }
 
 void
@@ -1499,7 +1638,58 @@ cmd_uninit(void)
     autocomplete_free(occupants_default_ac);
     autocomplete_free(time_ac);
     autocomplete_free(resource_ac);
-    autocomplete_free(inpblock_ac);
+    trie_free(completion_trie);
+    completion_trie = NULL;
+    memset(command_slots, 0, sizeof(command_slots));
+}
+
+Command *
+cmd_get(const char * const cmd)
+{
+    guint index = command_slots[_command_slot(cmd, command_seed)];
+    if (index == 0 || strcmp(command_defs[index-1].cmd, cmd) != 0) {
+        return NULL;
+    }
+
+    return &command_defs[index-1];
+}
+
+Command *
+cmd_get_all(int *count)
+{
+    *count = ARRAY_SIZE(command_defs);
+    return command_defs;
+}
+
+// FNV-1a from seed, the top bits pick the slot
+static guint
+_command_slot(const char * const cmd, guint32 seed)
+{
+    guint32 hash = seed;
+    const char *curr = cmd;
+    while (*curr) {
+        hash = (hash ^ (guchar)*curr) * 16777619U;
+        curr++;
+    }
+
+    return hash >> (32 - COMMAND_SLOT_BITS);
+}
+
+static gboolean
+_fill_command_slots(guint32 seed)
+{
+    memset(command_slots, 0, sizeof(command_slots));
+
+    unsigned int i;
+    for (i = 0; i < ARRAY_SIZE(command_defs); i++) {
+        guint slot = _command_slot(command_defs[i].cmd, seed);
+        if (command_slots[slot] != 0) {
+            return FALSE;
+        }
+        command_slots[slot] = i + 1;
+    }
+
+    return TRUE;
 }
 
 gboolean
@@ -1601,93 +1791,12 @@ cmd_autocomplete(const char * const input)
     return NULL;
 }
 
+// every autocompleter drops its search when next used, so this stays
+// cheap however many there are
 void
 cmd_reset_autocomplete()
 {
-    roster_reset_search_attempts();
-    muc_invites_reset_ac();
-    accounts_reset_all_search();
-    accounts_reset_enabled_search();
-    prefs_reset_boolean_choice();
-    presence_reset_sub_request_search();
-    autocomplete_reset(help_ac);
-    autocomplete_reset(notify_ac);
-    autocomplete_reset(notify_message_ac);
-    autocomplete_reset(notify_room_ac);
-    autocomplete_reset(notify_typing_ac);
-    autocomplete_reset(sub_ac);
-
-    autocomplete_reset(who_room_ac);
-    autocomplete_reset(who_roster_ac);
-    autocomplete_reset(prefs_ac);
-    autocomplete_reset(log_ac);
-    autocomplete_reset(commands_ac);
-    autocomplete_reset(autoaway_ac);
-    autocomplete_reset(autoaway_mode_ac);
-    autocomplete_reset(autoconnect_ac);
-    autocomplete_reset(theme_ac);
-    if (theme_load_ac != NULL) {
-        autocomplete_free(theme_load_ac);
-        theme_load_ac = NULL;
-    }
-    autocomplete_reset(account_ac);
-    autocomplete_reset(account_set_ac);
-    autocomplete_reset(account_clear_ac);
-    autocomplete_reset(account_default_ac);
-    autocomplete_reset(disco_ac);
-    autocomplete_reset(close_ac);
-    autocomplete_reset(wins_ac);
-    autocomplete_reset(roster_ac);
-    autocomplete_reset(roster_option_ac);
-    autocomplete_reset(roster_by_ac);
-    autocomplete_reset(group_ac);
-    autocomplete_reset(titlebar_ac);
-    autocomplete_reset(bookmark_ac);
-    autocomplete_reset(bookmark_property_ac);
-    autocomplete_reset(otr_ac);
-    autocomplete_reset(otr_log_ac);
-    autocomplete_reset(otr_policy_ac);
-    autocomplete_reset(connect_property_ac);
-    autocomplete_reset(statuses_ac);
-    autocomplete_reset(statuses_setting_ac);
-    autocomplete_reset(alias_ac);
-    autocomplete_reset(aliases_ac);
-    autocomplete_reset(join_property_ac);
-    autocomplete_reset(room_ac);
-    autocomplete_reset(affiliation_ac);
-    autocomplete_reset(role_ac);
-    autocomplete_reset(privilege_cmd_ac);
-    autocomplete_reset(subject_ac);
-    autocomplete_reset(form_ac);
-    autocomplete_reset(form_field_multi_ac);
-    autocomplete_reset(occupants_ac);
-    autocomplete_reset(occupants_default_ac);
-    autocomplete_reset(time_ac);
-    autocomplete_reset(resource_ac);
-    autocomplete_reset(inpblock_ac);
-
-    if (ui_current_win_type() == WIN_CHAT) {
-        ProfChatWin *chatwin = wins_get_current_chat();
-        PContact contact = roster_get_contact(chatwin->barejid);
-        if (contact) {
-            p_contact_resource_ac_reset(contact);
-        }
-    }
-
-    if (ui_current_win_type() == WIN_MUC) {
-        ProfMucWin *mucwin = wins_get_current_muc();
-        muc_autocomplete_reset(mucwin->roomjid);
-        muc_jid_autocomplete_reset(mucwin->roomjid);
-    }
-
-    if (ui_current_win_type() == WIN_MUC_CONFIG) {
-        ProfMucConfWin *confwin = wins_get_current_muc_conf();
-        if (confwin->form) {
-            form_reset_autocompleters(confwin->form);
-        }
-    }
-
-    bookmark_autocomplete_reset();
+    autocomplete_reset_all();
 }
 
 /*
@@ -1756,7 +1865,7 @@ _cmd_execute(const char * const command, const char * const inp)
         return result;
     }
 
-    Command *cmd = g_hash_table_lookup(commands, command);
+    Command *cmd = cmd_get(command);
     gboolean result = FALSE;
 
     if (cmd != NULL) {
@@ -1849,13 +1958,12 @@ _cmd_execute_default(const char * inp)
                         if (prefs_get_boolean(PREF_CHLOG)) {
                             const char *jid = jabber_get_fulljid();
                             Jid *jidp = jid_create(jid);
-                            char *pref_otr_log = prefs_get_string(PREF_OTR_LOG);
+                            const char *pref_otr_log = prefs_peek_string(PREF_OTR_LOG);
                             if (strcmp(pref_otr_log, "on") == 0) {
                                 chat_log_chat(jidp->barejid, chatwin->barejid, inp, PROF_OUT_LOG, NULL);
                             } else if (strcmp(pref_otr_log, "redact") == 0) {
                                 chat_log_chat(jidp->barejid, chatwin->barejid, "[redacted]", PROF_OUT_LOG, NULL);
                             }
-                            prefs_free_string(pref_otr_log);
                             jid_destroy(jidp);
                         }
 
@@ -1910,147 +2018,112 @@ _cmd_execute_default(const char * inp)
     return TRUE;
 }
 
+int
+cmd_completion_lookup(const char * const input)
+{
+    int len = 0;
+    if (!trie_lookup_prefix(completion_trie, input, &len)) {
+        return 0;
+    }
+
+    return len;
+}
+
 static char *
 _cmd_complete_parameters(const char * const input)
 {
-    int i;
     char *result = NULL;
 
-    // autocomplete boolean settings
-    gchar *boolean_choices[] = { "/beep", "/intype", "/states", "/outtype",
-        "/flash", "/splash", "/chlog", "/grlog", "/mouse", "/history",
-        "/vercheck", "/privileges", "/presence", "/wrap" };
-
-    for (i = 0; i < ARRAY_SIZE(boolean_choices); i++) {
-        result = autocomplete_param_with_func(input, boolean_choices[i], prefs_autocomplete_boolean_choice);
-        if (result) {
-            return result;
-        }
+    // one walk of the input finds the command and where its argument starts
+    int len = 0;
+    GSList *rules = trie_lookup_prefix(completion_trie, input, &len);
+    char *unquoted = NULL;
+    while (rules && !result) {
+        result = _complete_rule(input, len, rules->data, &unquoted);
+        rules = g_slist_next(rules);
     }
+    free(unquoted);
 
-    // autocomplete nickname in chat rooms
-    if (ui_current_win_type() == WIN_MUC) {
-        ProfMucWin *mucwin = wins_get_current_muc();
-        Autocomplete nick_ac = muc_roster_ac(mucwin->roomjid);
-        if (nick_ac) {
-            gchar *nick_choices[] = { "/msg", "/info", "/caps", "/status", "/software" } ;
+    return result;
+}
 
-            // Remove quote character before and after names when doing autocomplete
-            char *unquoted = strip_arg_quotes(input);
-            for (i = 0; i < ARRAY_SIZE(nick_choices); i++) {
-                result = autocomplete_param_with_ac(unquoted, nick_choices[i], nick_ac, TRUE);
-                if (result) {
-                    free(unquoted);
-                    return result;
-                }
-            }
-            free(unquoted);
-        }
+// the command part of input, len bytes, followed by found
+static char *
+_complete_with(const char * const input, int len, char *found)
+{
+    if (!found) {
+        return NULL;
+    }
 
-    // otherwise autocomplete using roster
-    } else {
-        gchar *contact_choices[] = { "/msg", "/info", "/status" };
-        // Remove quote character before and after names when doing autocomplete
-        char *unquoted = strip_arg_quotes(input);
-        for (i = 0; i < ARRAY_SIZE(contact_choices); i++) {
-            result = autocomplete_param_with_func(unquoted, contact_choices[i], roster_contact_autocomplete);
-            if (result) {
-                free(unquoted);
-                return result;
-            }
-        }
-        free(unquoted);
+    GString *result = g_string_new_len(input, len);
+    g_string_append(result, found);
+    free(found);
 
-        gchar *resource_choices[] = { "/caps", "/software", "/ping" };
-        for (i = 0; i < ARRAY_SIZE(resource_choices); i++) {
-            result = autocomplete_param_with_func(input, resource_choices[i], roster_fulljid_autocomplete);
-            if (result) {
-                return result;
-            }
-        }
-    }
+    return g_string_free(result, FALSE);
+}
 
-    result = autocomplete_param_with_func(input, "/invite", roster_contact_autocomplete);
-    if (result) {
-        return result;
+// the argument of input completed by rule, input with its argument
+// unquoted is kept in unquoted for the next rule
+static char *
+_complete_rule(const char * const input, int len, CommandCompletion *rule, char **unquoted)
+{
+    const char *arg = &input[len];
+    if (rule->type == COMPLETE_INPUT) {
+        return rule->func(input);
     }
-
-    gchar *invite_choices[] = { "/decline", "/join" };
-    for (i = 0; i < ARRAY_SIZE(invite_choices); i++) {
-        result = autocomplete_param_with_func(input, invite_choices[i], muc_invites_find);
-        if (result) {
-            return result;
-        }
+    if (*arg == '\0') {
+        return NULL;
     }
 
-    gchar *cmds[] = { "/help", "/prefs", "/disco", "/close", "/wins", "/subject", "/room", "/time" };
-    Autocomplete completers[] = { help_ac, prefs_ac, disco_ac, close_ac, wins_ac, subject_ac, room_ac, time_ac };
+    win_type_t wintype = ui_current_win_type();
+    switch (rule->type) {
+        case COMPLETE_FUNC:
+            return _complete_with(input, len, rule->func(arg));
 
-    for (i = 0; i < ARRAY_SIZE(cmds); i++) {
-        result = autocomplete_param_with_ac(input, cmds[i], completers[i], TRUE);
-        if (result) {
-            return result;
-        }
-    }
+        case COMPLETE_AC:
+            return _complete_with(input, len, autocomplete_complete(*rule->ac, arg, TRUE));
 
-    GHashTable *ac_funcs = g_hash_table_new(g_str_hash, g_str_equal);
-    g_hash_table_insert(ac_funcs, "/who",           _who_autocomplete);
-    g_hash_table_insert(ac_funcs, "/sub",           _sub_autocomplete);
-    g_hash_table_insert(ac_funcs, "/notify",        _notify_autocomplete);
-    g_hash_table_insert(ac_funcs, "/autoaway",      _autoaway_autocomplete);
-    g_hash_table_insert(ac_funcs, "/theme",         _theme_autocomplete);
-    g_hash_table_insert(ac_funcs, "/log",           _log_autocomplete);
-    g_hash_table_insert(ac_funcs, "/account",       _account_autocomplete);
-    g_hash_table_insert(ac_funcs, "/roster",        _roster_autocomplete);
-    g_hash_table_insert(ac_funcs, "/group",         _group_autocomplete);
-    g_hash_table_insert(ac_funcs, "/bookmark",      _bookmark_autocomplete);
-    g_hash_table_insert(ac_funcs, "/autoconnect",   _autoconnect_autocomplete);
-    g_hash_table_insert(ac_funcs, "/otr",           _otr_autocomplete);
-    g_hash_table_insert(ac_funcs, "/connect",       _connect_autocomplete);
-    g_hash_table_insert(ac_funcs, "/statuses",      _statuses_autocomplete);
-    g_hash_table_insert(ac_funcs, "/alias",         _alias_autocomplete);
-    g_hash_table_insert(ac_funcs, "/join",          _join_autocomplete);
-    g_hash_table_insert(ac_funcs, "/form",          _form_autocomplete);
-    g_hash_table_insert(ac_funcs, "/occupants",     _occupants_autocomplete);
-    g_hash_table_insert(ac_funcs, "/kick",          _kick_autocomplete);
-    g_hash_table_insert(ac_funcs, "/ban",           _ban_autocomplete);
-    g_hash_table_insert(ac_funcs, "/affiliation",   _affiliation_autocomplete);
-    g_hash_table_insert(ac_funcs, "/role",          _role_autocomplete);
-    g_hash_table_insert(ac_funcs, "/resource",      _resource_autocomplete);
-    g_hash_table_insert(ac_funcs, "/titlebar",      _titlebar_autocomplete);
-    g_hash_table_insert(ac_funcs, "/inpblock",      _inpblock_autocomplete);
-
-    int len = strlen(input);
-    char parsed[len+1];
-    i = 0;
-    while (i < len) {
-        if (input[i] == ' ') {
-            break;
-        } else {
-            parsed[i] = input[i];
-        }
-        i++;
-    }
-    parsed[i] = '\0';
+        case COMPLETE_NICK:
+        case COMPLETE_CONTACT:
+        {
+            Autocomplete nick_ac = NULL;
+            if (rule->type == COMPLETE_NICK) {
+                if (wintype != WIN_MUC) {
+                    return NULL;
+                }
+                ProfMucWin *mucwin = wins_get_current_muc();
+                nick_ac = muc_roster_ac(mucwin->roomjid);
+                if (!nick_ac) {
+                    return NULL;
+                }
+            } else if (wintype == WIN_MUC) {
+                return NULL;
+            }
 
-    char * (*ac_func)(const char * const) = g_hash_table_lookup(ac_funcs, parsed);
-    if (ac_func != NULL) {
-        result = ac_func(input);
-        if (result) {
-            g_hash_table_destroy(ac_funcs);
-            return result;
+            // Remove quote character before and after names when doing autocomplete
+            if (!*unquoted) {
+                *unquoted = strip_arg_quotes(input);
+            }
+            const char *unquoted_arg = &(*unquoted)[len];
+            if (*unquoted_arg == '\0') {
+                return NULL;
+            }
+            if (nick_ac) {
+                return _complete_with(*unquoted, len, autocomplete_complete(nick_ac, unquoted_arg, TRUE));
+            } else {
+                return _complete_with(*unquoted, len, roster_contact_autocomplete(unquoted_arg));
+            }
         }
-    }
-    g_hash_table_destroy(ac_funcs);
 
-    if (g_str_has_prefix(input, "/field")) {
-        result = _form_field_autocomplete(input);
-        if (result) {
-            return result;
-        }
-    }
+        case COMPLETE_RESOURCE:
+            if (wintype == WIN_MUC) {
+                return NULL;
+            }
+            return _complete_with(input, len, roster_fulljid_autocomplete(arg));
 
-    return NULL;
+        default:
+            return NULL;
+    }
 }
 
 static char *
@@ -2438,7 +2511,13 @@ _theme_autocomplete(const char * const input)
 {
     char *result = NULL;
     if ((strncmp(input, "/theme set ", 11) == 0) && (strlen(input) > 11)) {
+        // list the themes again for each new completion
+        if (theme_load_ac != NULL && theme_load_generation != autocomplete_generation()) {
+            autocomplete_free(theme_load_ac);
+            theme_load_ac = NULL;
+        }
         if (theme_load_ac == NULL) {
+            theme_load_generation = autocomplete_generation();
             theme_load_ac = autocomplete_new();
             GSList *themes = theme_list();
             GSList *curr = themes;
@@ -2467,8 +2546,7 @@ _resource_autocomplete(const char * const input)
 {
     char *found = NULL;
 
-    ProfWin *current = wins_get_current();
-    if (current && current->type == WIN_CHAT) {
+    if (ui_current_win_type() == WIN_CHAT) {
         ProfChatWin *chatwin = wins_get_current_chat();
         PContact contact = roster_get_contact(chatwin->barejid);
         if (contact) {
@@ -2521,35 +2599,17 @@ _titlebar_autocomplete(const char * const input)
     return NULL;
 }
 
-static char *
-_inpblock_autocomplete(const char * const input)
-{
-    char *found = NULL;
-
-    found = autocomplete_param_with_func(input, "/inpblock dynamic", prefs_autocomplete_boolean_choice);
-    if (found != NULL) {
-        return found;
-    }
-
-    found = autocomplete_param_with_ac(input, "/inpblock", inpblock_ac, FALSE);
-    if (found != NULL) {
-        return found;
-    }
-
-    return NULL;
-}
 
 static char *
 _form_autocomplete(const char * const input)
 {
-    ProfWin *current = wins_get_current();
-    if (current->type != WIN_MUC_CONFIG) {
+    if (ui_current_win_type() != WIN_MUC_CONFIG) {
         return NULL;
     }
 
     char *found = NULL;
 
-    ProfMucConfWin *confwin = (ProfMucConfWin*)current;
+    ProfMucConfWin *confwin = wins_get_current_muc_conf();
     DataForm *form = confwin->form;
     if (form) {
         found = autocomplete_param_with_ac(input, "/form help", form->tag_ac, TRUE);
@@ -2569,14 +2629,13 @@ _form_autocomplete(const char * const input)
 static char *
 _form_field_autocomplete(const char * const input)
 {
-    ProfWin *current = wins_get_current();
-    if (current->type != WIN_MUC_CONFIG) {
+    if (ui_current_win_type() != WIN_MUC_CONFIG) {
         return NULL;
     }
 
     char *found = NULL;
 
-    ProfMucConfWin *confwin = (ProfMucConfWin*)current;
+    ProfMucConfWin *confwin = wins_get_current_muc_conf();
     DataForm *form = confwin->form;
     if (form == NULL) {
         return NULL;
@@ -37,14 +37,23 @@
 
 #include <glib.h>
 
+#include "command/commands.h"
 #include "xmpp/form.h"
 
-GHashTable *commands;
-
 void cmd_init(void);
 void cmd_uninit(void);
 
+// the command named cmd, including its leading '/', NULL if there is none
+Command * cmd_get(const char * const cmd);
+
+// every command in no particular order, their number stored in count
+Command * cmd_get_all(int *count);
+
 char* cmd_autocomplete(const char * const input);
+
+// length of the command and space at the start of input that have
+// completion rules, 0 when there are none
+int cmd_completion_lookup(const char * const input);
 void cmd_reset_autocomplete(void);
 void cmd_autocomplete_add(char *value);
 void cmd_autocomplete_remove(char *value);
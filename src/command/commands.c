@@ -67,6 +67,7 @@
 #include "xmpp/bookmark.h"
 #include "ui/ui.h"
 #include "ui/windows.h"
+#include "ui/frame.h"
 
 static void _update_presence(const resource_presence_t presence,
     const char * const show, gchar **args);
@@ -78,8 +79,6 @@ static gint _compare_commands(Command *a, Command *b);
 static void _who_room(gchar **args, struct cmd_help_t help);
 static void _who_roster(gchar **args, struct cmd_help_t help);
 
-extern GHashTable *commands;
-
 gboolean
 cmd_connect(gchar **args, struct cmd_help_t help)
 {
@@ -616,6 +615,20 @@ cmd_quit(gchar **args, struct cmd_help_t help)
     return FALSE;
 }
 
+gboolean
+cmd_stats(gchar **args, struct cmd_help_t help)
+{
+    cons_show_stats();
+    return TRUE;
+}
+
+gboolean
+cmd_timers(gchar **args, struct cmd_help_t help)
+{
+    cons_show_timers();
+    return TRUE;
+}
+
 gboolean
 cmd_wins(gchar **args, struct cmd_help_t help)
 {
@@ -674,13 +687,11 @@ cmd_help(gchar **args, struct cmd_help_t help)
         cons_show("");
 
         GList *ordered_commands = NULL;
-        GHashTableIter iter;
-        gpointer key;
-        gpointer value;
-
-        g_hash_table_iter_init(&iter, commands);
-        while (g_hash_table_iter_next(&iter, &key, &value)) {
-            ordered_commands = g_list_insert_sorted(ordered_commands, value, (GCompareFunc)_compare_commands);
+        int count = 0;
+        Command *all = cmd_get_all(&count);
+        int i;
+        for (i = 0; i < count; i++) {
+            ordered_commands = g_list_insert_sorted(ordered_commands, &all[i], (GCompareFunc)_compare_commands);
         }
 
         GList *curr = ordered_commands;
@@ -733,7 +744,8 @@ cmd_help(gchar **args, struct cmd_help_t help)
             "/chlog", "/flash", "/gone", "/grlog", "/history", "/intype",
             "/log", "/mouse", "/notify", "/outtype", "/prefs", "/priority",
             "/reconnect", "/roster", "/splash", "/states", "/statuses", "/theme",
-            "/titlebar", "/vercheck", "/privileges", "/occupants", "/presence", "/wrap" };
+            "/titlebar", "/vercheck", "/privileges", "/occupants", "/presence", "/wrap",
+            "/fuzzy", "/framerate" };
         _cmd_show_filtered_help("Settings commands", filter, ARRAY_SIZE(filter));
 
     } else if (strcmp(args[0], "navigation") == 0) {
@@ -744,7 +756,7 @@ cmd_help(gchar **args, struct cmd_help_t help)
         sprintf(cmd_with_slash, "/%s", cmd);
 
         const gchar **help_text = NULL;
-        Command *command = g_hash_table_lookup(commands, cmd_with_slash);
+        Command *command = cmd_get(cmd_with_slash);
 
         if (command != NULL) {
             help_text = command->help.long_help;
@@ -1272,13 +1284,12 @@ cmd_msg(gchar **args, struct cmd_help_t help)
                     if (((win_type == WIN_CHAT) || (win_type == WIN_CONSOLE)) && prefs_get_boolean(PREF_CHLOG)) {
                         const char *jid = jabber_get_fulljid();
                         Jid *jidp = jid_create(jid);
-                        char *pref_otr_log = prefs_get_string(PREF_OTR_LOG);
+                        const char *pref_otr_log = prefs_peek_string(PREF_OTR_LOG);
                         if (strcmp(pref_otr_log, "on") == 0) {
                             chat_log_chat(jidp->barejid, barejid, msg, PROF_OUT_LOG, NULL);
                         } else if (strcmp(pref_otr_log, "redact") == 0) {
                             chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_OUT_LOG, NULL);
                         }
-                        prefs_free_string(pref_otr_log);
                         jid_destroy(jidp);
                     }
                 } else {
@@ -1682,14 +1693,14 @@ cmd_resource(gchar **args, struct cmd_help_t help)
 
         chatwin->resource_override = strdup(resource);
         chat_state_free(chatwin->state);
-        chatwin->state = chat_state_new();
+        chatwin->state = chat_state_new(chatwin->barejid);
         chat_session_resource_override(chatwin->barejid, resource);
         return TRUE;
 
     } else if (g_strcmp0(cmd, "off") == 0) {
         FREE_SET_NULL(chatwin->resource_override);
         chat_state_free(chatwin->state);
-        chatwin->state = chat_state_new();
+        chatwin->state = chat_state_new(chatwin->barejid);
         chat_session_remove(chatwin->barejid);
         return TRUE;
     } else {
@@ -2387,7 +2398,7 @@ cmd_form(gchar **args, struct cmd_help_t help)
             ui_show_form_help(confwin);
 
             const gchar **help_text = NULL;
-            Command *command = g_hash_table_lookup(commands, "/form");
+            Command *command = cmd_get("/form");
 
             if (command != NULL) {
                 help_text = command->help.long_help;
@@ -3078,13 +3089,12 @@ cmd_tiny(gchar **args, struct cmd_help_t help)
                         if (prefs_get_boolean(PREF_CHLOG)) {
                             const char *jid = jabber_get_fulljid();
                             Jid *jidp = jid_create(jid);
-                            char *pref_otr_log = prefs_get_string(PREF_OTR_LOG);
+                            const char *pref_otr_log = prefs_peek_string(PREF_OTR_LOG);
                             if (strcmp(pref_otr_log, "on") == 0) {
                                 chat_log_chat(jidp->barejid, chatwin->barejid, tiny, PROF_OUT_LOG, NULL);
                             } else if (strcmp(pref_otr_log, "redact") == 0) {
                                 chat_log_chat(jidp->barejid, chatwin->barejid, "[redacted]", PROF_OUT_LOG, NULL);
                             }
-                            prefs_free_string(pref_otr_log);
                             jid_destroy(jidp);
                         }
 
@@ -3267,6 +3277,16 @@ cmd_wrap(gchar **args, struct cmd_help_t help)
     return result;
 }
 
+gboolean
+cmd_fuzzy(gchar **args, struct cmd_help_t help)
+{
+    gboolean result = _cmd_set_boolean_preference(args[0], help, "Fuzzy completion", PREF_FUZZY);
+
+    autocomplete_set_fuzzy(prefs_get_boolean(PREF_FUZZY));
+
+    return result;
+}
+
 gboolean
 cmd_time(gchar **args, struct cmd_help_t help)
 {
@@ -3323,6 +3343,27 @@ cmd_titlebar(gchar **args, struct cmd_help_t help)
     }
 }
 
+gboolean
+cmd_framerate(gchar **args, struct cmd_help_t help)
+{
+    char *value = args[0];
+    int intval;
+
+    if (_strtoi(value, &intval, 0, 1000) == 0) {
+        prefs_set_frame_rate(intval);
+        frame_set_rate(intval);
+        if (intval == 0) {
+            cons_show("Frame rate limit disabled.");
+        } else {
+            cons_show("Frame rate limit set to %d frames per second.", intval);
+        }
+    } else {
+        cons_show("Usage: %s", help.usage);
+    }
+
+    return TRUE;
+}
+
 gboolean
 cmd_outtype(gchar **args, struct cmd_help_t help)
 {
@@ -3489,6 +3530,7 @@ cmd_notify(gchar **args, struct cmd_help_t help)
     } else if (strcmp(kind, "remind") == 0) {
         gint period = atoi(args[1]);
         prefs_set_notify_remind(period);
+        notify_remind_reset();
         if (period == 0) {
             cons_show("Message reminders disabled.");
         } else if (period == 1) {
@@ -3504,47 +3546,6 @@ cmd_notify(gchar **args, struct cmd_help_t help)
     return TRUE;
 }
 
-gboolean
-cmd_inpblock(gchar **args, struct cmd_help_t help)
-{
-    char *subcmd = args[0];
-    char *value = args[1];
-    int intval;
-
-    if (g_strcmp0(subcmd, "timeout") == 0) {
-        if (value == NULL) {
-            cons_show("Usage: %s", help.usage);
-            return TRUE;
-        }
-
-        if (_strtoi(value, &intval, 1, 1000) == 0) {
-            cons_show("Input blocking set to %d milliseconds.", intval);
-            prefs_set_inpblock(intval);
-            ui_input_nonblocking(FALSE);
-        }
-
-        return TRUE;
-    }
-
-    if (g_strcmp0(subcmd, "dynamic") == 0) {
-        if (value == NULL) {
-            cons_show("Usage: %s", help.usage);
-            return TRUE;
-        }
-
-        if (g_strcmp0(value, "on") != 0 && g_strcmp0(value, "off") != 0) {
-            cons_show("Dynamic must be one of 'on' or 'off'");
-            return TRUE;
-        }
-
-        return _cmd_set_boolean_preference(value, help, "Dynamic input blocking", PREF_INPBLOCK_DYNAMIC);
-    }
-
-    cons_show("Usage: %s", help.usage);
-
-    return TRUE;
-}
-
 gboolean
 cmd_log(gchar **args, struct cmd_help_t help)
 {
@@ -4272,7 +4273,7 @@ _cmd_show_filtered_help(char *heading, gchar *cmd_filter[], int filter_size)
     GList *ordered_commands = NULL;
     int i;
     for (i = 0; i < filter_size; i++) {
-        Command *cmd = g_hash_table_lookup(commands, cmd_filter[i]);
+        Command *cmd = cmd_get(cmd_filter[i]);
         ordered_commands = g_list_insert_sorted(ordered_commands, cmd, (GCompareFunc)_compare_commands);
     }
 
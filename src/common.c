@@ -202,28 +202,6 @@ str_contains(const char str[], int size, char ch)
     return 0;
 }
 
-int
-utf8_display_len(const char * const str)
-{
-    if (!str) {
-        return 0;
-    }
-
-    int len = 0;
-    gchar *curr = g_utf8_offset_to_pointer(str, 0);
-    while (*curr != '\0') {
-        gunichar curru = g_utf8_get_char(curr);
-        if (g_unichar_iswide(curru)) {
-            len += 2;
-        } else {
-            len ++;
-        }
-        curr = g_utf8_next_char(curr);
-    }
-
-    return len;
-}
-
 char *
 prof_getline(FILE *stream)
 {
@@ -485,6 +463,26 @@ cmp_win_num(gconstpointer a, gconstpointer b)
     }
 }
 
+int
+win_num_to_order(int num)
+{
+    if (num == 0) {
+        return 10;
+    } else {
+        return num;
+    }
+}
+
+int
+win_order_to_num(int order)
+{
+    if (order == 10) {
+        return 0;
+    } else {
+        return order;
+    }
+}
+
 int
 get_next_available_win_num(GList *used)
 {
@@ -104,7 +104,6 @@ gboolean mkdir_recursive(const char *dir);
 char * str_replace(const char *string, const char *substr,
     const char *replacement);
 int str_contains(const char str[], int size, char ch);
-int utf8_display_len(const char * const str);
 char * prof_getline(FILE *stream);
 char* release_get_latest(void);
 gboolean release_is_new(char *found_version);
@@ -122,6 +121,11 @@ char * create_unique_id(char *prefix);
 int cmp_win_num(gconstpointer a, gconstpointer b);
 int get_next_available_win_num(GList *used);
 
+// window 0 is shown after window 9, these map window numbers to and
+// from their place in that order
+int win_num_to_order(int num);
+int win_order_to_num(int order);
+
 char* get_file_or_linked(char *loc, char *basedir);
 char * strip_arg_quotes(const char * const input);
 
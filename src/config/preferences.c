@@ -62,12 +62,31 @@
 #define PREF_GROUP_ALIAS "alias"
 #define PREF_GROUP_OTR "otr"
 
-#define INPBLOCK_DEFAULT 1000
-
 static gchar *prefs_loc;
 static GKeyFile *prefs;
 gint log_maxsize = 0;
 
+// values of all preferences, kept in step with the key file so that reading
+// a preference does not need a key file lookup
+typedef struct pref_value_t {
+    gboolean boolean;
+    char *string;
+} PrefValue;
+
+static PrefValue pref_values[PREF_COUNT];
+
+static struct {
+    gint gone;
+    gint notify_remind;
+    gint priority;
+    gint reconnect;
+    gint autoping;
+    gint autoaway_time;
+    gint occupants_size;
+    gint roster_size;
+    gint frame_rate;
+} int_prefs;
+
 static Autocomplete boolean_choice_ac;
 
 static void _save_prefs(void);
@@ -76,6 +95,9 @@ static const char * _get_group(preference_t pref);
 static const char * _get_key(preference_t pref);
 static gboolean _get_default_boolean(preference_t pref);
 static char * _get_default_string(preference_t pref);
+static void _update_pref_value(preference_t pref);
+static void _update_pref_values(void);
+static void _update_int_prefs(void);
 
 void
 prefs_load(void)
@@ -139,6 +161,7 @@ prefs_load(void)
     }
 
     _save_prefs();
+    _update_pref_values();
 
     boolean_choice_ac = autocomplete_new();
     autocomplete_add(boolean_choice_ac, "on");
@@ -151,6 +174,11 @@ prefs_close(void)
     autocomplete_free(boolean_choice_ac);
     g_key_file_free(prefs);
     prefs = NULL;
+
+    int i;
+    for (i = 0; i < PREF_COUNT; i++) {
+        FREE_SET_NULL(pref_values[i].string);
+    }
 }
 
 char *
@@ -168,15 +196,7 @@ prefs_reset_boolean_choice(void)
 gboolean
 prefs_get_boolean(preference_t pref)
 {
-    const char *group = _get_group(pref);
-    const char *key = _get_key(pref);
-    gboolean def = _get_default_boolean(pref);
-
-    if (!g_key_file_has_key(prefs, group, key, NULL)) {
-        return def;
-    }
-
-    return g_key_file_get_boolean(prefs, group, key, NULL);
+    return pref_values[pref].boolean;
 }
 
 void
@@ -185,29 +205,31 @@ prefs_set_boolean(preference_t pref, gboolean value)
     const char *group = _get_group(pref);
     const char *key = _get_key(pref);
     g_key_file_set_boolean(prefs, group, key, value);
+    _update_pref_value(pref);
     _save_prefs();
 }
 
+// returns a copy of the preference value that the caller must free
 char *
 prefs_get_string(preference_t pref)
 {
-    const char *group = _get_group(pref);
-    const char *key = _get_key(pref);
-    char *def = _get_default_string(pref);
+    const char *value = pref_values[pref].string;
 
-    char *result = g_key_file_get_string(prefs, group, key, NULL);
-
-    if (result == NULL) {
-        if (def != NULL) {
-            return strdup(def);
-        } else {
-            return NULL;
-        }
+    if (value == NULL) {
+        return NULL;
     } else {
-        return result;
+        return strdup(value);
     }
 }
 
+// returns the preference value owned by preferences, it is valid until the
+// preference is next set
+const char *
+prefs_peek_string(preference_t pref)
+{
+    return pref_values[pref].string;
+}
+
 void
 prefs_free_string(char *pref)
 {
@@ -228,32 +250,35 @@ prefs_set_string(preference_t pref, char *value)
     } else {
         g_key_file_set_string(prefs, group, key, value);
     }
+    _update_pref_value(pref);
     _save_prefs();
 }
 
 gint
 prefs_get_gone(void)
 {
-    return g_key_file_get_integer(prefs, PREF_GROUP_CHATSTATES, "gone", NULL);
+    return int_prefs.gone;
 }
 
 void
 prefs_set_gone(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_CHATSTATES, "gone", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
 gint
 prefs_get_notify_remind(void)
 {
-    return g_key_file_get_integer(prefs, PREF_GROUP_NOTIFICATIONS, "remind", NULL);
+    return int_prefs.notify_remind;
 }
 
 void
 prefs_set_notify_remind(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_NOTIFICATIONS, "remind", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
@@ -274,74 +299,51 @@ prefs_set_max_log_size(gint value)
     _save_prefs();
 }
 
-gint prefs_get_inpblock(void)
-{
-    int val = g_key_file_get_integer(prefs, PREF_GROUP_UI, "inpblock", NULL);
-    if (val == 0) {
-        return INPBLOCK_DEFAULT;
-    } else {
-        return val;
-    }
-}
-
-void prefs_set_inpblock(gint value)
-{
-    g_key_file_set_integer(prefs, PREF_GROUP_UI, "inpblock", value);
-    _save_prefs();
-}
-
 gint
 prefs_get_priority(void)
 {
-    return g_key_file_get_integer(prefs, PREF_GROUP_PRESENCE, "priority", NULL);
+    return int_prefs.priority;
 }
 
 gint
 prefs_get_reconnect(void)
 {
-    if (!g_key_file_has_key(prefs, PREF_GROUP_CONNECTION, "reconnect", NULL)) {
-        return 30;
-    } else {
-        return g_key_file_get_integer(prefs, PREF_GROUP_CONNECTION, "reconnect", NULL);
-    }
+    return int_prefs.reconnect;
 }
 
 void
 prefs_set_reconnect(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_CONNECTION, "reconnect", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
 gint
 prefs_get_autoping(void)
 {
-    return g_key_file_get_integer(prefs, PREF_GROUP_CONNECTION, "autoping", NULL);
+    return int_prefs.autoping;
 }
 
 void
 prefs_set_autoping(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_CONNECTION, "autoping", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
 gint
 prefs_get_autoaway_time(void)
 {
-    gint result = g_key_file_get_integer(prefs, PREF_GROUP_PRESENCE, "autoaway.time", NULL);
-
-    if (result == 0) {
-        return 15;
-    } else {
-        return result;
-    }
+    return int_prefs.autoaway_time;
 }
 
 void
 prefs_set_autoaway_time(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_PRESENCE, "autoaway.time", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
@@ -349,38 +351,42 @@ void
 prefs_set_occupants_size(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_UI, "occupants.size", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
 gint
 prefs_get_occupants_size(void)
 {
-    gint result = g_key_file_get_integer(prefs, PREF_GROUP_UI, "occupants.size", NULL);
-
-    if (result > 99 || result < 1) {
-        return 20;
-    } else {
-        return result;
-    }
+    return int_prefs.occupants_size;
 }
 
 void
 prefs_set_roster_size(gint value)
 {
     g_key_file_set_integer(prefs, PREF_GROUP_UI, "roster.size", value);
+    _update_int_prefs();
     _save_prefs();
 }
 
 gint
 prefs_get_roster_size(void)
 {
-    gint result = g_key_file_get_integer(prefs, PREF_GROUP_UI, "roster.size", NULL);
+    return int_prefs.roster_size;
+}
 
-    if (result > 99 || result < 1) {
-        return 20;
-    } else {
-        return result;
-    }
+void
+prefs_set_frame_rate(gint value)
+{
+    g_key_file_set_integer(prefs, PREF_GROUP_UI, "frame.rate", value);
+    _update_int_prefs();
+    _save_prefs();
+}
+
+gint
+prefs_get_frame_rate(void)
+{
+    return int_prefs.frame_rate;
 }
 
 gboolean
@@ -468,6 +474,84 @@ prefs_free_aliases(GList *aliases)
     g_list_free_full(aliases, (GDestroyNotify)_free_alias);
 }
 
+static void
+_update_pref_value(preference_t pref)
+{
+    const char *group = _get_group(pref);
+    const char *key = _get_key(pref);
+
+    // integer prefs are read by _update_int_prefs
+    if (group == NULL || key == NULL) {
+        return;
+    }
+
+    if (g_key_file_has_key(prefs, group, key, NULL)) {
+        pref_values[pref].boolean = g_key_file_get_boolean(prefs, group, key, NULL);
+    } else {
+        pref_values[pref].boolean = _get_default_boolean(pref);
+    }
+
+    free(pref_values[pref].string);
+    char *def = _get_default_string(pref);
+    char *result = g_key_file_get_string(prefs, group, key, NULL);
+    if (result == NULL && def != NULL) {
+        pref_values[pref].string = strdup(def);
+    } else {
+        pref_values[pref].string = result;
+    }
+}
+
+static gint
+_get_int_in_range(const char * const group, const char * const key, gint def)
+{
+    gint result = g_key_file_get_integer(prefs, group, key, NULL);
+
+    if (result > 99 || result < 1) {
+        return def;
+    } else {
+        return result;
+    }
+}
+
+static void
+_update_int_prefs(void)
+{
+    int_prefs.gone = g_key_file_get_integer(prefs, PREF_GROUP_CHATSTATES, "gone", NULL);
+    int_prefs.notify_remind = g_key_file_get_integer(prefs, PREF_GROUP_NOTIFICATIONS, "remind", NULL);
+    int_prefs.priority = g_key_file_get_integer(prefs, PREF_GROUP_PRESENCE, "priority", NULL);
+    int_prefs.autoping = g_key_file_get_integer(prefs, PREF_GROUP_CONNECTION, "autoping", NULL);
+
+    if (!g_key_file_has_key(prefs, PREF_GROUP_CONNECTION, "reconnect", NULL)) {
+        int_prefs.reconnect = 30;
+    } else {
+        int_prefs.reconnect = g_key_file_get_integer(prefs, PREF_GROUP_CONNECTION, "reconnect", NULL);
+    }
+
+    int_prefs.autoaway_time = g_key_file_get_integer(prefs, PREF_GROUP_PRESENCE, "autoaway.time", NULL);
+    if (int_prefs.autoaway_time == 0) {
+        int_prefs.autoaway_time = 15;
+    }
+
+    int_prefs.occupants_size = _get_int_in_range(PREF_GROUP_UI, "occupants.size", 20);
+    int_prefs.roster_size = _get_int_in_range(PREF_GROUP_UI, "roster.size", 20);
+
+    if (!g_key_file_has_key(prefs, PREF_GROUP_UI, "frame.rate", NULL)) {
+        int_prefs.frame_rate = 60;
+    } else {
+        int_prefs.frame_rate = g_key_file_get_integer(prefs, PREF_GROUP_UI, "frame.rate", NULL);
+    }
+}
+
+static void
+_update_pref_values(void)
+{
+    int i;
+    for (i = 0; i < PREF_COUNT; i++) {
+        _update_pref_value(i);
+    }
+    _update_int_prefs();
+}
+
 static void
 _save_prefs(void)
 {
@@ -524,6 +608,7 @@ _get_group(preference_t pref)
         case PREF_MUC_PRIVILEGES:
         case PREF_PRESENCE:
         case PREF_WRAP:
+        case PREF_FUZZY:
         case PREF_TIME:
         case PREF_ROSTER:
         case PREF_ROSTER_OFFLINE:
@@ -531,7 +616,6 @@ _get_group(preference_t pref)
         case PREF_ROSTER_BY:
         case PREF_RESOURCE_TITLE:
         case PREF_RESOURCE_MESSAGE:
-        case PREF_INPBLOCK_DYNAMIC:
             return PREF_GROUP_UI;
         case PREF_STATES:
         case PREF_OUTTYPE:
@@ -659,6 +743,8 @@ _get_key(preference_t pref)
             return "presence";
         case PREF_WRAP:
             return "wrap";
+        case PREF_FUZZY:
+            return "fuzzy";
         case PREF_TIME:
             return "time";
         case PREF_ROSTER:
@@ -673,8 +759,6 @@ _get_key(preference_t pref)
             return "resource.title";
         case PREF_RESOURCE_MESSAGE:
             return "resource.message";
-        case PREF_INPBLOCK_DYNAMIC:
-            return "inpblock.dynamic";
         default:
             return NULL;
     }
@@ -699,7 +783,6 @@ _get_default_boolean(preference_t pref)
         case PREF_MUC_PRIVILEGES:
         case PREF_PRESENCE:
         case PREF_WRAP:
-        case PREF_INPBLOCK_DYNAMIC:
             return TRUE;
         default:
             return FALSE;
@@ -70,6 +70,7 @@ typedef enum {
     PREF_MUC_PRIVILEGES,
     PREF_PRESENCE,
     PREF_WRAP,
+    PREF_FUZZY,
     PREF_TIME,
     PREF_STATUSES,
     PREF_STATUSES_CONSOLE,
@@ -101,7 +102,7 @@ typedef enum {
     PREF_OTR_POLICY,
     PREF_RESOURCE_TITLE,
     PREF_RESOURCE_MESSAGE,
-    PREF_INPBLOCK_DYNAMIC
+    PREF_COUNT
 } preference_t;
 
 typedef struct prof_alias_t {
@@ -130,13 +131,13 @@ void prefs_set_reconnect(gint value);
 gint prefs_get_reconnect(void);
 void prefs_set_autoping(gint value);
 gint prefs_get_autoping(void);
-gint prefs_get_inpblock(void);
-void prefs_set_inpblock(gint value);
 
 void prefs_set_occupants_size(gint value);
 gint prefs_get_occupants_size(void);
 void prefs_set_roster_size(gint value);
 gint prefs_get_roster_size(void);
+void prefs_set_frame_rate(gint value);
+gint prefs_get_frame_rate(void);
 
 gint prefs_get_autoaway_time(void);
 void prefs_set_autoaway_time(gint value);
@@ -152,6 +153,7 @@ void prefs_free_aliases(GList *aliases);
 gboolean prefs_get_boolean(preference_t pref);
 void prefs_set_boolean(preference_t pref, gboolean value);
 char * prefs_get_string(preference_t pref);
+const char * prefs_peek_string(preference_t pref);
 void prefs_free_string(char *pref);
 void prefs_set_string(preference_t pref, char *value);
 
@@ -42,10 +42,11 @@
 #include "common.h"
 #include "resource.h"
 #include "tools/autocomplete.h"
+#include "tools/intern.h"
 
 struct p_contact_t {
-    char *barejid;
-    char *name;
+    const char *barejid;
+    const char *name;
     GSList *groups;
     char *subscription;
     char *offline_message;
@@ -61,13 +62,8 @@ p_contact_new(const char * const barejid, const char * const name,
     const char * const offline_message, gboolean pending_out)
 {
     PContact contact = malloc(sizeof(struct p_contact_t));
-    contact->barejid = strdup(barejid);
-
-    if (name != NULL) {
-        contact->name = strdup(name);
-    } else {
-        contact->name = NULL;
-    }
+    contact->barejid = intern_ref(barejid);
+    contact->name = intern_ref(name);
 
     contact->groups = groups;
 
@@ -84,7 +80,7 @@ p_contact_new(const char * const barejid, const char * const name,
     contact->pending_out = pending_out;
     contact->last_activity = NULL;
 
-    contact->available_resources = g_hash_table_new_full(g_str_hash, g_str_equal, free,
+    contact->available_resources = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
         (GDestroyNotify)resource_destroy);
 
     contact->resource_ac = autocomplete_new();
@@ -95,10 +91,9 @@ p_contact_new(const char * const barejid, const char * const name,
 void
 p_contact_set_name(const PContact contact, const char * const name)
 {
-    FREE_SET_NULL(contact->name);
-    if (name != NULL) {
-        contact->name = strdup(name);
-    }
+    const char *old_name = contact->name;
+    contact->name = intern_ref(name);
+    intern_unref(old_name);
 }
 
 void
@@ -145,8 +140,8 @@ void
 p_contact_free(PContact contact)
 {
     if (contact != NULL) {
-        free(contact->barejid);
-        free(contact->name);
+        intern_unref(contact->barejid);
+        intern_unref(contact->name);
         free(contact->subscription);
         free(contact->offline_message);
 
@@ -380,7 +375,7 @@ p_contact_has_available_resource(const PContact contact)
 void
 p_contact_set_presence(const PContact contact, Resource *resource)
 {
-    g_hash_table_replace(contact->available_resources, strdup(resource->name), resource);
+    g_hash_table_replace(contact->available_resources, (gpointer)resource->name, resource);
     autocomplete_add(contact->resource_ac, resource->name);
 }
 
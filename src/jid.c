@@ -189,4 +189,93 @@ jid_fulljid_or_barejid(Jid *jid)
     } else {
         return jid->barejid;
     }
-}
\ No newline at end of file
+}
+/*
+ * Parse str into view without allocating, accepts the same jids as
+ * jid_create, returns FALSE for anything jid_create would reject or
+ * for jids longer than JID_MAX_LEN
+ */
+gboolean
+jid_view_parse(JidView *view, const char * const str)
+{
+    if (str == NULL || str[0] == '\0' || str[0] == '/' || str[0] == '@') {
+        return FALSE;
+    }
+
+    // '@' and '/' never occur inside a multibyte utf8 sequence
+    // so a plain byte scan finds the same separators as g_utf8_strchr
+    const char *slashp = strchr(str, '/');
+    size_t bare_len = slashp != NULL ? (size_t)(slashp - str) : strlen(str);
+    size_t len = slashp != NULL ? bare_len + 1 + strlen(slashp + 1) : bare_len;
+    if (len > JID_MAX_LEN) {
+        return FALSE;
+    }
+
+    if (!g_utf8_validate(str, len, NULL)) {
+        return FALSE;
+    }
+
+    const char *atp = memchr(str, '@', bare_len);
+
+    view->str = str;
+    view->local_len = atp != NULL ? atp - str : 0;
+    view->domain_start = atp != NULL ? view->local_len + 1 : 0;
+    view->domain_len = bare_len - view->domain_start;
+    view->bare_len = bare_len;
+    memcpy(view->barejid, str, bare_len);
+    view->barejid[bare_len] = '\0';
+
+    if (slashp != NULL) {
+        view->fulljid = (char *)str;
+        view->resourcepart = (char *)slashp + 1;
+    } else {
+        view->fulljid = NULL;
+        view->resourcepart = NULL;
+    }
+
+    return TRUE;
+}
+
+gboolean
+jid_view_has_localpart(const JidView * const view)
+{
+    return view->local_len > 0;
+}
+
+gboolean
+jid_view_bare_equals(const JidView * const view, const char * const barejid)
+{
+    return barejid != NULL && g_strcmp0(view->barejid, barejid) == 0;
+}
+
+static gboolean
+_part_equals(const char * const part, int len, const char * const str)
+{
+    return str != NULL && strncmp(part, str, len) == 0 && str[len] == '\0';
+}
+
+gboolean
+jid_view_localpart_equals(const JidView * const view, const char * const localpart)
+{
+    if (view->local_len == 0) {
+        return localpart == NULL;
+    }
+
+    return _part_equals(view->str, view->local_len, localpart);
+}
+
+gboolean
+jid_view_domainpart_equals(const JidView * const view, const char * const domainpart)
+{
+    return _part_equals(view->str + view->domain_start, view->domain_len, domainpart);
+}
+
+char *
+jid_view_fulljid_or_barejid(JidView *view)
+{
+    if (view->fulljid) {
+        return view->fulljid;
+    } else {
+        return view->barejid;
+    }
+}
@@ -48,6 +48,23 @@ struct jid_t {
 
 typedef struct jid_t Jid;
 
+// longest jid accepted by jid_view_parse, three parts of up to 1023 bytes
+#define JID_MAX_LEN 3071
+
+// a jid parsed in place, the parts point into the parsed string which must
+// outlive the view, only the barejid is copied so it can be used as a key,
+// parts are not const so views can be handed on like a Jid
+typedef struct jid_view_t {
+    const char *str;
+    char *fulljid;              // str when there is a resource, else NULL
+    char *resourcepart;         // NULL when there is no resource
+    int local_len;              // 0 when there is no localpart
+    int domain_start;
+    int domain_len;
+    int bare_len;
+    char barejid[JID_MAX_LEN + 1];
+} JidView;
+
 Jid * jid_create(const gchar * const str);
 Jid * jid_create_from_bare_and_resource(const char * const room, const char * const nick);
 void jid_destroy(Jid *jid);
@@ -58,4 +75,11 @@ char * get_nick_from_full_jid(const char * const full_room_jid);
 
 char * jid_fulljid_or_barejid(Jid *jid);
 
+gboolean jid_view_parse(JidView *view, const char * const str);
+gboolean jid_view_has_localpart(const JidView * const view);
+gboolean jid_view_bare_equals(const JidView * const view, const char * const barejid);
+gboolean jid_view_localpart_equals(const JidView * const view, const char * const localpart);
+gboolean jid_view_domainpart_equals(const JidView * const view, const char * const domainpart);
+char * jid_view_fulljid_or_barejid(JidView *view);
+
 #endif
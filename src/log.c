@@ -46,6 +46,7 @@
 
 #include "common.h"
 #include "config/preferences.h"
+#include "tools/intern.h"
 
 #define PROF "prof"
 
@@ -67,7 +68,7 @@ struct dated_chat_log {
 
 static gboolean _log_roll_needed(struct dated_chat_log *dated_log);
 static struct dated_chat_log * _create_log(char *other, const  char * const login);
-static struct dated_chat_log * _create_groupchat_log(char *room, const char * const login);
+static struct dated_chat_log * _create_groupchat_log(const char * const room, const char * const login);
 static void _free_chat_log(struct dated_chat_log *dated_log);
 static gboolean _key_equals(void *key1, void *key2);
 static char * _get_log_filename(const char * const other, const char * const login,
@@ -236,7 +237,7 @@ chat_log_init(void)
 {
     session_started = g_date_time_new_now_local();
     log_info("Initialising chat logs");
-    logs = g_hash_table_new_full(g_str_hash, (GEqualFunc) _key_equals, free,
+    logs = g_hash_table_new_full(g_str_hash, (GEqualFunc) _key_equals, (GDestroyNotify)intern_unref,
         (GDestroyNotify)_free_chat_log);
 }
 
@@ -244,7 +245,7 @@ void
 groupchat_log_init(void)
 {
     log_info("Initialising groupchat logs");
-    groupchat_logs = g_hash_table_new_full(g_str_hash, (GEqualFunc) _key_equals, free,
+    groupchat_logs = g_hash_table_new_full(g_str_hash, (GEqualFunc) _key_equals, (GDestroyNotify)intern_unref,
         (GDestroyNotify)_free_chat_log);
 }
 
@@ -257,12 +258,12 @@ chat_log_chat(const gchar * const login, gchar *other,
     // no log for user
     if (dated_log == NULL) {
         dated_log = _create_log(other, login);
-        g_hash_table_insert(logs, strdup(other), dated_log);
+        g_hash_table_insert(logs, (gpointer)intern_ref(other), dated_log);
 
     // log exists but needs rolling
     } else if (_log_roll_needed(dated_log)) {
         dated_log = _create_log(other, login);
-        g_hash_table_replace(logs, strdup(other), dated_log);
+        g_hash_table_replace(logs, (gpointer)intern_ref(other), dated_log);
     }
 
     gchar *date_fmt = NULL;
@@ -306,18 +307,17 @@ void
 groupchat_log_chat(const gchar * const login, const gchar * const room,
     const gchar * const nick, const gchar * const msg)
 {
-    gchar *room_copy = strdup(room);
-    struct dated_chat_log *dated_log = g_hash_table_lookup(groupchat_logs, room_copy);
+    struct dated_chat_log *dated_log = g_hash_table_lookup(groupchat_logs, room);
 
     // no log for room
     if (dated_log == NULL) {
-        dated_log = _create_groupchat_log(room_copy, login);
-        g_hash_table_insert(groupchat_logs, room_copy, dated_log);
+        dated_log = _create_groupchat_log(room, login);
+        g_hash_table_insert(groupchat_logs, (gpointer)intern_ref(room), dated_log);
 
     // log exists but needs rolling
     } else if (_log_roll_needed(dated_log)) {
-        dated_log = _create_groupchat_log(room_copy, login);
-        g_hash_table_replace(logs, room_copy, dated_log);
+        dated_log = _create_groupchat_log(room, login);
+        g_hash_table_replace(groupchat_logs, (gpointer)intern_ref(room), dated_log);
     }
 
     GDateTime *dt = g_date_time_new_now_local();
@@ -417,7 +417,7 @@ _create_log(char *other, const char * const login)
 }
 
 static struct dated_chat_log *
-_create_groupchat_log(char *room, const char * const login)
+_create_groupchat_log(const char * const room, const char * const login)
 {
     GDateTime *now = g_date_time_new_now_local();
     char *filename = _get_groupchat_log_filename(room, login, now, TRUE);
@@ -41,6 +41,7 @@
 #include "common.h"
 #include "jid.h"
 #include "tools/autocomplete.h"
+#include "tools/intern.h"
 #include "ui/ui.h"
 #include "ui/windows.h"
 #include "muc.h"
@@ -53,10 +54,13 @@ typedef struct _muc_room_t {
     char *password;
     char *subject;
     char *autocomplete_prefix;
+    // autocomplete generation the prefix was taken in
+    guint prefix_generation;
     gboolean pending_config;
     GList *pending_broadcasts;
     gboolean autojoin;
     gboolean pending_nick_change;
+    // occupants keyed on their interned nick
     GHashTable *roster;
     Autocomplete nick_ac;
     Autocomplete jid_ac;
@@ -81,7 +85,8 @@ void
 muc_init(void)
 {
     invite_ac = autocomplete_new();
-    rooms = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_free_room);
+    rooms = g_hash_table_new_full(g_str_hash, g_str_equal, (GDestroyNotify)intern_unref,
+        (GDestroyNotify)_free_room);
 }
 
 void
@@ -162,6 +167,7 @@ muc_join(const char * const room, const char * const nick,
     new_room->role = MUC_ROLE_NONE;
     new_room->affiliation = MUC_AFFILIATION_NONE;
     new_room->autocomplete_prefix = NULL;
+    new_room->prefix_generation = 0;
     if (password) {
         new_room->password = strdup(password);
     } else {
@@ -170,15 +176,15 @@ muc_join(const char * const room, const char * const nick,
     new_room->subject = NULL;
     new_room->pending_broadcasts = NULL;
     new_room->pending_config = FALSE;
-    new_room->roster = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_occupant_free);
-    new_room->nick_ac = autocomplete_new();
+    new_room->roster = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, (GDestroyNotify)_occupant_free);
+    new_room->nick_ac = autocomplete_new_fuzzy();
     new_room->jid_ac = autocomplete_new();
     new_room->nick_changes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
     new_room->roster_received = FALSE;
     new_room->pending_nick_change = FALSE;
     new_room->autojoin = autojoin;
 
-    g_hash_table_insert(rooms, strdup(room), new_room);
+    g_hash_table_insert(rooms, (gpointer)intern_ref(room), new_room);
 }
 
 void
@@ -323,7 +329,7 @@ muc_nick_change_complete(const char * const room, const char * const nick)
 {
     ChatRoom *chat_room = g_hash_table_lookup(rooms, room);
     if (chat_room) {
-        g_hash_table_remove(chat_room->roster, chat_room->nick);
+        g_hash_table_remove(chat_room->roster, intern_lookup(chat_room->nick));
         autocomplete_remove(chat_room->nick_ac, chat_room->nick);
         free(chat_room->nick);
         chat_room->nick = strdup(nick);
@@ -381,7 +387,7 @@ muc_roster_contains_nick(const char * const room, const char * const nick)
 {
     ChatRoom *chat_room = g_hash_table_lookup(rooms, room);
     if (chat_room) {
-        Occupant *occupant = g_hash_table_lookup(chat_room->roster, nick);
+        Occupant *occupant = g_hash_table_lookup(chat_room->roster, intern_lookup(nick));
         return (occupant != NULL);
     } else {
         return FALSE;
@@ -400,7 +406,7 @@ muc_roster_add(const char * const room, const char * const nick, const char * co
     resource_presence_t new_presence = resource_presence_from_string(show);
 
     if (chat_room) {
-        Occupant *old = g_hash_table_lookup(chat_room->roster, nick);
+        Occupant *old = g_hash_table_lookup(chat_room->roster, intern_lookup(nick));
 
         if (!old) {
             updated = TRUE;
@@ -414,7 +420,7 @@ muc_roster_add(const char * const room, const char * const nick, const char * co
         muc_role_t role_t = _role_from_string(role);
         muc_affiliation_t affiliation_t = _affiliation_from_string(affiliation);
         Occupant *occupant = _muc_occupant_new(nick, jid, role_t, affiliation_t, presence, status);
-        g_hash_table_replace(chat_room->roster, strdup(nick), occupant);
+        g_hash_table_replace(chat_room->roster, (gpointer)occupant->nick, occupant);
 
         if (jid) {
             Jid *jidp = jid_create(jid);
@@ -436,7 +442,7 @@ muc_roster_remove(const char * const room, const char * const nick)
 {
     ChatRoom *chat_room = g_hash_table_lookup(rooms, room);
     if (chat_room) {
-        g_hash_table_remove(chat_room->roster, nick);
+        g_hash_table_remove(chat_room->roster, intern_lookup(nick));
         autocomplete_remove(chat_room->nick_ac, nick);
     }
 }
@@ -446,7 +452,7 @@ muc_roster_item(const char * const room, const char * const nick)
 {
     ChatRoom *chat_room = g_hash_table_lookup(rooms, room);
     if (chat_room) {
-        Occupant *occupant = g_hash_table_lookup(chat_room->roster, nick);
+        Occupant *occupant = g_hash_table_lookup(chat_room->roster, intern_lookup(nick));
         return occupant;
     } else {
         return NULL;
@@ -643,6 +649,11 @@ muc_autocomplete(const char * const input)
         if (chat_room && chat_room->nick_ac) {
             const char * search_str = NULL;
 
+            if (chat_room->prefix_generation != autocomplete_generation()) {
+                FREE_SET_NULL(chat_room->autocomplete_prefix);
+                chat_room->prefix_generation = autocomplete_generation();
+            }
+
             gchar *last_space = g_strrstr(input, " ");
             if (!last_space) {
                 search_str = input;
@@ -903,17 +914,8 @@ _muc_occupant_new(const char *const nick, const char * const jid, muc_role_t rol
 {
     Occupant *occupant = malloc(sizeof(Occupant));
 
-    if (nick) {
-        occupant->nick = strdup(nick);
-    } else {
-        occupant->nick = NULL;
-    }
-
-    if (jid) {
-        occupant->jid = strdup(jid);
-    } else {
-        occupant->jid = NULL;
-    }
+    occupant->nick = intern_ref(nick);
+    occupant->jid = intern_ref(jid);
 
     occupant->presence = presence;
 
@@ -933,8 +935,8 @@ static void
 _occupant_free(Occupant *occupant)
 {
     if (occupant) {
-        free(occupant->nick);
-        free(occupant->jid);
+        intern_unref(occupant->nick);
+        intern_unref(occupant->jid);
         free(occupant->status);
         free(occupant);
         occupant = NULL;
@@ -57,8 +57,8 @@ typedef enum {
 } muc_affiliation_t;
 
 typedef struct _muc_occupant_t {
-    char *nick;
-    char *jid;
+    const char *nick;
+    const char *jid;
     muc_role_t role;
     muc_affiliation_t affiliation;
     resource_presence_t presence;
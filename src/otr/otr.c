@@ -184,12 +184,6 @@ otr_shutdown(void)
     }
 }
 
-void
-otr_poll(void)
-{
-    otrlib_poll();
-}
-
 void
 otr_on_connect(ProfAccount *account)
 {
@@ -307,7 +301,7 @@ otr_keygen(ProfAccount *account)
     log_debug("Generating private key file %s for %s", keysfilename->str, jid);
     cons_show("Generating private key, this may take some time.");
     cons_show("Moving the mouse randomly around the screen may speed up the process!");
-    ui_update();
+    ui_update_now();
     err = otrl_privkey_generate(user_state, keysfilename->str, account->jid, "xmpp");
     if (!err == GPG_ERR_NO_ERROR) {
         g_string_free(basedir, TRUE);
@@ -580,7 +574,7 @@ otr_get_policy(const char * const recipient)
     account_free(account);
 
     // check global setting
-    char *pref_otr_policy = prefs_get_string(PREF_OTR_POLICY);
+    const char *pref_otr_policy = prefs_peek_string(PREF_OTR_POLICY);
 
     // pref defaults to manual
     prof_otrpolicy_t result = PROF_OTRPOLICY_MANUAL;
@@ -591,8 +585,6 @@ otr_get_policy(const char * const recipient)
         result = PROF_OTRPOLICY_ALWAYS;
     }
 
-    prefs_free_string(pref_otr_policy);
-
     return result;
 }
 
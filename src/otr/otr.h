@@ -54,7 +54,6 @@ void otr_init(void);
 void otr_shutdown(void);
 char* otr_libotr_version(void);
 char* otr_start_query(void);
-void otr_poll(void);
 void otr_on_connect(ProfAccount *account);
 void otr_keygen(ProfAccount *account);
 
@@ -50,11 +50,6 @@ otrlib_init_timer(void)
 {
 }
 
-void
-otrlib_poll(void)
-{
-}
-
 char *
 otrlib_start_query(void)
 {
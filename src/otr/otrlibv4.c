@@ -40,35 +40,35 @@
 #include "log.h"
 #include "otr/otr.h"
 #include "otr/otrlib.h"
+#include "timers.h"
 
-static GTimer *timer;
+static ProfTimer timer;
 static unsigned int current_interval;
 
+static gint _otrlib_poll_delay(void);
+
 OtrlPolicy
 otrlib_policy(void)
 {
     return OTRL_POLICY_ALLOW_V1 | OTRL_POLICY_ALLOW_V2;
 }
 
-void
-otrlib_init_timer(void)
+static gint
+_otrlib_poll_timeout(void *data)
 {
     OtrlUserState user_state = otr_userstate();
-    timer = g_timer_new();
-    current_interval = otrl_message_poll_get_default_interval(user_state);
+    OtrlMessageAppOps *ops = otr_messageops();
+    otrl_message_poll(user_state, ops, NULL);
+
+    return _otrlib_poll_delay();
 }
 
 void
-otrlib_poll(void)
+otrlib_init_timer(void)
 {
-    gdouble elapsed = g_timer_elapsed(timer, NULL);
-
-    if (current_interval != 0 && elapsed > current_interval) {
-        OtrlUserState user_state = otr_userstate();
-        OtrlMessageAppOps *ops = otr_messageops();
-        otrl_message_poll(user_state, ops, NULL);
-        g_timer_start(timer);
-    }
+    OtrlUserState user_state = otr_userstate();
+    current_interval = otrl_message_poll_get_default_interval(user_state);
+    timer = timers_add("otr poll", _otrlib_poll_delay(), _otrlib_poll_timeout, NULL);
 }
 
 char *
@@ -106,6 +106,19 @@ static void
 cb_timer_control(void *opdata, unsigned int interval)
 {
     current_interval = interval;
+    if (timer != NULL) {
+        timers_reset(timer, _otrlib_poll_delay());
+    }
+}
+
+static gint
+_otrlib_poll_delay(void)
+{
+    if (current_interval != 0) {
+        return current_interval * 1000;
+    } else {
+        return TIMER_STOP;
+    }
 }
 
 static void
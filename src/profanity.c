@@ -37,10 +37,13 @@
 #include "gitversion.h"
 #endif
 
+#include <errno.h>
 #include <locale.h>
+#include <poll.h>
 #include <signal.h>
 #include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 
 #include <glib.h>
 
@@ -60,6 +63,7 @@
 #include "otr/otr.h"
 #endif
 #include "resource.h"
+#include "timers.h"
 #include "xmpp/xmpp.h"
 #include "ui/ui.h"
 #include "ui/windows.h"
@@ -69,6 +73,12 @@ static void _init(const int disable_tls, char *log_level);
 static void _shutdown(void);
 static void _create_directories(void);
 static void _connect_default(const char * const account);
+static void _wait_for_events(gint timeout);
+static gint _autoaway_timeout(void *data);
+
+// bounds on how long to sleep before checking the idle time again
+#define AUTOAWAY_MIN_CHECK_MS 1000
+#define AUTOAWAY_MAX_CHECK_MS 60000
 
 static gboolean idle = FALSE;
 
@@ -85,40 +95,17 @@ prof_run(const int disable_tls, char *log_level, char *account_name)
     log_info("Starting main event loop");
 
     while(cmd_result) {
-        while(!line) {
-            _check_autoaway();
-            line = ui_readline();
-#ifdef HAVE_LIBOTR
-            otr_poll();
-#endif
-            notify_remind();
-            jabber_process_events();
-            ui_update();
-        }
-        cmd_result = cmd_process_input(line);
-        ui_input_clear();
-        FREE_SET_NULL(line);
-    }
-}
+        _wait_for_events(timers_next_timeout());
 
-void
-prof_handle_idle(void)
-{
-    jabber_conn_status_t status = jabber_get_connection_status();
-    if (status == JABBER_CONNECTED) {
-        GSList *recipients = ui_get_chat_recipients();
-        GSList *curr = recipients;
-
-        while (curr != NULL) {
-            char *barejid = curr->data;
-            ProfChatWin *chatwin = wins_get_chat(barejid);
-            chat_state_handle_idle(chatwin->barejid, chatwin->state);
-            curr = g_slist_next(curr);
+        while(cmd_result && (line = ui_readline()) != NULL) {
+            cmd_result = cmd_process_input(line);
+            ui_input_clear();
+            FREE_SET_NULL(line);
         }
 
-        if (recipients != NULL) {
-            g_slist_free(recipients);
-        }
+        jabber_process_events(0);
+        timers_run();
+        ui_update();
     }
 }
 
@@ -134,6 +121,30 @@ prof_handle_activity(void)
     }
 }
 
+static void
+_wait_for_events(gint timeout)
+{
+    struct pollfd fds[2];
+    nfds_t nfds = 0;
+
+    fds[nfds].fd = STDIN_FILENO;
+    fds[nfds].events = POLLIN;
+    nfds++;
+
+    // readable when the network thread has queued events for us
+    int xmpp_fd = jabber_get_fd();
+    if (xmpp_fd >= 0) {
+        fds[nfds].fd = xmpp_fd;
+        fds[nfds].events = POLLIN;
+        nfds++;
+    }
+
+    // EINTR (e.g. SIGWINCH) just means ncurses has something for us
+    if (poll(fds, nfds, timeout) < 0 && errno != EINTR) {
+        log_error("Main loop poll failed: %s", g_strerror(errno));
+    }
+}
+
 static void
 _connect_default(const char * const account)
 {
@@ -148,6 +159,27 @@ _connect_default(const char * const account)
     }
 }
 
+static gint
+_autoaway_timeout(void *data)
+{
+    _check_autoaway();
+
+    // while away watch for the user coming back
+    if (idle) {
+        return AUTOAWAY_MIN_CHECK_MS;
+    }
+
+    // otherwise sleep until the idle time could reach the limit
+    gint next = prefs_get_autoaway_time() * 60000 - ui_get_idle_time();
+    if (next < AUTOAWAY_MIN_CHECK_MS) {
+        return AUTOAWAY_MIN_CHECK_MS;
+    } else if (next > AUTOAWAY_MAX_CHECK_MS) {
+        return AUTOAWAY_MAX_CHECK_MS;
+    } else {
+        return next;
+    }
+}
+
 static void
 _check_autoaway()
 {
@@ -158,14 +190,14 @@ _check_autoaway()
 
     gint prefs_time = prefs_get_autoaway_time() * 60000;
     unsigned long idle_ms = ui_get_idle_time();
-    char *pref_autoaway_mode = prefs_get_string(PREF_AUTOAWAY_MODE);
+    const char *pref_autoaway_mode = prefs_peek_string(PREF_AUTOAWAY_MODE);
 
     if (!idle) {
         resource_presence_t current_presence = accounts_get_last_presence(jabber_get_account_name());
         if ((current_presence == RESOURCE_ONLINE) || (current_presence == RESOURCE_CHAT)) {
             if (idle_ms >= prefs_time) {
                 idle = TRUE;
-                char *pref_autoaway_message = prefs_get_string(PREF_AUTOAWAY_MESSAGE);
+                const char *pref_autoaway_message = prefs_peek_string(PREF_AUTOAWAY_MESSAGE);
 
                 // handle away mode
                 if (strcmp(pref_autoaway_mode, "away") == 0) {
@@ -176,8 +208,6 @@ _check_autoaway()
                 } else if (strcmp(pref_autoaway_mode, "idle") == 0) {
                     presence_update(RESOURCE_ONLINE, pref_autoaway_message, idle_ms / 1000);
                 }
-
-                prefs_free_string(pref_autoaway_message);
             }
         }
 
@@ -197,8 +227,6 @@ _check_autoaway()
             }
         }
     }
-
-    prefs_free_string(pref_autoaway_mode);
 }
 
 static void
@@ -210,6 +238,7 @@ _init(const int disable_tls, char *log_level)
     signal(SIGINT, SIG_IGN);
     signal(SIGTSTP, SIG_IGN);
     _create_directories();
+    timers_init();
     log_level_t prof_log_level = log_level_from_string(log_level);
     prefs_load();
     log_init(prof_log_level);
@@ -237,8 +266,8 @@ _init(const int disable_tls, char *log_level)
 #ifdef HAVE_LIBOTR
     otr_init();
 #endif
+    timers_add("autoaway", AUTOAWAY_MIN_CHECK_MS, _autoaway_timeout, NULL);
     atexit(_shutdown);
-    ui_input_nonblocking(TRUE);
 }
 
 static void
@@ -266,6 +295,7 @@ _shutdown(void)
     theme_close();
     accounts_close();
     cmd_uninit();
+    timers_close();
     log_close();
 }
 
@@ -38,13 +38,14 @@
 
 #include <common.h>
 #include <resource.h>
+#include "tools/intern.h"
 
 Resource * resource_new(const char * const name, resource_presence_t presence,
     const char * const status, const int priority)
 {
     assert(name != NULL);
     Resource *new_resource = malloc(sizeof(struct resource_t));
-    new_resource->name = strdup(name);
+    new_resource->name = intern_ref(name);
     new_resource->presence = presence;
     if (status != NULL) {
         new_resource->status = strdup(status);
@@ -89,7 +90,7 @@ resource_compare_availability(Resource *first, Resource *second)
 void resource_destroy(Resource *resource)
 {
     if (resource != NULL) {
-        free(resource->name);
+        intern_unref(resource->name);
         free(resource->status);
         free(resource);
     }
@@ -38,7 +38,7 @@
 #include "common.h"
 
 typedef struct resource_t {
-    char *name;
+    const char *name;
     resource_presence_t presence;
     char *status;
     int priority;
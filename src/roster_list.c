@@ -42,6 +42,7 @@
 #include "contact.h"
 #include "jid.h"
 #include "tools/autocomplete.h"
+#include "tools/intern.h"
 
 // nicknames
 static Autocomplete name_ac;
@@ -55,19 +56,65 @@ static Autocomplete fulljid_ac;
 // groups
 static Autocomplete groups_ac;
 
-// contacts, indexed on barejid
+// contacts, indexed on their own interned barejid
 static GHashTable *contacts;
 
-// nickname to jid map
+// nickname to jid map, both interned
 static GHashTable *name_to_barejid;
 
+// a contact's place in each ordered index, kept in step with the contact
+// so the roster can be listed in order without sorting
+typedef struct roster_entry_t {
+    PContact contact;
+    gchar *sort_key;
+    const char *presence;
+    GSequenceIter *all_iter;
+    GSequenceIter *presence_iter;
+    GSList *group_iters;
+} RosterEntry;
+
+// entries, indexed on the contact's interned barejid
+static GHashTable *entries;
+
+// all contacts in display order
+static GSequence *all_index;
+
+// presence string to contacts with that presence, in display order
+static GHashTable *presence_index;
+
+// group name to contacts in that group, in display order
+static GHashTable *group_index;
+
+// contacts in no group, in display order
+static GSequence *nogroup_index;
+
+// set between roster_load_begin and roster_load_end, index entries are
+// appended and sorted once, autocomplete items collected and added at once
+static struct {
+    gboolean active;
+    GSList *names;
+    GSList *barejids;
+    GSList *groups;
+} load;
+
 static gboolean _key_equals(void *key1, void *key2);
 static gboolean _datetimes_equal(GDateTime *dt1, GDateTime *dt2);
 static void _replace_name(const char * const current_name,
     const char * const new_name, const char * const barejid);
 static void _add_name_and_barejid(const char * const name,
     const char * const barejid);
-static gint _compare_contacts(PContact a, PContact b);
+static void _indexes_new(void);
+static void _indexes_destroy(void);
+static void _entry_add(PContact contact);
+static void _entry_file(RosterEntry *entry);
+static void _entry_unfile(RosterEntry *entry);
+static void _entry_refile_presence(const char * const barejid);
+static void _entry_free(RosterEntry *entry);
+static gint _compare_entries(gconstpointer a, gconstpointer b, gpointer data);
+static GSequenceIter * _index_insert(GSequence *index, RosterEntry *entry);
+static void _index_sort(gpointer key, gpointer value, gpointer userdata);
+static void _autocomplete_add(Autocomplete ac, GSList **pending, const char * const item);
+static GSList * _index_to_list(GSequence *index, const char * const skip_presence);
 
 void
 roster_clear(void)
@@ -76,12 +123,14 @@ roster_clear(void)
     autocomplete_clear(barejid_ac);
     autocomplete_clear(fulljid_ac);
     autocomplete_clear(groups_ac);
+    _indexes_destroy();
+    _indexes_new();
     g_hash_table_destroy(contacts);
-    contacts = g_hash_table_new_full(g_str_hash, (GEqualFunc)_key_equals, g_free,
+    contacts = g_hash_table_new_full(g_str_hash, (GEqualFunc)_key_equals, NULL,
         (GDestroyNotify)p_contact_free);
     g_hash_table_destroy(name_to_barejid);
-    name_to_barejid = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
-        g_free);
+    name_to_barejid = g_hash_table_new_full(g_str_hash, g_str_equal,
+        (GDestroyNotify)intern_unref, (GDestroyNotify)intern_unref);
 }
 
 gboolean
@@ -99,6 +148,7 @@ roster_update_presence(const char * const barejid, Resource *resource,
         p_contact_set_last_activity(contact, last_activity);
     }
     p_contact_set_presence(contact, resource);
+    _entry_refile_presence(barejid);
     Jid *jid = jid_create_from_bare_and_resource(barejid, resource->name);
     autocomplete_add(fulljid_ac, jid->fulljid);
     jid_destroy(jid);
@@ -126,6 +176,7 @@ roster_contact_offline(const char * const barejid,
     } else {
         gboolean result = p_contact_remove_resource(contact, resource);
         if (result == TRUE) {
+            _entry_refile_presence(barejid);
             Jid *jid = jid_create_from_bare_and_resource(barejid, resource);
             autocomplete_remove(fulljid_ac, jid->fulljid);
             jid_destroy(jid);
@@ -147,14 +198,15 @@ roster_reset_search_attempts(void)
 void
 roster_init(void)
 {
-    name_ac = autocomplete_new();
+    name_ac = autocomplete_new_fuzzy();
     barejid_ac = autocomplete_new();
     fulljid_ac = autocomplete_new();
     groups_ac = autocomplete_new();
-    contacts = g_hash_table_new_full(g_str_hash, (GEqualFunc)_key_equals, g_free,
+    _indexes_new();
+    contacts = g_hash_table_new_full(g_str_hash, (GEqualFunc)_key_equals, NULL,
         (GDestroyNotify)p_contact_free);
-    name_to_barejid = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
-        g_free);
+    name_to_barejid = g_hash_table_new_full(g_str_hash, g_str_equal,
+        (GDestroyNotify)intern_unref, (GDestroyNotify)intern_unref);
 }
 
 void
@@ -178,7 +230,10 @@ roster_change_name(PContact contact, const char * const new_name)
         current_name = strdup(p_contact_name(contact));
     }
 
+    RosterEntry *entry = g_hash_table_lookup(entries, barejid);
+    _entry_unfile(entry);
     p_contact_set_name(contact, new_name);
+    _entry_file(entry);
     _replace_name(current_name, new_name, barejid);
 }
 
@@ -205,6 +260,11 @@ roster_remove(const char * const name, const char * const barejid)
     }
 
     // remove the contact
+    RosterEntry *entry = g_hash_table_lookup(entries, barejid);
+    if (entry != NULL) {
+        _entry_unfile(entry);
+        g_hash_table_remove(entries, barejid);
+    }
     g_hash_table_remove(contacts, barejid);
 }
 
@@ -224,8 +284,11 @@ roster_update(const char * const barejid, const char * const name,
         current_name = strdup(p_contact_name(contact));
     }
 
+    RosterEntry *entry = g_hash_table_lookup(entries, barejid);
+    _entry_unfile(entry);
     p_contact_set_name(contact, new_name);
     p_contact_set_groups(contact, groups);
+    _entry_file(entry);
     _replace_name(current_name, new_name, barejid);
 
     // add groups
@@ -249,17 +312,48 @@ roster_add(const char * const barejid, const char * const name, GSList *groups,
 
     // add groups
     while (groups != NULL) {
-        autocomplete_add(groups_ac, groups->data);
+        _autocomplete_add(groups_ac, &load.groups, groups->data);
         groups = g_slist_next(groups);
     }
 
-    g_hash_table_insert(contacts, strdup(barejid), contact);
-    autocomplete_add(barejid_ac, barejid);
+    g_hash_table_insert(contacts, (gpointer)p_contact_barejid(contact), contact);
+    _entry_add(contact);
+    _autocomplete_add(barejid_ac, &load.barejids, barejid);
     _add_name_and_barejid(name, barejid);
 
     return TRUE;
 }
 
+void
+roster_load_begin(void)
+{
+    load.active = TRUE;
+}
+
+void
+roster_load_end(void)
+{
+    if (!load.active) {
+        return;
+    }
+    load.active = FALSE;
+
+    g_sequence_sort(all_index, _compare_entries, NULL);
+    g_sequence_sort(nogroup_index, _compare_entries, NULL);
+    g_hash_table_foreach(presence_index, _index_sort, NULL);
+    g_hash_table_foreach(group_index, _index_sort, NULL);
+
+    autocomplete_add_all(name_ac, load.names);
+    autocomplete_add_all(barejid_ac, load.barejids);
+    autocomplete_add_all(groups_ac, load.groups);
+    g_slist_free_full(load.names, (GDestroyNotify)intern_unref);
+    g_slist_free_full(load.barejids, (GDestroyNotify)intern_unref);
+    g_slist_free_full(load.groups, (GDestroyNotify)intern_unref);
+    load.names = NULL;
+    load.barejids = NULL;
+    load.groups = NULL;
+}
+
 char *
 roster_barejid_from_name(const char * const name)
 {
@@ -273,56 +367,31 @@ roster_barejid_from_name(const char * const name)
 GSList *
 roster_get_contacts_by_presence(const char * const presence)
 {
-    GSList *result = NULL;
-    GHashTableIter iter;
-    gpointer key;
-    gpointer value;
-
-    g_hash_table_iter_init(&iter, contacts);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        PContact contact = (PContact)value;
-        if (g_strcmp0(p_contact_presence(contact), presence) == 0) {
-            result = g_slist_insert_sorted(result, value, (GCompareFunc)_compare_contacts);
-        }
-    }
-
-    // resturn all contact structs
-    return result;
+    return _index_to_list(g_hash_table_lookup(presence_index, presence), NULL);
 }
 
 GSList *
 roster_get_contacts(void)
 {
-    GSList *result = NULL;
-    GHashTableIter iter;
-    gpointer key;
-    gpointer value;
-
-    g_hash_table_iter_init(&iter, contacts);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        result = g_slist_insert_sorted(result, value, (GCompareFunc)_compare_contacts);
-    }
-
-    // resturn all contact structs
-    return result;
+    return _index_to_list(all_index, NULL);
 }
 
 GSList *
 roster_get_contacts_online(void)
 {
-    GSList *result = NULL;
-    GHashTableIter iter;
-    gpointer key;
-    gpointer value;
+    return _index_to_list(all_index, "offline");
+}
 
-    g_hash_table_iter_init(&iter, contacts);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        if(strcmp(p_contact_presence(value), "offline"))
-            result = g_slist_insert_sorted(result, value, (GCompareFunc)_compare_contacts);
+int
+roster_count_online(void)
+{
+    int total = g_sequence_get_length(all_index);
+    GSequence *offline = g_hash_table_lookup(presence_index, "offline");
+    if (offline == NULL) {
+        return total;
     }
 
-    // resturn all contact structs
-    return result;
+    return total - g_sequence_get_length(offline);
 }
 
 gboolean
@@ -358,45 +427,13 @@ roster_fulljid_autocomplete(const char * const search_str)
 GSList *
 roster_get_nogroup(void)
 {
-    GSList *result = NULL;
-    GHashTableIter iter;
-    gpointer key;
-    gpointer value;
-
-    g_hash_table_iter_init(&iter, contacts);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        GSList *groups = p_contact_groups(value);
-        if (groups == NULL) {
-            result = g_slist_insert_sorted(result, value, (GCompareFunc)_compare_contacts);
-        }
-    }
-
-    // resturn all contact structs
-    return result;
+    return _index_to_list(nogroup_index, NULL);
 }
 
 GSList *
 roster_get_group(const char * const group)
 {
-    GSList *result = NULL;
-    GHashTableIter iter;
-    gpointer key;
-    gpointer value;
-
-    g_hash_table_iter_init(&iter, contacts);
-    while (g_hash_table_iter_next(&iter, &key, &value)) {
-        GSList *groups = p_contact_groups(value);
-        while (groups != NULL) {
-            if (strcmp(groups->data, group) == 0) {
-                result = g_slist_insert_sorted(result, value, (GCompareFunc)_compare_contacts);
-                break;
-            }
-            groups = g_slist_next(groups);
-        }
-    }
-
-    // resturn all contact structs
-    return result;
+    return _index_to_list(g_hash_table_lookup(group_index, group), NULL);
 }
 
 GSList *
@@ -461,38 +498,187 @@ static void
 _add_name_and_barejid(const char * const name, const char * const barejid)
 {
     if (name != NULL) {
-        autocomplete_add(name_ac, name);
-        g_hash_table_insert(name_to_barejid, strdup(name), strdup(barejid));
+        _autocomplete_add(name_ac, &load.names, name);
+        g_hash_table_insert(name_to_barejid, (gpointer)intern_ref(name), (gpointer)intern_ref(barejid));
     } else {
-        autocomplete_add(name_ac, barejid);
-        g_hash_table_insert(name_to_barejid, strdup(barejid), strdup(barejid));
+        _autocomplete_add(name_ac, &load.names, barejid);
+        g_hash_table_insert(name_to_barejid, (gpointer)intern_ref(barejid), (gpointer)intern_ref(barejid));
     }
 }
 
-static
-gint _compare_contacts(PContact a, PContact b)
+static gchar *
+_sort_key(PContact contact)
 {
-    const char * utf8_str_a = NULL;
-    const char * utf8_str_b = NULL;
+    if (p_contact_name(contact) != NULL) {
+        return g_utf8_collate_key(p_contact_name(contact), -1);
+    } else {
+        return g_utf8_collate_key(p_contact_barejid(contact), -1);
+    }
+}
+
+static gint
+_compare_entries(gconstpointer a, gconstpointer b, gpointer data)
+{
+    const RosterEntry *entry_a = a;
+    const RosterEntry *entry_b = b;
+
+    gint result = g_strcmp0(entry_a->sort_key, entry_b->sort_key);
+    if (result != 0) {
+        return result;
+    }
+
+    // same name, keep the order stable
+    return g_strcmp0(p_contact_barejid(entry_a->contact), p_contact_barejid(entry_b->contact));
+}
+
+static void
+_indexes_new(void)
+{
+    entries = g_hash_table_new_full(g_str_hash, g_str_equal, NULL,
+        (GDestroyNotify)_entry_free);
+    all_index = g_sequence_new(NULL);
+    presence_index = g_hash_table_new_full(g_str_hash, g_str_equal, free,
+        (GDestroyNotify)g_sequence_free);
+    group_index = g_hash_table_new_full(g_str_hash, g_str_equal, free,
+        (GDestroyNotify)g_sequence_free);
+    nogroup_index = g_sequence_new(NULL);
+}
+
+static void
+_indexes_destroy(void)
+{
+    g_sequence_free(all_index);
+    g_sequence_free(nogroup_index);
+    g_hash_table_destroy(presence_index);
+    g_hash_table_destroy(group_index);
+    g_hash_table_destroy(entries);
+}
+
+static GSequence *
+_index_for(GHashTable *index, const char * const key)
+{
+    GSequence *result = g_hash_table_lookup(index, key);
+    if (result == NULL) {
+        result = g_sequence_new(NULL);
+        g_hash_table_insert(index, strdup(key), result);
+    }
+
+    return result;
+}
+
+static void
+_entry_add(PContact contact)
+{
+    RosterEntry *entry = malloc(sizeof(RosterEntry));
+    entry->contact = contact;
+    entry->sort_key = NULL;
+    entry->presence = NULL;
+    entry->all_iter = NULL;
+    entry->presence_iter = NULL;
+    entry->group_iters = NULL;
+
+    g_hash_table_insert(entries, (gpointer)p_contact_barejid(contact), entry);
+    _entry_file(entry);
+}
+
+static void
+_entry_file(RosterEntry *entry)
+{
+    entry->sort_key = _sort_key(entry->contact);
+    entry->presence = p_contact_presence(entry->contact);
+
+    entry->all_iter = _index_insert(all_index, entry);
+    entry->presence_iter = _index_insert(_index_for(presence_index, entry->presence), entry);
+
+    GSList *groups = p_contact_groups(entry->contact);
+    if (groups == NULL) {
+        entry->group_iters = g_slist_prepend(entry->group_iters,
+            _index_insert(nogroup_index, entry));
+    }
+    while (groups != NULL) {
+        entry->group_iters = g_slist_prepend(entry->group_iters,
+            _index_insert(_index_for(group_index, groups->data), entry));
+        groups = g_slist_next(groups);
+    }
+}
 
-    if (p_contact_name(a) != NULL) {
-        utf8_str_a = p_contact_name(a);
+static void
+_entry_unfile(RosterEntry *entry)
+{
+    g_sequence_remove(entry->all_iter);
+    g_sequence_remove(entry->presence_iter);
+    g_slist_free_full(entry->group_iters, (GDestroyNotify)g_sequence_remove);
+    entry->group_iters = NULL;
+    g_free(entry->sort_key);
+    entry->sort_key = NULL;
+}
+
+// presence is derived from the contact's resources, move the entry
+// when the most available resource changed it
+static void
+_entry_refile_presence(const char * const barejid)
+{
+    RosterEntry *entry = g_hash_table_lookup(entries, barejid);
+    const char *presence = p_contact_presence(entry->contact);
+    if (g_strcmp0(presence, entry->presence) == 0) {
+        return;
+    }
+
+    g_sequence_remove(entry->presence_iter);
+    entry->presence = presence;
+    entry->presence_iter = _index_insert(_index_for(presence_index, presence), entry);
+}
+
+static GSequenceIter *
+_index_insert(GSequence *index, RosterEntry *entry)
+{
+    if (load.active) {
+        return g_sequence_append(index, entry);
     } else {
-        utf8_str_a = p_contact_barejid(a);
+        return g_sequence_insert_sorted(index, entry, _compare_entries, NULL);
     }
-    if (p_contact_name(b) != NULL) {
-        utf8_str_b = p_contact_name(b);
+}
+
+static void
+_index_sort(gpointer key, gpointer value, gpointer userdata)
+{
+    g_sequence_sort(value, _compare_entries, NULL);
+}
+
+static void
+_autocomplete_add(Autocomplete ac, GSList **pending, const char * const item)
+{
+    if (load.active) {
+        *pending = g_slist_prepend(*pending, (gpointer)intern_ref(item));
     } else {
-        utf8_str_b = p_contact_barejid(b);
+        autocomplete_add(ac, item);
     }
+}
 
-    gchar *key_a = g_utf8_collate_key(utf8_str_a, -1);
-    gchar *key_b = g_utf8_collate_key(utf8_str_b, -1);
+static void
+_entry_free(RosterEntry *entry)
+{
+    g_slist_free(entry->group_iters);
+    g_free(entry->sort_key);
+    free(entry);
+}
 
-    gint result = g_strcmp0(key_a, key_b);
+static GSList *
+_index_to_list(GSequence *index, const char * const skip_presence)
+{
+    GSList *result = NULL;
+    if (index == NULL) {
+        return result;
+    }
 
-    g_free(key_a);
-    g_free(key_b);
+    GSequenceIter *curr = g_sequence_get_end_iter(index);
+    while (!g_sequence_iter_is_begin(curr)) {
+        curr = g_sequence_iter_prev(curr);
+        RosterEntry *entry = g_sequence_get(curr);
+        if (skip_presence == NULL || g_strcmp0(entry->presence, skip_presence) != 0) {
+            result = g_slist_prepend(result, entry->contact);
+        }
+    }
 
     return result;
 }
@@ -55,9 +55,12 @@ void roster_update(const char * const barejid, const char * const name,
     GSList *groups, const char * const subscription, gboolean pending_out);
 gboolean roster_add(const char * const barejid, const char * const name, GSList *groups,
     const char * const subscription, gboolean pending_out);
+void roster_load_begin(void);
+void roster_load_end(void);
 char * roster_barejid_from_name(const char * const name);
 GSList * roster_get_contacts(void);
 GSList * roster_get_contacts_online(void);
+int roster_count_online(void);
 gboolean roster_has_pending_subscriptions(void);
 char * roster_contact_autocomplete(const char * const search_str);
 char * roster_fulljid_autocomplete(const char * const search_str);
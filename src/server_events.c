@@ -43,6 +43,7 @@
 #include "config/preferences.h"
 #include "config/account.h"
 #include "roster_list.h"
+#include "timers.h"
 
 #ifdef HAVE_LIBOTR
 #include "otr/otr.h"
@@ -51,6 +52,30 @@
 
 #include "ui/ui.h"
 
+// how long to wait for the first presence after the roster arrives
+#define PRESENCE_BURST_WAIT_MS 2000
+
+// presence arriving within this long of the previous one is part of the burst
+#define PRESENCE_BURST_QUIET_MS 500
+
+// the burst is summarised at the latest this long after the roster arrives
+#define PRESENCE_BURST_MAX_MS 5000
+
+// the flood of presence that follows the roster at login and reconnect,
+// contacts are updated as it arrives but the console and roster panel
+// are only told once it has settled
+static struct {
+    gboolean active;
+    gint64 started;
+    int updates;
+    ProfTimer timer;
+} burst;
+
+static void _presence_burst_start(void);
+static void _presence_burst_touch(void);
+static void _presence_burst_end(void);
+static void _presence_burst_cancel(void);
+
 void
 handle_room_join_error(const char * const room, const char * const err)
 {
@@ -129,11 +154,14 @@ handle_roster_received(void)
     if (prefs_get_boolean(PREF_ROSTER)) {
         ui_show_roster();
     }
+
+    _presence_burst_start();
 }
 
 void
 handle_lost_connection(void)
 {
+    _presence_burst_cancel();
     cons_show_error("Lost connection.");
     roster_clear();
     muc_invites_clear();
@@ -284,9 +312,7 @@ handle_room_message(const char * const room_jid, const char * const nick,
     ui_room_message(room_jid, nick, message);
 
     if (prefs_get_boolean(PREF_GRLOG)) {
-        Jid *jid = jid_create(jabber_get_fulljid());
-        groupchat_log_chat(jid->barejid, room_jid, nick, message);
-        jid_destroy(jid);
+        groupchat_log_chat(jabber_get_barejid(), room_jid, nick, message);
     }
 }
 
@@ -339,18 +365,12 @@ handle_incoming_message(char *barejid, char *resource, char *message)
     ui_incoming_msg(barejid, resource, newmessage, NULL);
 
     if (prefs_get_boolean(PREF_CHLOG)) {
-        const char *jid = jabber_get_fulljid();
-        Jid *jidp = jid_create(jid);
-
-        char *pref_otr_log = prefs_get_string(PREF_OTR_LOG);
+        const char *pref_otr_log = prefs_peek_string(PREF_OTR_LOG);
         if (!was_decrypted || (strcmp(pref_otr_log, "on") == 0)) {
-            chat_log_chat(jidp->barejid, barejid, newmessage, PROF_IN_LOG, NULL);
+            chat_log_chat(jabber_get_barejid(), barejid, newmessage, PROF_IN_LOG, NULL);
         } else if (strcmp(pref_otr_log, "redact") == 0) {
-            chat_log_chat(jidp->barejid, barejid, "[redacted]", PROF_IN_LOG, NULL);
+            chat_log_chat(jabber_get_barejid(), barejid, "[redacted]", PROF_IN_LOG, NULL);
         }
-        prefs_free_string(pref_otr_log);
-
-        jid_destroy(jidp);
     }
 
     otr_free_message(newmessage);
@@ -358,10 +378,7 @@ handle_incoming_message(char *barejid, char *resource, char *message)
     ui_incoming_msg(barejid, resource, message, NULL);
 
     if (prefs_get_boolean(PREF_CHLOG)) {
-        const char *jid = jabber_get_fulljid();
-        Jid *jidp = jid_create(jid);
-        chat_log_chat(jidp->barejid, barejid, message, PROF_IN_LOG, NULL);
-        jid_destroy(jidp);
+        chat_log_chat(jabber_get_barejid(), barejid, message, PROF_IN_LOG, NULL);
     }
 #endif
 }
@@ -378,10 +395,7 @@ handle_delayed_message(char *barejid, char *message, GTimeVal tv_stamp)
     ui_incoming_msg(barejid, NULL, message, &tv_stamp);
 
     if (prefs_get_boolean(PREF_CHLOG)) {
-        const char *jid = jabber_get_fulljid();
-        Jid *jidp = jid_create(jid);
-        chat_log_chat(jidp->barejid, barejid, message, PROF_IN_LOG, &tv_stamp);
-        jid_destroy(jidp);
+        chat_log_chat(jabber_get_barejid(), barejid, message, PROF_IN_LOG, &tv_stamp);
     }
 }
 
@@ -463,9 +477,14 @@ handle_contact_offline(char *barejid, char *resource, char *status)
 
     if (resource != NULL && updated) {
         ui_contact_offline(barejid, resource, status);
+        ui_contact_presence_changed(barejid);
     }
 
-    rosterwin_roster();
+    if (burst.active) {
+        _presence_burst_touch();
+    } else {
+        rosterwin_roster();
+    }
     chat_session_remove(barejid);
 }
 
@@ -476,14 +495,17 @@ handle_contact_online(char *barejid, Resource *resource,
     gboolean updated = roster_update_presence(barejid, resource, last_activity);
 
     if (updated) {
-        char *show_console = prefs_get_string(PREF_STATUSES_CONSOLE);
-        char *show_chat_win = prefs_get_string(PREF_STATUSES_CHAT);
+        const char *show_console = prefs_peek_string(PREF_STATUSES_CONSOLE);
+        const char *show_chat_win = prefs_peek_string(PREF_STATUSES_CHAT);
         PContact contact = roster_get_contact(barejid);
         if (p_contact_subscription(contact) != NULL) {
             if (strcmp(p_contact_subscription(contact), "none") != 0) {
 
+                // summarised once the burst settles
+                if (burst.active) {
+
                 // show in console if "all"
-                if (g_strcmp0(show_console, "all") == 0) {
+                } else if (g_strcmp0(show_console, "all") == 0) {
                     cons_show_contact_online(contact, resource, last_activity);
 
                 // show in console of "online" and presence online
@@ -504,11 +526,14 @@ handle_contact_online(char *barejid, Resource *resource,
                 }
             }
         }
-        prefs_free_string(show_console);
-        prefs_free_string(show_chat_win);
+        ui_contact_presence_changed(barejid);
     }
 
-    rosterwin_roster();
+    if (burst.active) {
+        _presence_burst_touch();
+    } else {
+        rosterwin_roster();
+    }
     chat_session_remove(barejid);
 }
 
@@ -584,11 +609,10 @@ handle_room_occupant_offline(const char * const room, const char * const nick,
 {
     muc_roster_remove(room, nick);
 
-    char *muc_status_pref = prefs_get_string(PREF_STATUSES_MUC);
+    const char *muc_status_pref = prefs_peek_string(PREF_STATUSES_MUC);
     if (g_strcmp0(muc_status_pref, "none") != 0) {
         ui_room_member_offline(room, nick);
     }
-    prefs_free_string(muc_status_pref);
     occupantswin_occupants(room);
 }
 
@@ -783,22 +807,20 @@ handle_muc_occupant_online(const char * const room, const char * const nick, con
 
     // joined room
     if (!occupant) {
-        char *muc_status_pref = prefs_get_string(PREF_STATUSES_MUC);
+        const char *muc_status_pref = prefs_peek_string(PREF_STATUSES_MUC);
         if (g_strcmp0(muc_status_pref, "none") != 0) {
             ui_room_member_online(room, nick, role, affiliation, show, status);
         }
-        prefs_free_string(muc_status_pref);
         occupantswin_occupants(room);
         return;
     }
 
     // presence updated
     if (updated) {
-        char *muc_status_pref = prefs_get_string(PREF_STATUSES_MUC);
+        const char *muc_status_pref = prefs_peek_string(PREF_STATUSES_MUC);
         if (g_strcmp0(muc_status_pref, "all") == 0) {
             ui_room_member_presence(room, nick, show, status);
         }
-        prefs_free_string(muc_status_pref);
         occupantswin_occupants(room);
 
     // presence unchanged, check for role/affiliation change
@@ -819,4 +841,71 @@ handle_muc_occupant_online(const char * const room, const char * const nick, con
         }
         occupantswin_occupants(room);
     }
+}
+
+static gint
+_presence_burst_timeout(void *data)
+{
+    if (jabber_get_connection_status() == JABBER_CONNECTED) {
+        _presence_burst_end();
+    } else {
+        _presence_burst_cancel();
+    }
+
+    return TIMER_STOP;
+}
+
+static void
+_presence_burst_start(void)
+{
+    burst.active = TRUE;
+    burst.started = g_get_monotonic_time() / 1000;
+    burst.updates = 0;
+
+    if (burst.timer == NULL) {
+        burst.timer = timers_add("presence burst", PRESENCE_BURST_WAIT_MS,
+            _presence_burst_timeout, NULL);
+    } else {
+        timers_reset(burst.timer, PRESENCE_BURST_WAIT_MS);
+    }
+}
+
+static void
+_presence_burst_touch(void)
+{
+    burst.updates++;
+
+    gint64 elapsed = g_get_monotonic_time() / 1000 - burst.started;
+    if (elapsed >= PRESENCE_BURST_MAX_MS) {
+        _presence_burst_end();
+        return;
+    }
+
+    timers_reset(burst.timer, MIN(PRESENCE_BURST_QUIET_MS, PRESENCE_BURST_MAX_MS - elapsed));
+}
+
+static void
+_presence_burst_end(void)
+{
+    _presence_burst_cancel();
+
+    int online = roster_count_online();
+    log_info("Presence burst settled: %d updates in %dms, %d contacts online",
+        burst.updates, (int)(g_get_monotonic_time() / 1000 - burst.started), online);
+
+    const char *show_console = prefs_peek_string(PREF_STATUSES_CONSOLE);
+    if (online > 0 && g_strcmp0(show_console, "none") != 0) {
+        cons_show("%d contact%s online.", online, online == 1 ? "" : "s");
+    }
+
+    rosterwin_roster();
+}
+
+static void
+_presence_burst_cancel(void)
+{
+    burst.active = FALSE;
+    if (burst.timer != NULL) {
+        timers_reset(burst.timer, TIMER_STOP);
+    }
 }
\ No newline at end of file
@@ -0,0 +1,117 @@
+/*
+ * timers.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <glib.h>
+
+#include "timers.h"
+#include "tools/timerwheel.h"
+
+static TimerWheel wheel;
+
+static gint64 _now_ms(void);
+
+static TimerWheel
+_get_wheel(void)
+{
+    if (wheel == NULL) {
+        timers_init();
+    }
+
+    return wheel;
+}
+
+void
+timers_init(void)
+{
+    if (wheel == NULL) {
+        wheel = timerwheel_new(_now_ms);
+    }
+}
+
+void
+timers_close(void)
+{
+    timerwheel_free(wheel);
+    wheel = NULL;
+}
+
+ProfTimer
+timers_add(const char * const name, gint delay, timer_func func, void *data)
+{
+    return timerwheel_add(_get_wheel(), name, delay, func, data);
+}
+
+void
+timers_reset(ProfTimer timer, gint delay)
+{
+    timerwheel_reset(_get_wheel(), timer, delay);
+}
+
+void
+timers_remove(ProfTimer timer)
+{
+    if (timer != NULL && wheel != NULL) {
+        timerwheel_remove(wheel, timer);
+    }
+}
+
+void
+timers_run(void)
+{
+    timerwheel_run(_get_wheel());
+}
+
+gint
+timers_next_timeout(void)
+{
+    return timerwheel_next_timeout(_get_wheel());
+}
+
+GList *
+timers_get_all(void)
+{
+    return timerwheel_timers(_get_wheel());
+}
+
+gint64
+timers_get_remaining(ProfTimer timer)
+{
+    return timerwheel_timer_remaining(_get_wheel(), timer);
+}
+
+static gint64
+_now_ms(void)
+{
+    return g_get_monotonic_time() / 1000;
+}
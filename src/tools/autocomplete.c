@@ -38,33 +38,102 @@
 
 #include "common.h"
 #include "tools/autocomplete.h"
+#include "tools/intern.h"
 #include "tools/parser.h"
 
+// most fuzzy matches offered for one search
+#define FUZZY_MAX_RANKED 10
+
+// items are interned, most are jids and nicks also held elsewhere,
+// they are kept sorted so prefix matches are a contiguous range
 struct autocomplete_t {
-    GSList *items;
-    GSList *last_found;
+    GPtrArray *items;
+    const char *last_found;
     gchar *search_str;
+    guint generation;
+
+    // only set up for autocompleters created with autocomplete_new_fuzzy
+    gboolean fuzzy;
+    GArray *keys;
+    GHashTable *used;
+    GPtrArray *ranked;
+    guint ranked_pos;
 };
 
-static gchar * _search_from(Autocomplete ac, GSList *curr, gboolean quote);
+// lowercased copy of an item and the characters it holds
+typedef struct fuzzy_key_t {
+    guint64 signature;
+    gchar *folded;
+} FuzzyKey;
+
+typedef struct fuzzy_match_t {
+    const char *item;
+    int score;
+    guint used;
+} FuzzyMatch;
+
+// user preference, fuzzy autocompleters only prefix match while off
+static gboolean fuzzy_enabled = FALSE;
+
+// stamps items as they are completed so recent ones rank first
+static guint use_clock = 0;
+
+// bumped by autocomplete_reset_all, autocompleters from an older
+// generation drop their search when next completed
+static guint generation = 0;
+
+static gint _compare_items(gconstpointer a, gconstpointer b, gpointer data);
+static guint _lower_bound(Autocomplete ac, const char * const str);
+static gchar * _match_at(Autocomplete ac, guint index, gboolean quote);
+static gchar * _found(Autocomplete ac, const char * const item, gboolean quote);
+static void _fuzzy_stale(Autocomplete ac);
+static gchar * _fuzzy_first(Autocomplete ac, gboolean quote);
+static guint64 _signature(const char * const str);
+static gboolean _word_start(const char * const item, const char * const pos);
+static gboolean _fuzzy_score(const char * const item, const char * const search, int *score);
 
 Autocomplete
 autocomplete_new(void)
 {
     Autocomplete new = malloc(sizeof(struct autocomplete_t));
-    new->items = NULL;
+    new->items = g_ptr_array_new_with_free_func((GDestroyNotify)intern_unref);
     new->last_found = NULL;
     new->search_str = NULL;
+    new->generation = generation;
+    new->fuzzy = FALSE;
+    new->keys = NULL;
+    new->used = NULL;
+    new->ranked = NULL;
+    new->ranked_pos = 0;
+
+    return new;
+}
+
+Autocomplete
+autocomplete_new_fuzzy(void)
+{
+    Autocomplete new = autocomplete_new();
+    new->fuzzy = TRUE;
+    new->used = g_hash_table_new(g_direct_hash, g_direct_equal);
 
     return new;
 }
 
+void
+autocomplete_set_fuzzy(gboolean enabled)
+{
+    fuzzy_enabled = enabled;
+}
+
 void
 autocomplete_clear(Autocomplete ac)
 {
     if (ac) {
-        g_slist_free_full(ac->items, free);
-        ac->items = NULL;
+        g_ptr_array_set_size(ac->items, 0);
+        _fuzzy_stale(ac);
+        if (ac->used) {
+            g_hash_table_remove_all(ac->used);
+        }
 
         autocomplete_reset(ac);
     }
@@ -73,8 +142,25 @@ autocomplete_clear(Autocomplete ac)
 void
 autocomplete_reset(Autocomplete ac)
 {
+    ac->generation = generation;
     ac->last_found = NULL;
     FREE_SET_NULL(ac->search_str);
+    if (ac->ranked) {
+        g_ptr_array_free(ac->ranked, TRUE);
+        ac->ranked = NULL;
+    }
+}
+
+void
+autocomplete_reset_all(void)
+{
+    generation++;
+}
+
+guint
+autocomplete_generation(void)
+{
+    return generation;
 }
 
 void
@@ -82,6 +168,10 @@ autocomplete_free(Autocomplete ac)
 {
     if (ac) {
         autocomplete_clear(ac);
+        g_ptr_array_free(ac->items, TRUE);
+        if (ac->used) {
+            g_hash_table_destroy(ac->used);
+        }
         free(ac);
     }
 }
@@ -91,10 +181,8 @@ autocomplete_length(Autocomplete ac)
 {
     if (!ac) {
         return 0;
-    } else if (!ac->items) {
-        return 0;
     } else {
-        return g_slist_length(ac->items);
+        return ac->items->len;
     }
 }
 
@@ -102,38 +190,102 @@ void
 autocomplete_add(Autocomplete ac, const char *item)
 {
     if (ac) {
-        char *item_cpy;
-        GSList *curr = g_slist_find_custom(ac->items, item, (GCompareFunc)strcmp);
+        guint index = _lower_bound(ac, item);
 
         // if item already exists
-        if (curr) {
+        if (index < ac->items->len && strcmp(g_ptr_array_index(ac->items, index), item) == 0) {
             return;
         }
 
-        item_cpy = strdup(item);
-        ac->items = g_slist_insert_sorted(ac->items, item_cpy, (GCompareFunc)strcmp);
+        // grow by one and open a gap at index
+        g_ptr_array_add(ac->items, NULL);
+        memmove(&ac->items->pdata[index + 1], &ac->items->pdata[index],
+            (ac->items->len - index - 1) * sizeof(gpointer));
+        ac->items->pdata[index] = (gpointer)intern_ref(item);
+        _fuzzy_stale(ac);
     }
 
     return;
 }
 
+void
+autocomplete_add_all(Autocomplete ac, GSList *items)
+{
+    if (!ac) {
+        return;
+    }
+
+    GPtrArray *added = g_ptr_array_sized_new(g_slist_length(items));
+    while (items) {
+        g_ptr_array_add(added, (gpointer)intern_ref(items->data));
+        items = g_slist_next(items);
+    }
+    g_qsort_with_data(added->pdata, added->len, sizeof(gpointer), _compare_items, NULL);
+
+    // merge into the existing items, which win ties so last_found stays valid
+    GPtrArray *merged = g_ptr_array_sized_new(ac->items->len + added->len);
+    g_ptr_array_set_free_func(merged, (GDestroyNotify)intern_unref);
+    guint curr = 0;
+    guint next = 0;
+    while (curr < ac->items->len || next < added->len) {
+        const char *item = NULL;
+        if (next == added->len || (curr < ac->items->len &&
+                strcmp(g_ptr_array_index(ac->items, curr), g_ptr_array_index(added, next)) <= 0)) {
+            item = g_ptr_array_index(ac->items, curr++);
+        } else {
+            item = g_ptr_array_index(added, next++);
+        }
+
+        if (merged->len > 0 && strcmp(g_ptr_array_index(merged, merged->len - 1), item) == 0) {
+            intern_unref(item);
+        } else {
+            g_ptr_array_add(merged, (gpointer)item);
+        }
+    }
+
+    // references moved to merged
+    g_ptr_array_free(added, TRUE);
+    g_ptr_array_set_free_func(ac->items, NULL);
+    g_ptr_array_free(ac->items, TRUE);
+    ac->items = merged;
+    _fuzzy_stale(ac);
+}
+
 void
 autocomplete_remove(Autocomplete ac, const char * const item)
 {
     if (ac) {
-        GSList *curr = g_slist_find_custom(ac->items, item, (GCompareFunc)strcmp);
+        guint index = _lower_bound(ac, item);
 
-        if (!curr) {
+        if (index == ac->items->len || strcmp(g_ptr_array_index(ac->items, index), item) != 0) {
             return;
         }
 
-        // reset last found if it points to the item to be removed
-        if (ac->last_found == curr) {
-            ac->last_found = NULL;
+        const char *found = g_ptr_array_index(ac->items, index);
+
+        // reset the search if it last found the item to be removed
+        if (ac->last_found == found) {
+            autocomplete_reset(ac);
         }
 
-        free(curr->data);
-        ac->items = g_slist_delete_link(ac->items, curr);
+        if (ac->ranked) {
+            guint i;
+            for (i = 0; i < ac->ranked->len; i++) {
+                if (g_ptr_array_index(ac->ranked, i) == found) {
+                    g_ptr_array_remove_index(ac->ranked, i);
+                    if (i < ac->ranked_pos) {
+                        ac->ranked_pos--;
+                    }
+                    break;
+                }
+            }
+        }
+        if (ac->used) {
+            g_hash_table_remove(ac->used, found);
+        }
+
+        g_ptr_array_remove_index(ac->items, index);
+        _fuzzy_stale(ac);
     }
 
     return;
@@ -143,11 +295,10 @@ GSList *
 autocomplete_create_list(Autocomplete ac)
 {
     GSList *copy = NULL;
-    GSList *curr = ac->items;
+    guint i = ac->items->len;
 
-    while(curr) {
-        copy = g_slist_append(copy, strdup(curr->data));
-        curr = g_slist_next(curr);
+    while (i > 0) {
+        copy = g_slist_prepend(copy, strdup(g_ptr_array_index(ac->items, --i)));
     }
 
     return copy;
@@ -156,16 +307,9 @@ autocomplete_create_list(Autocomplete ac)
 gboolean
 autocomplete_contains(Autocomplete ac, const char *value)
 {
-    GSList *curr = ac->items;
+    guint index = _lower_bound(ac, value);
 
-    while(curr) {
-        if (strcmp(curr->data, value) == 0) {
-            return TRUE;
-        }
-        curr = g_slist_next(curr);
-    }
-
-    return FALSE;
+    return index < ac->items->len && strcmp(g_ptr_array_index(ac->items, index), value) == 0;
 }
 
 gchar *
@@ -178,8 +322,12 @@ autocomplete_complete(Autocomplete ac, const gchar *search_str, gboolean quote)
         return NULL;
     }
 
+    if (ac->generation != generation) {
+        autocomplete_reset(ac);
+    }
+
     // no items to search
-    if (!ac->items) {
+    if (ac->items->len == 0) {
         return NULL;
     }
 
@@ -190,20 +338,33 @@ autocomplete_complete(Autocomplete ac, const gchar *search_str, gboolean quote)
         }
 
         ac->search_str = strdup(search_str);
-        found = _search_from(ac, ac->items, quote);
+        found = _match_at(ac, _lower_bound(ac, ac->search_str), quote);
+
+        // nothing starts with it, try the best fuzzy matches
+        if (!found && ac->fuzzy && fuzzy_enabled && ac->search_str[0] != '\0') {
+            found = _fuzzy_first(ac, quote);
+        }
 
         return found;
 
+    // subsequent search attempt, cycle through the fuzzy matches
+    } else if (ac->ranked) {
+        ac->ranked_pos = (ac->ranked_pos + 1) % ac->ranked->len;
+        ac->last_found = g_ptr_array_index(ac->ranked, ac->ranked_pos);
+
+        return _found(ac, ac->last_found, quote);
+
     // subsequent search attempt
     } else {
-        // search from here+1 to end
-        found = _search_from(ac, g_slist_next(ac->last_found), quote);
+        // search from the item after the last found, which may have moved
+        guint index = _lower_bound(ac, ac->last_found);
+        found = _match_at(ac, index + 1, quote);
         if (found) {
             return found;
         }
 
         // search from beginning
-        found = _search_from(ac, ac->items, quote);
+        found = _match_at(ac, _lower_bound(ac, ac->search_str), quote);
         if (found) {
             return found;
         }
@@ -309,36 +470,211 @@ autocomplete_param_no_with_func(const char * const input, char *command, int arg
     return NULL;
 }
 
+static gint
+_compare_items(gconstpointer a, gconstpointer b, gpointer data)
+{
+    return strcmp(*(const char **)a, *(const char **)b);
+}
+
+// index of the first item not less than str
+static guint
+_lower_bound(Autocomplete ac, const char * const str)
+{
+    guint low = 0;
+    guint high = ac->items->len;
+
+    while (low < high) {
+        guint mid = low + (high - low) / 2;
+        if (strcmp(g_ptr_array_index(ac->items, mid), str) < 0) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
 static gchar *
-_search_from(Autocomplete ac, GSList *curr, gboolean quote)
+_match_at(Autocomplete ac, guint index, gboolean quote)
 {
-    while(curr) {
+    if (index >= ac->items->len) {
+        return NULL;
+    }
 
-        // match found
-        if (strncmp(curr->data, ac->search_str, strlen(ac->search_str)) == 0) {
+    const char *item = g_ptr_array_index(ac->items, index);
 
-            // set pointer to last found
-            ac->last_found = curr;
+    // match found
+    if (strncmp(item, ac->search_str, strlen(ac->search_str)) == 0) {
 
-            // if contains space, quote before returning
-            if (quote && g_strrstr(curr->data, " ")) {
-                GString *quoted = g_string_new("\"");
-                g_string_append(quoted, curr->data);
-                g_string_append(quoted, "\"");
+        // set pointer to last found
+        ac->last_found = item;
 
-                gchar *result = quoted->str;
-                g_string_free(quoted, FALSE);
+        return _found(ac, item, quote);
+    }
 
-                return result;
+    return NULL;
+}
 
-            // otherwise just return the string
-            } else {
-                return strdup(curr->data);
-            }
+static gchar *
+_found(Autocomplete ac, const char * const item, gboolean quote)
+{
+    if (ac->used) {
+        g_hash_table_insert(ac->used, (gpointer)item, GUINT_TO_POINTER(++use_clock));
+    }
+
+    // if contains space, quote before returning
+    if (quote && g_strrstr(item, " ")) {
+        GString *quoted = g_string_new("\"");
+        g_string_append(quoted, item);
+        g_string_append(quoted, "\"");
+
+        gchar *result = quoted->str;
+        g_string_free(quoted, FALSE);
+
+        return result;
+
+    // otherwise just return the string
+    } else {
+        return strdup(item);
+    }
+}
+
+// keys follow the items, rebuilt on the next fuzzy search
+static void
+_fuzzy_stale(Autocomplete ac)
+{
+    if (ac->keys) {
+        guint i;
+        for (i = 0; i < ac->keys->len; i++) {
+            g_free(g_array_index(ac->keys, FuzzyKey, i).folded);
         }
+        g_array_free(ac->keys, TRUE);
+        ac->keys = NULL;
+    }
+}
 
-        curr = g_slist_next(curr);
+static gchar *
+_fuzzy_first(Autocomplete ac, gboolean quote)
+{
+    guint i;
+    if (!ac->keys) {
+        ac->keys = g_array_sized_new(FALSE, FALSE, sizeof(FuzzyKey), ac->items->len);
+        for (i = 0; i < ac->items->len; i++) {
+            FuzzyKey key;
+            key.folded = g_ascii_strdown(g_ptr_array_index(ac->items, i), -1);
+            key.signature = _signature(key.folded);
+            g_array_append_val(ac->keys, key);
+        }
     }
 
-    return NULL;
+    // keep the best few, by score then most recently used, ties stay in item order
+    FuzzyMatch best[FUZZY_MAX_RANKED];
+    int count = 0;
+    gchar *search = g_ascii_strdown(ac->search_str, -1);
+    guint64 wanted = _signature(search);
+    for (i = 0; i < ac->items->len; i++) {
+        FuzzyKey *key = &g_array_index(ac->keys, FuzzyKey, i);
+        if ((key->signature & wanted) != wanted) {
+            continue;
+        }
+
+        int score = 0;
+        if (!_fuzzy_score(key->folded, search, &score)) {
+            continue;
+        }
+
+        const char *item = g_ptr_array_index(ac->items, i);
+        FuzzyMatch match = { item, score, GPOINTER_TO_UINT(g_hash_table_lookup(ac->used, item)) };
+        int pos = count;
+        while (pos > 0 && (match.score > best[pos-1].score ||
+                (match.score == best[pos-1].score && match.used > best[pos-1].used))) {
+            pos--;
+        }
+        if (pos == FUZZY_MAX_RANKED) {
+            continue;
+        }
+        if (count < FUZZY_MAX_RANKED) {
+            count++;
+        }
+        memmove(&best[pos+1], &best[pos], (count - pos - 1) * sizeof(FuzzyMatch));
+        best[pos] = match;
+    }
+    g_free(search);
+
+    if (count == 0) {
+        return NULL;
+    }
+
+    ac->ranked = g_ptr_array_sized_new(count);
+    for (i = 0; i < count; i++) {
+        g_ptr_array_add(ac->ranked, (gpointer)best[i].item);
+    }
+    ac->ranked_pos = 0;
+    ac->last_found = best[0].item;
+
+    return _found(ac, ac->last_found, quote);
+}
+
+// a bit for each character, characters may share a bit so this
+// only rules out items missing a character of the search
+static guint64
+_signature(const char * const str)
+{
+    guint64 signature = 0;
+    const char *curr = str;
+    while (*curr) {
+        signature |= G_GUINT64_CONSTANT(1) << (*curr & 63);
+        curr++;
+    }
+
+    return signature;
+}
+
+static gboolean
+_word_start(const char * const item, const char * const pos)
+{
+    return pos == item || !g_ascii_isalnum(*(pos - 1));
+}
+
+// how well search matches item, both lowercased, FALSE if it is not a
+// subsequence, substrings beat scattered matches and word starts count
+static gboolean
+_fuzzy_score(const char * const item, const char * const search, int *score)
+{
+    int item_len = strlen(item);
+    int search_len = strlen(search);
+
+    const char *curr = strstr(item, search);
+    if (curr) {
+        *score = 1000 - (curr - item) - (item_len - search_len);
+        if (_word_start(item, curr)) {
+            *score += 500;
+        }
+        return TRUE;
+    }
+
+    *score = 0;
+    const char *last = NULL;
+    const char *wanted = search;
+    for (curr = item; *curr && *wanted; curr++) {
+        if (*curr != *wanted) {
+            continue;
+        }
+        if (_word_start(item, curr)) {
+            *score += 10;
+        }
+        if (last) {
+            *score += (curr == last + 1) ? 5 : -(curr - last - 1);
+        }
+        last = curr;
+        wanted++;
+    }
+
+    if (*wanted) {
+        return FALSE;
+    }
+
+    *score -= item_len - search_len;
+    return TRUE;
 }
@@ -43,6 +43,12 @@ typedef struct autocomplete_t *Autocomplete;
 // allocate new autocompleter with no items
 Autocomplete autocomplete_new(void);
 
+// as autocomplete_new, but ranks fuzzy matches when nothing matches the prefix
+Autocomplete autocomplete_new_fuzzy(void);
+
+// turn fuzzy matching on or off for all fuzzy autocompleters
+void autocomplete_set_fuzzy(gboolean enabled);
+
 // Remove all items from the autocompleter
 void autocomplete_clear(Autocomplete ac);
 
@@ -50,6 +56,9 @@ void autocomplete_clear(Autocomplete ac);
 void autocomplete_free(Autocomplete ac);
 
 void autocomplete_add(Autocomplete ac, const char *item);
+
+// add many items at once, sorting them once rather than inserting each
+void autocomplete_add_all(Autocomplete ac, GSList *items);
 void autocomplete_remove(Autocomplete ac, const char * const item);
 
 // find the next item prefixed with search string
@@ -69,5 +78,11 @@ char * autocomplete_param_no_with_func(const char * const input, char *command,
 
 void autocomplete_reset(Autocomplete ac);
 
+// reset every autocompleter, each catches up when next completed
+void autocomplete_reset_all(void);
+
+// changes on each autocomplete_reset_all, for state kept alongside an autocompleter
+guint autocomplete_generation(void);
+
 gboolean autocomplete_contains(Autocomplete ac, const char *value);
 #endif
@@ -0,0 +1,150 @@
+/*
+ * intern.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <assert.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "tools/intern.h"
+
+typedef struct intern_entry_t {
+    guint count;
+    guint size;
+    char str[];
+} InternEntry;
+
+// strings mapped to their entry, keys are the entry's own string
+static GHashTable *strings = NULL;
+static guint refs = 0;
+static gsize memory = 0;
+static gsize saved = 0;
+
+#define _intern_entry(str) ((InternEntry*)((str) - offsetof(InternEntry, str)))
+
+const char *
+intern_ref(const char * const str)
+{
+    if (str == NULL) {
+        return NULL;
+    }
+
+    if (strings == NULL) {
+        strings = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, free);
+    }
+
+    InternEntry *entry = g_hash_table_lookup(strings, str);
+    if (entry == NULL) {
+        guint size = strlen(str) + 1;
+        entry = malloc(sizeof(InternEntry) + size);
+        entry->count = 0;
+        entry->size = size;
+        memcpy(entry->str, str, size);
+        g_hash_table_insert(strings, entry->str, entry);
+        memory += sizeof(InternEntry) + size;
+    } else {
+        saved += entry->size;
+    }
+
+    entry->count++;
+    refs++;
+
+    return entry->str;
+}
+
+void
+intern_unref(const char * const str)
+{
+    if (str == NULL) {
+        return;
+    }
+
+    InternEntry *entry = _intern_entry(str);
+    assert(entry->count > 0);
+
+    entry->count--;
+    refs--;
+
+    if (entry->count > 0) {
+        saved -= entry->size;
+    } else {
+        memory -= sizeof(InternEntry) + entry->size;
+        g_hash_table_remove(strings, entry->str);
+    }
+}
+
+const char *
+intern_lookup(const char * const str)
+{
+    if (str == NULL || strings == NULL) {
+        return NULL;
+    }
+
+    InternEntry *entry = g_hash_table_lookup(strings, str);
+    if (entry == NULL) {
+        return NULL;
+    }
+
+    return entry->str;
+}
+
+guint
+intern_count(void)
+{
+    if (strings == NULL) {
+        return 0;
+    }
+
+    return g_hash_table_size(strings);
+}
+
+guint
+intern_refs(void)
+{
+    return refs;
+}
+
+gsize
+intern_memory(void)
+{
+    return memory;
+}
+
+gsize
+intern_saved(void)
+{
+    return saved;
+}
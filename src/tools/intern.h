@@ -0,0 +1,63 @@
+/*
+ * intern.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef INTERN_H
+#define INTERN_H
+
+#include <glib.h>
+
+// shared copies of strings such as jids, nicks and resources, equal
+// strings interned by different holders are the same pointer, so they
+// may be compared with ==, each copy is freed when its last holder
+// releases it, for use from the main thread only
+
+// the shared copy of str, counting a new holder, NULL for NULL
+const char * intern_ref(const char * const str);
+
+// release a holder of a string returned by intern_ref, NULL is ignored
+void intern_unref(const char * const str);
+
+// the shared copy of str without counting a holder, NULL when no one
+// holds it, for looking up tables keyed on interned strings
+const char * intern_lookup(const char * const str);
+
+// number of distinct strings, and of holders over all strings
+guint intern_count(void);
+guint intern_refs(void);
+
+// bytes used by the strings, and bytes separate copies would have added
+gsize intern_memory(void);
+gsize intern_saved(void);
+
+#endif
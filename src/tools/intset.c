@@ -0,0 +1,196 @@
+/*
+ * intset.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "tools/intset.h"
+
+struct int_set_t {
+    GArray *values;
+};
+
+#define _intset_at(set, i) g_array_index((set)->values, int, (i))
+
+IntSet
+intset_new(void)
+{
+    IntSet set = malloc(sizeof(struct int_set_t));
+    set->values = g_array_new(FALSE, FALSE, sizeof(int));
+
+    return set;
+}
+
+void
+intset_free(IntSet set)
+{
+    if (set) {
+        g_array_free(set->values, TRUE);
+        free(set);
+    }
+}
+
+void
+intset_clear(IntSet set)
+{
+    g_array_set_size(set->values, 0);
+}
+
+guint
+intset_index(IntSet set, int value)
+{
+    guint low = 0;
+    guint high = set->values->len;
+
+    while (low < high) {
+        guint mid = low + (high - low) / 2;
+        if (_intset_at(set, mid) < value) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
+gboolean
+intset_add(IntSet set, int value)
+{
+    guint index = intset_index(set, value);
+    if (index < set->values->len && _intset_at(set, index) == value) {
+        return FALSE;
+    }
+
+    g_array_insert_val(set->values, index, value);
+    return TRUE;
+}
+
+gboolean
+intset_remove(IntSet set, int value)
+{
+    guint index = intset_index(set, value);
+    if (index == set->values->len || _intset_at(set, index) != value) {
+        return FALSE;
+    }
+
+    g_array_remove_index(set->values, index);
+    return TRUE;
+}
+
+gboolean
+intset_contains(IntSet set, int value)
+{
+    guint index = intset_index(set, value);
+    return index < set->values->len && _intset_at(set, index) == value;
+}
+
+guint
+intset_size(IntSet set)
+{
+    return set->values->len;
+}
+
+int
+intset_nth(IntSet set, guint index)
+{
+    if (index >= set->values->len) {
+        return INTSET_NONE;
+    }
+
+    return _intset_at(set, index);
+}
+
+int
+intset_first(IntSet set)
+{
+    return intset_nth(set, 0);
+}
+
+int
+intset_last(IntSet set)
+{
+    if (set->values->len == 0) {
+        return INTSET_NONE;
+    }
+
+    return _intset_at(set, set->values->len - 1);
+}
+
+int
+intset_next(IntSet set, int value)
+{
+    guint index = intset_index(set, value);
+    if (index < set->values->len && _intset_at(set, index) == value) {
+        index++;
+    }
+
+    return intset_nth(set, index);
+}
+
+int
+intset_prev(IntSet set, int value)
+{
+    guint index = intset_index(set, value);
+    if (index == 0) {
+        return INTSET_NONE;
+    }
+
+    return _intset_at(set, index - 1);
+}
+
+int
+intset_first_gap(IntSet set, int from)
+{
+    guint start = intset_index(set, from);
+    if (start == set->values->len || _intset_at(set, start) != from) {
+        return from;
+    }
+
+    // values are distinct, so the run from start is unbroken up to the
+    // last position where the value still equals from plus its offset
+    guint low = start;
+    guint high = set->values->len - 1;
+    while (low < high) {
+        guint mid = low + (high - low + 1) / 2;
+        if (_intset_at(set, mid) == from + (int)(mid - start)) {
+            low = mid;
+        } else {
+            high = mid - 1;
+        }
+    }
+
+    return from + (int)(low - start) + 1;
+}
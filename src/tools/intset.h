@@ -0,0 +1,74 @@
+/*
+ * intset.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef INTSET_H
+#define INTSET_H
+
+#include <glib.h>
+
+// returned when there is no such value, sets only hold values >= 0
+#define INTSET_NONE -1
+
+// set of non negative integers kept in order, lookups and neighbours
+// are binary searches
+typedef struct int_set_t *IntSet;
+
+IntSet intset_new(void);
+void intset_free(IntSet set);
+void intset_clear(IntSet set);
+
+// FALSE when the value was already there, or not there to remove
+gboolean intset_add(IntSet set, int value);
+gboolean intset_remove(IntSet set, int value);
+gboolean intset_contains(IntSet set, int value);
+
+guint intset_size(IntSet set);
+
+// value at position index in order
+int intset_nth(IntSet set, guint index);
+
+// position of value, or of the first value after it when not in the set
+guint intset_index(IntSet set, int value);
+
+int intset_first(IntSet set);
+int intset_last(IntSet set);
+
+// closest value after or before value, which need not be in the set
+int intset_next(IntSet set, int value);
+int intset_prev(IntSet set, int value);
+
+// smallest value not in the set that is not less than from
+int intset_first_gap(IntSet set, int from);
+
+#endif
@@ -0,0 +1,319 @@
+/*
+ * linebreak.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#if defined(__SSE2__) && defined(__GNUC__)
+#include <emmintrin.h>
+#define LINEBREAK_SSE2
+#endif
+
+#include "tools/linebreak.h"
+
+// display widths of the basic multilingual plane, two bits per code point
+#define WIDTH_TABLE_SIZE 0x10000
+static guint8 *width_table = NULL;
+
+static int
+_compute_width(gunichar ch)
+{
+    if (g_unichar_iszerowidth(ch)) {
+        return 0;
+    } else if (g_unichar_iswide(ch)) {
+        return 2;
+    } else {
+        return 1;
+    }
+}
+
+static void
+_width_table_init(void)
+{
+    width_table = calloc(WIDTH_TABLE_SIZE / 4, 1);
+
+    gunichar ch;
+    for (ch = 0; ch < WIDTH_TABLE_SIZE; ch++) {
+        int width = ch < 0x80 ? 1 : _compute_width(ch);
+        width_table[ch >> 2] |= width << ((ch & 3) * 2);
+    }
+}
+
+int
+linebreak_char_width(gunichar ch)
+{
+    if (ch < 0x80) {
+        return 1;
+    }
+
+    if (ch < WIDTH_TABLE_SIZE) {
+        if (width_table == NULL) {
+            _width_table_init();
+        }
+        return (width_table[ch >> 2] >> ((ch & 3) * 2)) & 3;
+    }
+
+    return _compute_width(ch);
+}
+
+// index of the first space, newline or non ASCII byte at or after i
+static int
+_ascii_run_end(const char * const str, int i, int len)
+{
+#ifdef LINEBREAK_SSE2
+    const __m128i spaces = _mm_set1_epi8(' ');
+    const __m128i newlines = _mm_set1_epi8('\n');
+
+    while (i + 16 <= len) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(str + i));
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(chunk, spaces), _mm_cmpeq_epi8(chunk, newlines));
+
+        // non ASCII bytes already have the top bit set
+        int mask = _mm_movemask_epi8(_mm_or_si128(special, chunk));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+        i += 16;
+    }
+#endif
+
+    while (i < len) {
+        unsigned char c = str[i];
+        if (c == ' ' || c == '\n' || c >= 0x80) {
+            break;
+        }
+        i++;
+    }
+
+    return i;
+}
+
+// index of the first non ASCII byte at or after i
+static int
+_ascii_end(const char * const str, int i, int len)
+{
+#ifdef LINEBREAK_SSE2
+    while (i + 16 <= len) {
+        int mask = _mm_movemask_epi8(_mm_loadu_si128((const __m128i*)(str + i)));
+        if (mask != 0) {
+            return i + __builtin_ctz(mask);
+        }
+        i += 16;
+    }
+#endif
+
+    while (i < len && (unsigned char)str[i] < 0x80) {
+        i++;
+    }
+
+    return i;
+}
+
+// width of the character at i, returns the index of the next character
+static int
+_next_char(const char * const str, int i, int len, int *width)
+{
+    unsigned char c = str[i];
+    if (c < 0x80) {
+        *width = 1;
+        return i + 1;
+    }
+
+    gunichar ch = g_utf8_get_char_validated(str + i, len - i);
+    if (ch == (gunichar)-1 || ch == (gunichar)-2) {
+        *width = 1;
+        return i + 1;
+    }
+
+    *width = linebreak_char_width(ch);
+    return i + g_utf8_skip[c];
+}
+
+// end of the word starting at i, its display width is stored in width
+static int
+_word_end(const char * const str, int i, int len, int *width)
+{
+    *width = 0;
+
+    while (i < len) {
+        int run_end = _ascii_run_end(str, i, len);
+        *width += run_end - i;
+        i = run_end;
+
+        if (i == len || str[i] == ' ' || str[i] == '\n') {
+            break;
+        }
+
+        int char_width = 0;
+        i = _next_char(str, i, len, &char_width);
+        *width += char_width;
+    }
+
+    return i;
+}
+
+// cursor column after printing a character, a character that does not fit
+// moves to the next row, and the cursor moves to the next row once the
+// last column is written
+static int
+_advance(int x, int char_width, int width)
+{
+    if (x + char_width > width) {
+        x = 0;
+    }
+    x += char_width;
+
+    return x >= width ? 0 : x;
+}
+
+static int
+_advance_span(const char * const str, int start, int end, int x, int width)
+{
+    int i = start;
+    while (i < end) {
+        int char_width = 0;
+        i = _next_char(str, i, end, &char_width);
+        x = _advance(x, char_width, width);
+    }
+
+    return x;
+}
+
+static void
+_add_break(GArray *breaks, int offset, break_type_t type)
+{
+    LineBreak brk;
+    brk.offset = offset;
+    brk.type = type;
+    g_array_append_val(breaks, brk);
+}
+
+int
+linebreak_display_len(const char * const str)
+{
+    if (!str) {
+        return 0;
+    }
+
+    int len = strlen(str);
+    int result = 0;
+    int i = 0;
+    while (i < len) {
+        int run_end = _ascii_end(str, i, len);
+        result += run_end - i;
+        i = run_end;
+
+        if (i < len) {
+            int char_width = 0;
+            i = _next_char(str, i, len, &char_width);
+            result += char_width;
+        }
+    }
+
+    return result;
+}
+
+// words are moved to the next row when they do not fit, words wider than
+// a row are broken wherever the row ends
+LineLayout*
+linebreak_layout(const char * const message, int startx, int width, int indent)
+{
+    GArray *breaks = g_array_new(FALSE, FALSE, sizeof(LineBreak));
+    int len = strlen(message);
+    int x = startx;
+    int i = 0;
+
+    while (i < len) {
+        if (message[i] == ' ') {
+            x = _advance(x, 1, width);
+            i++;
+        } else if (message[i] == '\n') {
+            _add_break(breaks, i, BREAK_NEWLINE);
+            x = indent;
+            i++;
+        } else {
+            int word_width = 0;
+            int end = _word_end(message, i, len, &word_width);
+
+            // word larger than line
+            if (word_width > width - indent) {
+                while (i < end) {
+                    if (x < indent) {
+                        _add_break(breaks, i, BREAK_INDENT);
+                        x = (x + indent) % width;
+                    }
+                    int char_width = 0;
+                    i = _next_char(message, i, end, &char_width);
+                    x = _advance(x, char_width, width);
+                }
+            } else {
+                if (x + word_width > width) {
+                    _add_break(breaks, i, BREAK_WRAP);
+                    x = indent;
+                }
+                if (x < indent) {
+                    _add_break(breaks, i, BREAK_INDENT);
+                    x = (x + indent) % width;
+                }
+                if (x + word_width < width) {
+                    x += word_width;
+                } else {
+                    x = _advance_span(message, i, end, x, width);
+                }
+                i = end;
+            }
+        }
+    }
+
+    LineLayout *layout = malloc(sizeof(LineLayout));
+    layout->width = width;
+    layout->startx = startx;
+    layout->indent = indent;
+    layout->count = breaks->len;
+    layout->breaks = (LineBreak*)g_array_free(breaks, FALSE);
+
+    return layout;
+}
+
+void
+linebreak_free(LineLayout *layout)
+{
+    if (layout) {
+        free(layout->breaks);
+        free(layout);
+    }
+}
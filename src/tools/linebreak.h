@@ -0,0 +1,73 @@
+/*
+ * linebreak.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+
+#ifndef LINEBREAK_H
+#define LINEBREAK_H
+
+#include <glib.h>
+
+typedef enum {
+    BREAK_NEWLINE,
+    BREAK_WRAP,
+    BREAK_INDENT
+} break_type_t;
+
+typedef struct line_break_t {
+    int offset;
+    break_type_t type;
+} LineBreak;
+
+// line breaks of a wrapped message, valid for the width, start column
+// and indent it was computed with
+typedef struct line_layout_t {
+    int width;
+    int startx;
+    int indent;
+    int count;
+    LineBreak *breaks;
+} LineLayout;
+
+// number of terminal columns used to display a character
+int linebreak_char_width(gunichar ch);
+
+// number of terminal columns used to display a UTF-8 string
+int linebreak_display_len(const char * const str);
+
+// compute where message breaks when printed from column startx in a window
+// width columns wide, continuation lines are indented by indent columns
+LineLayout* linebreak_layout(const char * const message, int startx, int width, int indent);
+
+void linebreak_free(LineLayout *layout);
+#endif
@@ -0,0 +1,122 @@
+/*
+ * spscqueue.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "tools/spscqueue.h"
+
+// keep the indices written by each side on their own cache line
+#define CACHE_LINE 64
+
+struct spsc_queue_t {
+    guint mask;
+    void **items;
+    char pad0[CACHE_LINE];
+    // next slot to pop, only written by the consumer
+    volatile gint head;
+    char pad1[CACHE_LINE];
+    // next slot to push, only written by the producer
+    volatile gint tail;
+    char pad2[CACHE_LINE];
+};
+
+SpscQueue
+spscqueue_new(guint capacity)
+{
+    // one slot is always left empty to tell a full queue from an empty one
+    guint size = 2;
+    while (size < capacity + 1) {
+        size <<= 1;
+    }
+
+    SpscQueue queue = malloc(sizeof(struct spsc_queue_t));
+    queue->mask = size - 1;
+    queue->items = calloc(size, sizeof(void *));
+    queue->head = 0;
+    queue->tail = 0;
+
+    return queue;
+}
+
+void
+spscqueue_free(SpscQueue queue)
+{
+    if (queue != NULL) {
+        free(queue->items);
+        free(queue);
+    }
+}
+
+gboolean
+spscqueue_push(SpscQueue queue, void *item)
+{
+    guint tail = (guint)queue->tail;
+    guint next = (tail + 1) & queue->mask;
+
+    if (next == (guint)g_atomic_int_get(&queue->head)) {
+        return FALSE;
+    }
+
+    queue->items[tail] = item;
+
+    // publishes the item to the consumer
+    g_atomic_int_set(&queue->tail, (gint)next);
+
+    return TRUE;
+}
+
+void *
+spscqueue_pop(SpscQueue queue)
+{
+    guint head = (guint)queue->head;
+
+    if (head == (guint)g_atomic_int_get(&queue->tail)) {
+        return NULL;
+    }
+
+    void *item = queue->items[head];
+
+    // hands the slot back to the producer
+    g_atomic_int_set(&queue->head, (gint)((head + 1) & queue->mask));
+
+    return item;
+}
+
+gboolean
+spscqueue_is_empty(SpscQueue queue)
+{
+    return (guint)queue->head == (guint)g_atomic_int_get(&queue->tail);
+}
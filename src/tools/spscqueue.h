@@ -0,0 +1,59 @@
+/*
+ * spscqueue.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include <glib.h>
+
+// bounded lock-free queue of pointers between exactly one producer thread
+// and exactly one consumer thread
+typedef struct spsc_queue_t *SpscQueue;
+
+// create a queue holding at least capacity items
+SpscQueue spscqueue_new(guint capacity);
+
+// free the queue, items still queued are not freed
+void spscqueue_free(SpscQueue queue);
+
+// producer only, FALSE when the queue is full
+gboolean spscqueue_push(SpscQueue queue, void *item);
+
+// consumer only, NULL when the queue is empty
+void * spscqueue_pop(SpscQueue queue);
+
+// consumer only
+gboolean spscqueue_is_empty(SpscQueue queue);
+
+#endif
@@ -0,0 +1,414 @@
+/*
+ * timerwheel.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <glib.h>
+
+#include "tools/timerwheel.h"
+
+// a tick is one millisecond, each level has 64 slots and one of its slots
+// spans a whole turn of the level below
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS 5
+
+// about 12 days, timers further out wait in the last level and are placed
+// again when it cascades
+#define WHEEL_RANGE ((gint64)1 << (WHEEL_BITS * WHEEL_LEVELS))
+
+// level of timers taken from the wheel to be run
+#define LEVEL_EXPIRED -1
+
+struct prof_timer_t {
+    char *name;
+    gint64 due;
+    timer_func func;
+    void *data;
+    gboolean pending;
+    gboolean firing;
+    gboolean reset;
+    gboolean removed;
+    int level;
+    int slot;
+    struct prof_timer_t *prev;
+    struct prof_timer_t *next;
+};
+
+struct timer_wheel_t {
+    timer_clock_func clock;
+    // next tick to be processed
+    gint64 now;
+    struct prof_timer_t *slots[WHEEL_LEVELS][WHEEL_SIZE];
+    int counts[WHEEL_LEVELS];
+    int pending;
+    struct prof_timer_t *expired;
+    GList *timers;
+};
+
+static void _link(TimerWheel wheel, ProfTimer timer);
+static void _unlink(TimerWheel wheel, ProfTimer timer);
+static void _schedule(TimerWheel wheel, ProfTimer timer, gint delay);
+static void _cascade(TimerWheel wheel, int level, int slot);
+static void _process_tick(TimerWheel wheel);
+static void _fire(TimerWheel wheel, ProfTimer timer);
+static void _timer_free(ProfTimer timer);
+static gint _cmp_due(gconstpointer a, gconstpointer b);
+
+TimerWheel
+timerwheel_new(timer_clock_func clock)
+{
+    TimerWheel wheel = malloc(sizeof(struct timer_wheel_t));
+    memset(wheel, 0, sizeof(struct timer_wheel_t));
+    wheel->clock = clock;
+    wheel->now = clock();
+
+    return wheel;
+}
+
+void
+timerwheel_free(TimerWheel wheel)
+{
+    if (wheel == NULL) {
+        return;
+    }
+
+    g_list_free_full(wheel->timers, (GDestroyNotify)_timer_free);
+    free(wheel);
+}
+
+ProfTimer
+timerwheel_add(TimerWheel wheel, const char * const name, gint delay,
+    timer_func func, void *data)
+{
+    ProfTimer timer = malloc(sizeof(struct prof_timer_t));
+    memset(timer, 0, sizeof(struct prof_timer_t));
+    timer->name = strdup(name);
+    timer->func = func;
+    timer->data = data;
+
+    wheel->timers = g_list_append(wheel->timers, timer);
+    _schedule(wheel, timer, delay);
+
+    return timer;
+}
+
+void
+timerwheel_reset(TimerWheel wheel, ProfTimer timer, gint delay)
+{
+    if (timer->pending) {
+        _unlink(wheel, timer);
+    }
+    if (timer->firing) {
+        timer->reset = TRUE;
+    }
+    _schedule(wheel, timer, delay);
+}
+
+void
+timerwheel_remove(TimerWheel wheel, ProfTimer timer)
+{
+    if (timer->pending) {
+        _unlink(wheel, timer);
+    }
+    wheel->timers = g_list_remove(wheel->timers, timer);
+
+    // freed once its function returns
+    if (timer->firing) {
+        timer->removed = TRUE;
+    } else {
+        _timer_free(timer);
+    }
+}
+
+void
+timerwheel_run(TimerWheel wheel)
+{
+    gint64 target = wheel->clock();
+
+    while (wheel->now <= target) {
+        if (wheel->pending == 0) {
+            wheel->now = target + 1;
+            break;
+        }
+
+        // skip ahead while the lowest levels are empty, nothing can fire
+        // before the next cascade of the first level holding timers
+        int level = 0;
+        while (wheel->counts[level] == 0) {
+            level++;
+        }
+        if (level > 0) {
+            gint64 span = (gint64)1 << (WHEEL_BITS * level);
+            gint64 next = (wheel->now + span - 1) & ~(span - 1);
+            if (next > target) {
+                wheel->now = target + 1;
+                break;
+            }
+            wheel->now = next;
+        }
+
+        _process_tick(wheel);
+    }
+}
+
+gint
+timerwheel_next_timeout(TimerWheel wheel)
+{
+    if (wheel->pending == 0) {
+        return -1;
+    }
+
+    // within a level the first occupied slot holds the earliest timers
+    gint64 next = G_MAXINT64;
+    int level;
+    for (level = 0; level < WHEEL_LEVELS; level++) {
+        if (wheel->counts[level] == 0) {
+            continue;
+        }
+
+        int shift = WHEEL_BITS * level;
+        gint64 block = (wheel->now + ((gint64)1 << shift) - 1) >> shift;
+        int i;
+        for (i = 0; i < WHEEL_SIZE; i++, block++) {
+            ProfTimer timer = wheel->slots[level][block & WHEEL_MASK];
+            if (timer != NULL) {
+                while (timer != NULL) {
+                    if (timer->due < next) {
+                        next = timer->due;
+                    }
+                    timer = timer->next;
+                }
+                break;
+            }
+        }
+    }
+
+    gint64 remaining = next - wheel->clock();
+    if (remaining < 0) {
+        return 0;
+    } else if (remaining > G_MAXINT) {
+        return G_MAXINT;
+    } else {
+        return (gint)remaining;
+    }
+}
+
+GList *
+timerwheel_timers(TimerWheel wheel)
+{
+    return g_list_sort(g_list_copy(wheel->timers), _cmp_due);
+}
+
+const char *
+timerwheel_timer_name(ProfTimer timer)
+{
+    return timer->name;
+}
+
+gboolean
+timerwheel_timer_pending(ProfTimer timer)
+{
+    return timer->pending;
+}
+
+gint64
+timerwheel_timer_remaining(TimerWheel wheel, ProfTimer timer)
+{
+    if (!timer->pending) {
+        return -1;
+    }
+
+    gint64 remaining = timer->due - wheel->clock();
+    if (remaining < 0) {
+        return 0;
+    } else {
+        return remaining;
+    }
+}
+
+static void
+_schedule(TimerWheel wheel, ProfTimer timer, gint delay)
+{
+    if (delay < 0) {
+        return;
+    }
+
+    timer->due = wheel->clock() + delay;
+    _link(wheel, timer);
+}
+
+static void
+_link(TimerWheel wheel, ProfTimer timer)
+{
+    gint64 expires = timer->due;
+    gint64 delta = expires - wheel->now;
+    if (delta < 0) {
+        expires = wheel->now;
+        delta = 0;
+    } else if (delta >= WHEEL_RANGE) {
+        expires = wheel->now + WHEEL_RANGE - 1;
+        delta = WHEEL_RANGE - 1;
+    }
+
+    int level = 0;
+    while (delta >= ((gint64)1 << (WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+
+    timer->level = level;
+    timer->slot = (expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    timer->prev = NULL;
+    timer->next = wheel->slots[level][timer->slot];
+    if (timer->next != NULL) {
+        timer->next->prev = timer;
+    }
+    wheel->slots[level][timer->slot] = timer;
+    wheel->counts[level]++;
+    wheel->pending++;
+    timer->pending = TRUE;
+}
+
+static void
+_unlink(TimerWheel wheel, ProfTimer timer)
+{
+    if (timer->prev != NULL) {
+        timer->prev->next = timer->next;
+    } else if (timer->level == LEVEL_EXPIRED) {
+        wheel->expired = timer->next;
+    } else {
+        wheel->slots[timer->level][timer->slot] = timer->next;
+    }
+    if (timer->next != NULL) {
+        timer->next->prev = timer->prev;
+    }
+
+    if (timer->level != LEVEL_EXPIRED) {
+        wheel->counts[timer->level]--;
+    }
+    wheel->pending--;
+    timer->pending = FALSE;
+    timer->prev = NULL;
+    timer->next = NULL;
+}
+
+static void
+_cascade(TimerWheel wheel, int level, int slot)
+{
+    ProfTimer timer = wheel->slots[level][slot];
+    wheel->slots[level][slot] = NULL;
+
+    while (timer != NULL) {
+        ProfTimer next = timer->next;
+        wheel->counts[level]--;
+        wheel->pending--;
+        _link(wheel, timer);
+        timer = next;
+    }
+}
+
+static void
+_process_tick(TimerWheel wheel)
+{
+    gint64 tick = wheel->now;
+
+    int level;
+    for (level = 1; level < WHEEL_LEVELS; level++) {
+        int shift = WHEEL_BITS * level;
+        if ((tick & (((gint64)1 << shift) - 1)) != 0) {
+            break;
+        }
+        _cascade(wheel, level, (tick >> shift) & WHEEL_MASK);
+    }
+
+    // take the due timers out first, their functions may change the wheel
+    int slot = tick & WHEEL_MASK;
+    ProfTimer timer = wheel->slots[0][slot];
+    wheel->slots[0][slot] = NULL;
+    wheel->expired = timer;
+    while (timer != NULL) {
+        timer->level = LEVEL_EXPIRED;
+        wheel->counts[0]--;
+        timer = timer->next;
+    }
+    wheel->now = tick + 1;
+
+    while (wheel->expired != NULL) {
+        _fire(wheel, wheel->expired);
+    }
+}
+
+static void
+_fire(TimerWheel wheel, ProfTimer timer)
+{
+    _unlink(wheel, timer);
+
+    timer->firing = TRUE;
+    timer->reset = FALSE;
+    gint delay = timer->func(timer->data);
+    timer->firing = FALSE;
+
+    if (timer->removed) {
+        _timer_free(timer);
+    } else if (!timer->reset) {
+        _schedule(wheel, timer, delay);
+    }
+}
+
+static void
+_timer_free(ProfTimer timer)
+{
+    free(timer->name);
+    free(timer);
+}
+
+static gint
+_cmp_due(gconstpointer a, gconstpointer b)
+{
+    ProfTimer timer_a = (ProfTimer)a;
+    ProfTimer timer_b = (ProfTimer)b;
+
+    if (timer_a->pending != timer_b->pending) {
+        return timer_a->pending ? -1 : 1;
+    }
+    if (timer_a->due < timer_b->due) {
+        return -1;
+    } else if (timer_a->due > timer_b->due) {
+        return 1;
+    } else {
+        return 0;
+    }
+}
@@ -0,0 +1,83 @@
+/*
+ * timerwheel.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <glib.h>
+
+// returned by a timer function to leave the timer stopped
+#define TIMER_STOP -1
+
+// called when a timer is due, returns milliseconds until it should run again
+typedef gint(*timer_func)(void *data);
+
+// source of the current time in milliseconds
+typedef gint64(*timer_clock_func)(void);
+
+typedef struct timer_wheel_t *TimerWheel;
+typedef struct prof_timer_t *ProfTimer;
+
+// create a wheel reading the time from clock
+TimerWheel timerwheel_new(timer_clock_func clock);
+
+// free the wheel and every timer added to it
+void timerwheel_free(TimerWheel wheel);
+
+// add a timer due in delay milliseconds, or stopped when delay is TIMER_STOP
+ProfTimer timerwheel_add(TimerWheel wheel, const char * const name, gint delay,
+    timer_func func, void *data);
+
+// make the timer due in delay milliseconds, or stop it when delay is TIMER_STOP
+void timerwheel_reset(TimerWheel wheel, ProfTimer timer, gint delay);
+
+// remove and free the timer, safe to call from its own timer function
+void timerwheel_remove(TimerWheel wheel, ProfTimer timer);
+
+// run every timer that is due
+void timerwheel_run(TimerWheel wheel);
+
+// milliseconds until the wheel next needs to run, -1 when nothing is pending
+gint timerwheel_next_timeout(TimerWheel wheel);
+
+// all timers ordered by when they are due, stopped timers last
+GList * timerwheel_timers(TimerWheel wheel);
+
+const char * timerwheel_timer_name(ProfTimer timer);
+gboolean timerwheel_timer_pending(ProfTimer timer);
+
+// milliseconds until the timer is due, -1 when stopped
+gint64 timerwheel_timer_remaining(TimerWheel wheel, ProfTimer timer);
+
+#endif
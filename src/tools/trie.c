@@ -0,0 +1,172 @@
+/*
+ * trie.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <stdlib.h>
+
+#include <glib.h>
+
+#include "tools/trie.h"
+
+// children are a list of siblings, a key's value sits on the node for
+// its last character
+typedef struct trie_node_t {
+    char c;
+    gpointer value;
+    struct trie_node_t *child;
+    struct trie_node_t *next;
+} TrieNode;
+
+struct trie_t {
+    TrieNode root;
+    GDestroyNotify value_free;
+};
+
+static TrieNode * _child(TrieNode *node, char c);
+static void _free_children(Trie trie, TrieNode *node);
+
+Trie
+trie_new(GDestroyNotify value_free)
+{
+    Trie trie = malloc(sizeof(struct trie_t));
+    trie->root.c = '\0';
+    trie->root.value = NULL;
+    trie->root.child = NULL;
+    trie->root.next = NULL;
+    trie->value_free = value_free;
+
+    return trie;
+}
+
+void
+trie_free(Trie trie)
+{
+    if (trie) {
+        _free_children(trie, &trie->root);
+        if (trie->root.value && trie->value_free) {
+            trie->value_free(trie->root.value);
+        }
+        free(trie);
+    }
+}
+
+void
+trie_insert(Trie trie, const char * const key, gpointer value)
+{
+    TrieNode *node = &trie->root;
+    const char *curr = key;
+    while (*curr) {
+        TrieNode *child = _child(node, *curr);
+        if (!child) {
+            child = malloc(sizeof(TrieNode));
+            child->c = *curr;
+            child->value = NULL;
+            child->child = NULL;
+            child->next = node->child;
+            node->child = child;
+        }
+        node = child;
+        curr++;
+    }
+
+    if (node->value && node->value != value && trie->value_free) {
+        trie->value_free(node->value);
+    }
+    node->value = value;
+}
+
+gpointer
+trie_lookup(Trie trie, const char * const key)
+{
+    TrieNode *node = &trie->root;
+    const char *curr = key;
+    while (*curr && node) {
+        node = _child(node, *curr);
+        curr++;
+    }
+
+    return node ? node->value : NULL;
+}
+
+gpointer
+trie_lookup_prefix(Trie trie, const char * const str, int *len)
+{
+    gpointer found = trie->root.value;
+    int found_len = 0;
+
+    TrieNode *node = &trie->root;
+    const char *curr = str;
+    while (*curr) {
+        node = _child(node, *curr);
+        if (!node) {
+            break;
+        }
+        curr++;
+        if (node->value) {
+            found = node->value;
+            found_len = curr - str;
+        }
+    }
+
+    if (len) {
+        *len = found_len;
+    }
+
+    return found;
+}
+
+static TrieNode *
+_child(TrieNode *node, char c)
+{
+    TrieNode *child = node->child;
+    while (child && child->c != c) {
+        child = child->next;
+    }
+
+    return child;
+}
+
+static void
+_free_children(Trie trie, TrieNode *node)
+{
+    TrieNode *child = node->child;
+    while (child) {
+        TrieNode *next = child->next;
+        _free_children(trie, child);
+        if (child->value && trie->value_free) {
+            trie->value_free(child->value);
+        }
+        free(child);
+        child = next;
+    }
+}
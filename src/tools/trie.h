@@ -0,0 +1,59 @@
+/*
+ * trie.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef TRIE_H
+#define TRIE_H
+
+#include <glib.h>
+
+// strings mapped to values, looked up by walking a string once, for
+// small sets of keys such as command names
+typedef struct trie_t *Trie;
+
+// value_free is called on values replaced or left when the trie is
+// freed, NULL if the caller owns them
+Trie trie_new(GDestroyNotify value_free);
+void trie_free(Trie trie);
+
+// map key to value, replacing any earlier value, value must not be NULL
+void trie_insert(Trie trie, const char * const key, gpointer value);
+
+// value for exactly key, NULL if none
+gpointer trie_lookup(Trie trie, const char * const key);
+
+// value for the longest key that str starts with, NULL if none, its
+// length is stored in len when not NULL
+gpointer trie_lookup_prefix(Trie trie, const char * const str, int *len);
+
+#endif
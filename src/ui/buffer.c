@@ -48,69 +48,240 @@
 
 #include "ui/window.h"
 #include "ui/buffer.h"
+#include "tools/intern.h"
 
-#define BUFF_SIZE 1200
+#define BUFF_INITIAL_ALLOC 32
+#define BUFF_CHUNK_SIZE 4096
 
+// text is copied into chunks in push order, and entries leave oldest first,
+// so the oldest chunk holds the text of the oldest entry and is freed once
+// the last of its entries has gone
+typedef struct prof_buff_chunk_t {
+    gsize size;
+    gsize used;
+    int live;
+    char text[];
+} ProfBuffChunk;
+
+// fixed capacity ring buffer, entries are stored oldest first starting
+// at index start, the entries array grows on demand until it reaches capacity,
+// the oldest cleared entries are kept but no longer shown
 struct prof_buff_t {
-    GSList *entries;
+    ProfBuffEntry *entries;
+    int capacity;
+    int allocated;
+    int start;
+    int size;
+    int cleared;
+    GQueue *chunks;
+    ProfBuffChunk *spare;
 };
 
-static void _free_entry(ProfBuffEntry *entry);
+static void _free_entry(ProfBuff buffer, ProfBuffEntry *entry);
+static const char * _copy_text(ProfBuff buffer, const char * const text);
+static void _release_text(ProfBuff buffer);
 
 ProfBuff
 buffer_create()
 {
+    return buffer_create_with_capacity(BUFF_SIZE);
+}
+
+ProfBuff
+buffer_create_with_capacity(int capacity)
+{
+    if (capacity < 1) {
+        capacity = BUFF_SIZE;
+    }
+
     ProfBuff new_buff = malloc(sizeof(struct prof_buff_t));
     new_buff->entries = NULL;
+    new_buff->capacity = capacity;
+    new_buff->allocated = 0;
+    new_buff->start = 0;
+    new_buff->size = 0;
+    new_buff->cleared = 0;
+    new_buff->chunks = g_queue_new();
+    new_buff->spare = NULL;
     return new_buff;
 }
 
 int
 buffer_size(ProfBuff buffer)
 {
-    return g_slist_length(buffer->entries);
+    return buffer->size;
+}
+
+int
+buffer_capacity(ProfBuff buffer)
+{
+    return buffer->capacity;
+}
+
+void
+buffer_mark_cleared(ProfBuff buffer)
+{
+    buffer->cleared = buffer->size;
+}
+
+int
+buffer_cleared(ProfBuff buffer)
+{
+    return buffer->cleared;
+}
+
+// bytes held for entries and their text, not counting the interned sender
+// names or the wrap layouts which are kept for drawing
+gsize
+buffer_memory(ProfBuff buffer)
+{
+    gsize result = sizeof(struct prof_buff_t);
+    result += buffer->allocated * sizeof(ProfBuffEntry);
+
+    GList *curr = buffer->chunks->head;
+    while (curr != NULL) {
+        ProfBuffChunk *chunk = curr->data;
+        result += sizeof(ProfBuffChunk) + chunk->size;
+        curr = g_list_next(curr);
+    }
+    if (buffer->spare != NULL) {
+        result += sizeof(ProfBuffChunk) + buffer->spare->size;
+    }
+
+    return result;
 }
 
 void
 buffer_free(ProfBuff buffer)
 {
-    g_slist_free_full(buffer->entries, (GDestroyNotify)_free_entry);
+    int i;
+    for (i = 0; i < buffer->size; i++) {
+        ProfBuffEntry *entry = &buffer->entries[(buffer->start + i) % buffer->capacity];
+        linebreak_free(entry->wrap);
+        intern_unref(entry->from);
+    }
+    free(buffer->entries);
+    g_queue_free_full(buffer->chunks, free);
+    free(buffer->spare);
     free(buffer);
     buffer = NULL;
 }
 
 void
-buffer_push(ProfBuff buffer, const char show_char, GDateTime *time,
+buffer_push(ProfBuff buffer, const char show_char, gint64 time,
     int flags, theme_item_t theme_item, const char * const from, const char * const message)
 {
-    ProfBuffEntry *e = malloc(sizeof(struct prof_buff_entry_t));
+    ProfBuffEntry *e;
+
+    // full, overwrite the oldest entry
+    if (buffer->size == buffer->capacity) {
+        e = &buffer->entries[buffer->start];
+        _free_entry(buffer, e);
+        buffer->start = (buffer->start + 1) % buffer->capacity;
+        if (buffer->cleared > 0) {
+            buffer->cleared--;
+        }
+
+    } else {
+        // not yet wrapped, so start is always 0 and growing is a plain realloc
+        if (buffer->size == buffer->allocated) {
+            int new_alloc = buffer->allocated == 0 ? BUFF_INITIAL_ALLOC : buffer->allocated * 2;
+            if (new_alloc > buffer->capacity) {
+                new_alloc = buffer->capacity;
+            }
+            buffer->entries = realloc(buffer->entries, new_alloc * sizeof(ProfBuffEntry));
+            buffer->allocated = new_alloc;
+        }
+
+        e = &buffer->entries[buffer->size];
+        buffer->size++;
+    }
+
     e->show_char = show_char;
     e->flags = flags;
     e->theme_item = theme_item;
     e->time = time;
-    e->from = strdup(from);
-    e->message = strdup(message);
+    e->from = intern_ref(from);
+    e->message = _copy_text(buffer, message);
+    e->wrap = NULL;
+}
+
+ProfBuffEntry*
+buffer_yield_entry(ProfBuff buffer, int entry)
+{
+    assert(entry >= 0 && entry < buffer->size);
+    return &buffer->entries[(buffer->start + entry) % buffer->capacity];
+}
 
-    if (g_slist_length(buffer->entries) == BUFF_SIZE) {
-        _free_entry(buffer->entries->data);
-        buffer->entries = g_slist_delete_link(buffer->entries, buffer->entries);
+LineLayout*
+buffer_entry_wrap(ProfBuffEntry *entry, const char * const message, int startx, int width, int indent)
+{
+    LineLayout *wrap = entry->wrap;
+    if (wrap == NULL || wrap->width != width || wrap->startx != startx || wrap->indent != indent) {
+        linebreak_free(wrap);
+        wrap = linebreak_layout(message, startx, width, indent);
+        entry->wrap = wrap;
     }
 
-    buffer->entries = g_slist_append(buffer->entries, e);
+    return wrap;
 }
 
-ProfBuffEntry*
-buffer_yield_entry(ProfBuff buffer, int entry)
+static void
+_free_entry(ProfBuff buffer, ProfBuffEntry *entry)
 {
-    GSList *node = g_slist_nth(buffer->entries, entry);
-    return node->data;
+    linebreak_free(entry->wrap);
+    _release_text(buffer);
+    intern_unref(entry->from);
 }
 
+static const char *
+_copy_text(ProfBuff buffer, const char * const text)
+{
+    gsize len = strlen(text) + 1;
+    ProfBuffChunk *chunk = g_queue_peek_tail(buffer->chunks);
+
+    if (chunk == NULL || chunk->size - chunk->used < len) {
+        if (len <= BUFF_CHUNK_SIZE && buffer->spare != NULL) {
+            chunk = buffer->spare;
+            buffer->spare = NULL;
+        } else {
+            gsize size = len > BUFF_CHUNK_SIZE ? len : BUFF_CHUNK_SIZE;
+            chunk = malloc(sizeof(ProfBuffChunk) + size);
+            chunk->size = size;
+        }
+        chunk->used = 0;
+        chunk->live = 0;
+        g_queue_push_tail(buffer->chunks, chunk);
+    }
+
+    char *result = chunk->text + chunk->used;
+    memcpy(result, text, len);
+    chunk->used += len;
+    chunk->live++;
+
+    return result;
+}
+
+// release the text of the oldest entry, keeping one emptied chunk to
+// save allocating a new one when the buffer is full and keeps turning over
 static void
-_free_entry(ProfBuffEntry *entry)
+_release_text(ProfBuff buffer)
 {
-    free(entry->message);
-    free(entry->from);
-    g_date_time_unref(entry->time);
-    free(entry);
-}
\ No newline at end of file
+    ProfBuffChunk *chunk = g_queue_peek_head(buffer->chunks);
+    chunk->live--;
+    if (chunk->live > 0) {
+        return;
+    }
+
+    if (g_queue_get_length(buffer->chunks) == 1) {
+        chunk->used = 0;
+        return;
+    }
+
+    g_queue_pop_head(buffer->chunks);
+    if (buffer->spare == NULL && chunk->size == BUFF_CHUNK_SIZE) {
+        buffer->spare = chunk;
+    } else {
+        free(chunk);
+    }
+}
@@ -37,23 +37,39 @@
 
 #include "config.h"
 #include "config/theme.h"
+#include "tools/linebreak.h"
 
 #include <glib.h>
 
+#define BUFF_SIZE 1200
+
+// from is interned and message points into text owned by the buffer, time
+// is in microseconds since the epoch
 typedef struct prof_buff_entry_t {
-    char show_char;
-    GDateTime *time;
-    int flags;
+    gint64 time;
+    const char *from;
+    const char *message;
+    LineLayout *wrap;
     theme_item_t theme_item;
-    char *from;
-    char *message;
+    int flags;
+    char show_char;
 } ProfBuffEntry;
 
 typedef struct prof_buff_t *ProfBuff;
 
 ProfBuff buffer_create();
+ProfBuff buffer_create_with_capacity(int capacity);
 void buffer_free(ProfBuff buffer);
-void buffer_push(ProfBuff buffer, const char show_char, GDateTime *time, int flags, theme_item_t theme_item, const char * const from, const char * const message);
+void buffer_push(ProfBuff buffer, const char show_char, gint64 time, int flags, theme_item_t theme_item, const char * const from, const char * const message);
 int buffer_size(ProfBuff buffer);
+int buffer_capacity(ProfBuff buffer);
+// hide every entry pushed so far, buffer_cleared is the index of the first
+// entry still shown and drops as the oldest entries are overwritten
+void buffer_mark_cleared(ProfBuff buffer);
+int buffer_cleared(ProfBuff buffer);
 ProfBuffEntry* buffer_yield_entry(ProfBuff buffer, int entry);
+// layout of the wrapped part of the entry's message, reused while the width,
+// start column and indent are unchanged and computed again otherwise
+LineLayout* buffer_entry_wrap(ProfBuffEntry *entry, const char * const message, int startx, int width, int indent);
+gsize buffer_memory(ProfBuff buffer);
 #endif
@@ -47,12 +47,15 @@
 #include "log.h"
 #include "muc.h"
 #include "roster_list.h"
+#include "timers.h"
 #include "config/preferences.h"
 #include "config/theme.h"
 #include "ui/window.h"
 #include "ui/windows.h"
 #include "ui/ui.h"
 #include "ui/statusbar.h"
+#include "ui/frame.h"
+#include "tools/intern.h"
 #include "xmpp/xmpp.h"
 #include "xmpp/bookmark.h"
 
@@ -257,6 +260,71 @@ cons_show_wins(void)
     cons_alert();
 }
 
+void
+cons_show_stats(void)
+{
+    int loaded = 0;
+    int released = 0;
+    long pad_bytes = 0;
+
+    GList *nums = wins_get_nums();
+    GList *curr = nums;
+    while (curr != NULL) {
+        ProfWin *window = wins_get_by_num(GPOINTER_TO_INT(curr->data));
+        if (win_has_pad(window)) {
+            loaded++;
+            pad_bytes += win_pad_bytes(window);
+        } else {
+            released++;
+        }
+        curr = g_list_next(curr);
+    }
+    g_list_free(nums);
+
+    long saved_bytes = released * win_pad_bytes_loaded();
+
+    cons_show("");
+    cons_show("Window pads:");
+    cons_show("  Allocated : %d windows, %ld KB", loaded, pad_bytes / 1024);
+    cons_show("  Released  : %d windows, %ld KB saved", released, saved_bytes / 1024);
+    cons_show("Frames:");
+    cons_show("  Rendered  : %" G_GUINT64_FORMAT, frame_rendered());
+    cons_show("  Skipped   : %" G_GUINT64_FORMAT " (nothing changed)", frame_skipped());
+    cons_show("  Deferred  : %" G_GUINT64_FORMAT " (rate limited)", frame_deferred());
+    cons_show("Interned strings:");
+    cons_show("  Strings   : %u, held %u times", intern_count(), intern_refs());
+    cons_show("  Memory    : %lu KB, %lu KB saved", (unsigned long)intern_memory() / 1024,
+        (unsigned long)intern_saved() / 1024);
+    cons_alert();
+}
+
+void
+cons_show_timers(void)
+{
+    GList *timers = timers_get_all();
+
+    cons_show("");
+    if (timers == NULL) {
+        cons_show("No timers.");
+    } else {
+        cons_show("Timers:");
+        GList *curr = timers;
+        while (curr != NULL) {
+            ProfTimer timer = curr->data;
+            gint64 remaining = timers_get_remaining(timer);
+            if (remaining < 0) {
+                cons_show("  %-14s : stopped", timerwheel_timer_name(timer));
+            } else {
+                cons_show("  %-14s : due in %" G_GINT64_FORMAT ".%03" G_GINT64_FORMAT "s",
+                    timerwheel_timer_name(timer), remaining / 1000, remaining % 1000);
+            }
+            curr = g_list_next(curr);
+        }
+    }
+    g_list_free(timers);
+    cons_alert();
+}
+
 void
 cons_show_room_invites(GSList *invites)
 {
@@ -871,6 +939,15 @@ cons_wrap_setting(void)
         cons_show("Word wrap (/wrap)             : OFF");
 }
 
+void
+cons_fuzzy_setting(void)
+{
+    if (prefs_get_boolean(PREF_FUZZY))
+        cons_show("Fuzzy completion (/fuzzy)     : ON");
+    else
+        cons_show("Fuzzy completion (/fuzzy)     : OFF");
+}
+
 void
 cons_presence_setting(void)
 {
@@ -985,6 +1062,17 @@ cons_titlebar_setting(void)
     }
 }
 
+void
+cons_frame_rate_setting(void)
+{
+    gint frame_rate = prefs_get_frame_rate();
+    if (frame_rate == 0) {
+        cons_show("Frame rate (/framerate)       : unlimited");
+    } else {
+        cons_show("Frame rate (/framerate)       : %d per second", frame_rate);
+    }
+}
+
 void
 cons_roster_setting(void)
 {
@@ -1017,6 +1105,7 @@ cons_show_ui_prefs(void)
     cons_flash_setting();
     cons_splash_setting();
     cons_wrap_setting();
+    cons_fuzzy_setting();
     cons_time_setting();
     cons_resource_setting();
     cons_vercheck_setting();
@@ -1026,8 +1115,8 @@ cons_show_ui_prefs(void)
     cons_roster_setting();
     cons_privileges_setting();
     cons_titlebar_setting();
+    cons_frame_rate_setting();
     cons_presence_setting();
-    cons_inpblock_setting();
 
     cons_alert();
 }
@@ -1188,17 +1277,6 @@ cons_show_chat_prefs(void)
     cons_alert();
 }
 
-void
-cons_inpblock_setting(void)
-{
-    cons_show("Input timeout (/inpblock)     : %d milliseconds", prefs_get_inpblock());
-    if (prefs_get_boolean(PREF_INPBLOCK_DYNAMIC)) {
-        cons_show("Dynamic timeout (/inpblock)   : ON");
-    } else {
-        cons_show("Dynamic timeout (/inpblock)   : OFF");
-    }
-}
-
 void
 cons_log_setting(void)
 {
@@ -1431,6 +1509,8 @@ cons_navigation_help(void)
     cons_show("Alt-2..Alt-0                     : Chat windows.");
     cons_show("F2..F10                          : Chat windows.");
     cons_show("Alt-LEFT, Alt-RIGHT              : Previous/next chat window");
+    cons_show("Alt-a                            : Next window with unread messages.");
+    cons_show("Alt-m                            : Next room mentioning your nick.");
     cons_show("UP, DOWN                         : Navigate input history.");
     cons_show("Ctrl-n, Ctrl-p                   : Navigate input history.");
     cons_show("LEFT, RIGHT, HOME, END           : Move cursor.");
@@ -70,6 +70,8 @@
 #include "ui/inputwin.h"
 #include "ui/window.h"
 #include "ui/windows.h"
+#include "ui/frame.h"
+#include "timers.h"
 #include "xmpp/xmpp.h"
 
 static char *win_title;
@@ -82,9 +84,13 @@ static Display *display;
 
 static GTimer *ui_idle_time;
 
+static ProfTimer frame_timer;
+
 static void _win_handle_switch(const wint_t ch);
 static void _win_show_history(int win_index, const char * const contact);
 static void _ui_draw_term_title(void);
+static void _ui_draw_frame(int parts);
+static gint _ui_frame_timeout(void *data);
 
 void
 ui_init(void)
@@ -113,25 +119,37 @@ ui_init(void)
     inp_size = 0;
     ProfWin *window = wins_get_current();
     win_update_virtual(window);
+
+    frame_reset();
+    frame_set_rate(prefs_get_frame_rate());
+    frame_timer = timers_add("frame", TIMER_STOP, _ui_frame_timeout, NULL);
 }
 
 void
 ui_update(void)
 {
-    ProfWin *current = wins_get_current();
-    if (current->layout->paged == 0) {
-        win_move_to_end(current);
+    gint64 now = g_get_monotonic_time() / 1000;
+    int parts = frame_begin(now);
+
+    // drawn too recently, wake the main loop when the frame is allowed
+    if (parts == 0) {
+        gint delay = frame_next_timeout(now);
+        if (delay >= 0) {
+            timers_reset(frame_timer, delay);
+        }
+        return;
     }
 
-    win_update_virtual(current);
+    _ui_draw_frame(parts);
+}
 
-    if (prefs_get_boolean(PREF_TITLEBAR_SHOW)) {
-        _ui_draw_term_title();
+void
+ui_update_now(void)
+{
+    int parts = frame_begin_now(g_get_monotonic_time() / 1000);
+    if (parts != 0) {
+        _ui_draw_frame(parts);
     }
-    title_bar_update_virtual();
-    status_bar_update_virtual();
-    inp_put_back();
-    doupdate();
 }
 
 void
@@ -182,23 +200,27 @@ ui_readline(void)
 {
     int key_type;
     wint_t ch;
+    char *line = NULL;
 
-    char *line = inp_read(&key_type, &ch);
-    _win_handle_switch(ch);
+    // input is non blocking, drain what is there until a line is complete
+    do {
+        line = inp_read(&key_type, &ch);
+        if (key_type == ERR) {
+            break;
+        }
+        _win_handle_switch(ch);
 
-    ProfWin *current = wins_get_current();
-    win_handle_page(current, ch, key_type);
+        ProfWin *current = wins_get_current();
+        win_handle_page(current, ch, key_type);
 
-    if (ch == KEY_RESIZE) {
-        ui_resize();
-    }
+        if (ch == KEY_RESIZE) {
+            ui_resize();
+        }
 
-    if (ch != ERR && key_type != ERR) {
-        ui_reset_idle_time();
-        ui_input_nonblocking(TRUE);
-    } else {
-        ui_input_nonblocking(FALSE);
-    }
+        if (ch != ERR) {
+            ui_reset_idle_time();
+        }
+    } while (line == NULL);
 
     return line;
 }
@@ -215,37 +237,6 @@ ui_input_clear(void)
     inp_win_reset();
 }
 
-void
-ui_input_nonblocking(gboolean reset)
-{
-    static gint timeout = 0;
-    static gint no_input_count = 0;
-
-    if (! prefs_get_boolean(PREF_INPBLOCK_DYNAMIC)) {
-        inp_non_block(prefs_get_inpblock());
-        return;
-    }
-
-    if (reset) {
-        timeout = 0;
-        no_input_count = 0;
-    }
-
-    if (timeout < prefs_get_inpblock()) {
-        no_input_count++;
-
-        if (no_input_count % 10 == 0) {
-            timeout += no_input_count;
-
-            if (timeout > prefs_get_inpblock()) {
-                timeout = prefs_get_inpblock();
-            }
-        }
-    }
-
-    inp_non_block(timeout);
-}
-
 void
 ui_resize(void)
 {
@@ -258,6 +249,7 @@ ui_resize(void)
     inp_win_resize();
     ProfWin *window = wins_get_current();
     win_update_virtual(window);
+    frame_mark_dirty(FRAME_ALL);
 }
 
 void
@@ -267,6 +259,7 @@ ui_redraw(void)
     wins_resize_all();
     status_bar_resize();
     inp_win_resize();
+    frame_mark_dirty(FRAME_ALL);
 }
 
 void
@@ -432,7 +425,7 @@ ui_incoming_msg(const char * const barejid, const char * const resource, const c
             flash();
         }
 
-        chatwin->unread++;
+        wins_add_unread(window);
         if (prefs_get_boolean(PREF_CHLOG) && prefs_get_boolean(PREF_HISTORY)) {
             _win_show_history(num, barejid);
         }
@@ -501,7 +494,7 @@ ui_incoming_private_msg(const char * const fulljid, const char * const message,
             flash();
         }
 
-        privatewin->unread++;
+        wins_add_unread(window);
         if (prefs_get_boolean(PREF_CHLOG) && prefs_get_boolean(PREF_HISTORY)) {
             _win_show_history(num, fulljid);
         }
@@ -581,7 +574,7 @@ ui_group_removed(const char * const contact, const char * const group)
 void
 ui_auto_away(void)
 {
-    char *pref_autoaway_message = prefs_get_string(PREF_AUTOAWAY_MESSAGE);
+    const char *pref_autoaway_message = prefs_peek_string(PREF_AUTOAWAY_MESSAGE);
     if (pref_autoaway_message != NULL) {
         int pri =
             accounts_get_priority_for_presence_type(jabber_get_account_name(),
@@ -597,7 +590,6 @@ ui_auto_away(void)
             prefs_get_autoaway_time(), pri);
         title_bar_set_presence(CONTACT_AWAY);
     }
-    prefs_free_string(pref_autoaway_message);
 }
 
 void
@@ -623,7 +615,6 @@ ui_handle_login_account_success(ProfAccount *account)
     cons_show_login_success(account);
     title_bar_set_presence(contact_presence);
     status_bar_print_message(account->jid);
-    status_bar_update_virtual();
 }
 
 void
@@ -712,7 +703,6 @@ ui_disconnected(void)
     wins_lost_connection();
     title_bar_set_presence(CONTACT_OFFLINE);
     status_bar_clear_message();
-    status_bar_update_virtual();
     ui_hide_roster();
 }
 
@@ -772,12 +762,12 @@ ui_close_read_wins(void)
     int count = 0;
     jabber_conn_status_t conn_status = jabber_get_connection_status();
 
-    GList *win_nums = wins_get_nums();
+    GList *win_nums = wins_get_read_nums();
     GList *curr = win_nums;
 
     while (curr != NULL) {
         int num = GPOINTER_TO_INT(curr->data);
-        if ((num != 1) && (ui_win_unread(num) == 0) && (!ui_win_has_unsaved_form(num))) {
+        if ((num != 1) && (!ui_win_has_unsaved_form(num))) {
             if (conn_status == JABBER_CONNECTED) {
                 ui_close_connected_win(num);
             }
@@ -932,6 +922,24 @@ ui_previous_win(void)
     }
 }
 
+void
+ui_next_unread_win(void)
+{
+    ProfWin *window = wins_get_next_unread();
+    if (window) {
+        ui_switch_win(wins_get_num(window));
+    }
+}
+
+void
+ui_next_mention_win(void)
+{
+    ProfWin *window = wins_get_next_mention();
+    if (window) {
+        ui_switch_win(wins_get_num(window));
+    }
+}
+
 void
 ui_next_win(void)
 {
@@ -1153,6 +1161,9 @@ ui_close_win(int index)
             cmd_autocomplete_remove_form_fields(confwin->form);
         }
     }
+    if (window && window->type == WIN_XML) {
+        jabber_set_xmlconsole(FALSE);
+    }
 
     wins_close_by_num(index);
     title_bar_console();
@@ -1393,6 +1404,7 @@ void
 ui_create_xmlconsole_win(void)
 {
     ProfWin *window = wins_new_xmlconsole();
+    jabber_set_xmlconsole(TRUE);
     int num = wins_get_num(window);
     ui_switch_win(num);
 }
@@ -1856,9 +1868,11 @@ ui_room_message(const char * const roomjid, const char * const nick,
         ProfWin *window = (ProfWin*) mucwin;
         int num = wins_get_num(window);
         char *my_nick = muc_nick(roomjid);
+        gboolean mention = FALSE;
 
         if (g_strcmp0(nick, my_nick) != 0) {
-            if (g_strrstr(message, my_nick) != NULL) {
+            mention = g_strrstr(message, my_nick) != NULL;
+            if (mention) {
                 win_save_print(window, '-', NULL, NO_ME, THEME_ROOMMENTION, nick, message);
             } else {
                 win_save_print(window, '-', NULL, NO_ME, THEME_TEXT_THEM, nick, message);
@@ -1882,7 +1896,10 @@ ui_room_message(const char * const roomjid, const char * const nick,
                 }
             }
 
-            mucwin->unread++;
+            wins_add_unread(window);
+            if (mention) {
+                wins_add_mention(window);
+            }
         }
 
         int ui_index = num;
@@ -1896,7 +1913,7 @@ ui_room_message(const char * const roomjid, const char * const nick,
             }
 
             gboolean notify = FALSE;
-            char *room_setting = prefs_get_string(PREF_NOTIFY_ROOM);
+            const char *room_setting = prefs_peek_string(PREF_NOTIFY_ROOM);
             if (g_strcmp0(room_setting, "on") == 0) {
                 notify = TRUE;
             }
@@ -1909,7 +1926,6 @@ ui_room_message(const char * const roomjid, const char * const nick,
                 g_free(message_lower);
                 g_free(nick_lower);
             }
-            prefs_free_string(room_setting);
 
             if (notify) {
                 gboolean is_current = wins_is_current(window);
@@ -2233,6 +2249,12 @@ ui_unread(void)
     return wins_get_total_unread();
 }
 
+gint
+ui_mentions(void)
+{
+    return wins_get_total_mentions();
+}
+
 int
 ui_win_unread(int index)
 {
@@ -2252,7 +2274,7 @@ ui_ask_password(void)
   status_bar_update_virtual();
   inp_block();
   inp_get_password(passwd);
-  inp_non_block(prefs_get_inpblock());
+  inp_non_block();
 
   return passwd;
 }
@@ -2292,8 +2314,8 @@ ui_chat_win_contact_offline(PContact contact, char *resource, char *status)
 void
 ui_contact_offline(char *barejid, char *resource, char *status)
 {
-    char *show_console = prefs_get_string(PREF_STATUSES_CONSOLE);
-    char *show_chat_win = prefs_get_string(PREF_STATUSES_CHAT);
+    const char *show_console = prefs_peek_string(PREF_STATUSES_CONSOLE);
+    const char *show_chat_win = prefs_peek_string(PREF_STATUSES_CHAT);
     Jid *jid = jid_create_from_bare_and_resource(barejid, resource);
     PContact contact = roster_get_contact(barejid);
     if (p_contact_subscription(contact) != NULL) {
@@ -2324,11 +2346,23 @@ ui_contact_offline(char *barejid, char *resource, char *status)
         FREE_SET_NULL(chatwin->resource_override);
     }
 
-    prefs_free_string(show_console);
-    prefs_free_string(show_chat_win);
     jid_destroy(jid);
 }
 
+// the titlebar shows the presence of the contact in the current chat window
+void
+ui_contact_presence_changed(const char * const barejid)
+{
+    ProfWin *current = wins_get_current();
+    if (current && current->type == WIN_CHAT) {
+        ProfChatWin *chatwin = (ProfChatWin*)current;
+        assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
+        if (g_strcmp0(chatwin->barejid, barejid) == 0) {
+            frame_mark_dirty(FRAME_TITLEBAR);
+        }
+    }
+}
+
 void
 ui_clear_win_title(void)
 {
@@ -2384,6 +2418,40 @@ _ui_draw_term_title(void)
     }
 }
 
+// draw the dirty parts of the screen and send them to the terminal,
+// the titlebar shows the current window so is drawn along with it
+static void
+_ui_draw_frame(int parts)
+{
+    if (parts & FRAME_WINDOW) {
+        ProfWin *current = wins_get_current();
+        if (current->layout->paged == 0) {
+            win_move_to_end(current);
+        }
+        win_update_virtual(current);
+    }
+
+    if (prefs_get_boolean(PREF_TITLEBAR_SHOW) && (parts & (FRAME_WINDOW | FRAME_TITLEBAR | FRAME_STATUSBAR))) {
+        _ui_draw_term_title();
+    }
+    if (parts & (FRAME_WINDOW | FRAME_TITLEBAR)) {
+        title_bar_update_virtual();
+    }
+    if (parts & FRAME_STATUSBAR) {
+        status_bar_update_virtual();
+    }
+
+    inp_put_back();
+    doupdate();
+}
+
+// only wakes the main loop, which then draws the deferred frame
+static gint
+_ui_frame_timeout(void *data)
+{
+    return TIMER_STOP;
+}
+
 void
 ui_show_room_info(ProfMucWin *mucwin)
 {
@@ -0,0 +1,174 @@
+/*
+ * frame.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include <glib.h>
+
+#include "ui/frame.h"
+
+static int dirty = FRAME_ALL;
+static int rate = 0;
+static gboolean drawn = FALSE;
+static gint64 last_frame = 0;
+
+static guint64 rendered = 0;
+static guint64 skipped = 0;
+static guint64 deferred = 0;
+
+static gint _frame_interval(void);
+static int _frame_take(gint64 now);
+
+void
+frame_reset(void)
+{
+    dirty = FRAME_ALL;
+    drawn = FALSE;
+    last_frame = 0;
+    rendered = 0;
+    skipped = 0;
+    deferred = 0;
+}
+
+void
+frame_mark_dirty(int parts)
+{
+    dirty |= parts;
+}
+
+int
+frame_dirty(void)
+{
+    return dirty;
+}
+
+void
+frame_set_rate(int fps)
+{
+    if (fps < 0) {
+        fps = 0;
+    }
+    rate = fps;
+}
+
+int
+frame_get_rate(void)
+{
+    return rate;
+}
+
+int
+frame_begin(gint64 now)
+{
+    if (dirty == 0) {
+        skipped++;
+        return 0;
+    }
+
+    if (drawn && rate > 0 && now - last_frame < _frame_interval()) {
+        deferred++;
+        return 0;
+    }
+
+    return _frame_take(now);
+}
+
+int
+frame_begin_now(gint64 now)
+{
+    if (dirty == 0) {
+        skipped++;
+        return 0;
+    }
+
+    return _frame_take(now);
+}
+
+gint
+frame_next_timeout(gint64 now)
+{
+    if (dirty == 0) {
+        return -1;
+    }
+    if (!drawn || rate == 0) {
+        return 0;
+    }
+
+    gint64 remaining = last_frame + _frame_interval() - now;
+    if (remaining < 0) {
+        return 0;
+    } else {
+        return remaining;
+    }
+}
+
+guint64
+frame_rendered(void)
+{
+    return rendered;
+}
+
+guint64
+frame_skipped(void)
+{
+    return skipped;
+}
+
+guint64
+frame_deferred(void)
+{
+    return deferred;
+}
+
+// shortest time between frames at the current rate, at least 1ms
+static gint
+_frame_interval(void)
+{
+    gint interval = 1000 / rate;
+    if (interval < 1) {
+        return 1;
+    } else {
+        return interval;
+    }
+}
+
+static int
+_frame_take(gint64 now)
+{
+    int parts = dirty;
+    dirty = 0;
+    drawn = TRUE;
+    last_frame = now;
+    rendered++;
+
+    return parts;
+}
@@ -0,0 +1,72 @@
+/*
+ * frame.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef UI_FRAME_H
+#define UI_FRAME_H
+
+#include <glib.h>
+
+// parts of the screen that are drawn separately
+#define FRAME_WINDOW    (1 << 0)
+#define FRAME_TITLEBAR  (1 << 1)
+#define FRAME_STATUSBAR (1 << 2)
+#define FRAME_INPUT     (1 << 3)
+#define FRAME_ALL       (FRAME_WINDOW | FRAME_TITLEBAR | FRAME_STATUSBAR | FRAME_INPUT)
+
+// forget dirty parts and counters, the next frame draws everything
+void frame_reset(void);
+
+// the parts need drawing in the next frame
+void frame_mark_dirty(int parts);
+int frame_dirty(void);
+
+// cap frames per second, 0 draws as often as the screen changes
+void frame_set_rate(int fps);
+int frame_get_rate(void);
+
+// start a frame at now milliseconds, returns the parts to draw and clears
+// them, 0 when nothing changed or the last frame was too recent
+int frame_begin(gint64 now);
+
+// as frame_begin but ignoring the rate cap
+int frame_begin_now(gint64 now);
+
+// milliseconds until a deferred frame may be drawn, -1 when none is waiting
+gint frame_next_timeout(gint64 now);
+
+guint64 frame_rendered(void);
+guint64 frame_skipped(void);
+guint64 frame_deferred(void);
+
+#endif
@@ -51,6 +51,7 @@
 #include "config/preferences.h"
 #include "config/theme.h"
 #include "tools/history.h"
+#include "tools/linebreak.h"
 #include "log.h"
 #include "muc.h"
 #include "profanity.h"
@@ -59,6 +60,7 @@
 #include "ui/statusbar.h"
 #include "ui/inputwin.h"
 #include "ui/windows.h"
+#include "ui/frame.h"
 #include "xmpp/xmpp.h"
 
 #define _inp_win_update_virtual() pnoutrefresh(inp_win, 0, pad_start, rows-1, 0, rows-1, cols-1)
@@ -106,6 +108,7 @@ create_input_window(void)
     wbkgd(inp_win, theme_attrs(THEME_INPUT_TEXT));;
     keypad(inp_win, TRUE);
     wmove(inp_win, 0, 0);
+    inp_non_block();
     _inp_win_update_virtual();
     history = history_new(MAX_HISTORY);
 }
@@ -130,9 +133,9 @@ inp_win_resize(void)
 }
 
 void
-inp_non_block(gint timeout)
+inp_non_block(void)
 {
-    wtimeout(inp_win, timeout);
+    wtimeout(inp_win, 0);
 }
 
 void
@@ -144,7 +147,7 @@ inp_block(void)
 char *
 inp_read(int *key_type, wint_t *ch)
 {
-    int display_size = utf8_display_len(input);
+    int display_size = linebreak_display_len(input);
 
     // echo off, and get some more input
     noecho();
@@ -157,9 +160,12 @@ inp_read(int *key_type, wint_t *ch)
     }
 
     if (*key_type == ERR) {
-        prof_handle_idle();
+        echo();
+        return NULL;
     }
-    if ((*key_type != ERR) && (*key_type != KEY_CODE_YES) && !in_command && _printable(*ch)) {
+    frame_mark_dirty(FRAME_INPUT);
+
+    if ((*key_type != KEY_CODE_YES) && !in_command && _printable(*ch)) {
         prof_handle_activity();
     }
 
@@ -276,6 +282,7 @@ inp_win_reset(void)
     _clear_input();
     pad_start = 0;
     _inp_win_update_virtual();
+    frame_mark_dirty(FRAME_INPUT);
 }
 
 void
@@ -303,7 +310,7 @@ _handle_edit(int key_type, const wint_t ch)
     char *next = NULL;
     int inp_x = getcurx(inp_win);
     int next_ch;
-    int display_size = utf8_display_len(input);
+    int display_size = linebreak_display_len(input);
 
     // CTRL-LEFT
     if ((key_type == KEY_CODE_YES) && (ch == 547 || ch == 545 || ch == 544 || ch == 540 || ch == 539) && (inp_x > 0)) {
@@ -589,7 +596,7 @@ static void
 _handle_backspace(void)
 {
     int inp_x = getcurx(inp_win);
-    int display_size = utf8_display_len(input);
+    int display_size = linebreak_display_len(input);
     roster_reset_search_attempts();
     if (display_size > 0) {
 
@@ -682,6 +689,12 @@ _handle_alt_key(int key)
         case KEY_RIGHT:
             ui_next_win();
             break;
+        case 'a':
+            ui_next_unread_win();
+            break;
+        case 'm':
+            ui_next_mention_win();
+            break;
         case 263:
         case 127:
             _delete_previous_word();
@@ -768,7 +781,7 @@ _delete_previous_word(void)
 static void
 _go_to_end(void)
 {
-    int display_size = utf8_display_len(input);
+    int display_size = linebreak_display_len(input);
     wmove(inp_win, 0, display_size);
     if (display_size > cols-2) {
         pad_start = display_size - cols + 1;
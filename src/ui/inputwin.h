@@ -40,7 +40,7 @@ char* inp_read(int *key_type, wint_t *ch);
 void inp_win_reset(void);
 void inp_win_resize(void);
 void inp_put_back(void);
-void inp_non_block(gint);
+void inp_non_block(void);
 void inp_block(void);
 void inp_get_password(char *passwd);
 void inp_replace_input(const char * const new_input);
@@ -49,16 +49,20 @@
 #include "muc.h"
 #include "ui/ui.h"
 #include "config/preferences.h"
+#include "timers.h"
 
 static void _notify(const char * const message, int timeout,
     const char * const category);
 
-static GTimer *remind_timer;
+static gint _notify_remind_timeout(void *data);
+static gint _notify_remind_delay(void);
+
+static ProfTimer remind_timer;
 
 void
 notifier_initialise(void)
 {
-    remind_timer = g_timer_new();
+    remind_timer = timers_add("notify remind", _notify_remind_delay(), _notify_remind_timeout, NULL);
 }
 
 void
@@ -69,7 +73,8 @@ notifier_uninit(void)
         notify_uninit();
     }
 #endif
-    g_timer_destroy(remind_timer);
+    timers_remove(remind_timer);
+    remind_timer = NULL;
 }
 
 void
@@ -136,12 +141,31 @@ notify_subscription(const char * const from)
 }
 
 void
-notify_remind(void)
+notify_remind_reset(void)
+{
+    if (remind_timer != NULL) {
+        timers_reset(remind_timer, _notify_remind_delay());
+    }
+}
+
+static gint
+_notify_remind_delay(void)
 {
-    gdouble elapsed = g_timer_elapsed(remind_timer, NULL);
     gint remind_period = prefs_get_notify_remind();
-    if (remind_period > 0 && elapsed >= remind_period) {
+    if (remind_period > 0) {
+        return remind_period * 1000;
+    } else {
+        return TIMER_STOP;
+    }
+}
+
+static gint
+_notify_remind_timeout(void *data)
+{
+    gint remind_period = prefs_get_notify_remind();
+    if (remind_period > 0) {
         gint unread = ui_unread();
+        gint mentions = ui_mentions();
         gint open = muc_invites_count();
         gint subs = presence_sub_request_count();
 
@@ -153,7 +177,11 @@ notify_remind(void)
             } else {
                 g_string_append_printf(text, "%d unread messages", unread);
             }
-
+            if (mentions == 1) {
+                g_string_append(text, ", 1 mention");
+            } else if (mentions > 1) {
+                g_string_append_printf(text, ", %d mentions", mentions);
+            }
         }
         if (open > 0) {
             if (unread > 0) {
@@ -181,9 +209,9 @@ notify_remind(void)
         }
 
         g_string_free(text, TRUE);
-
-        g_timer_start(remind_timer);
     }
+
+    return _notify_remind_delay();
 }
 
 static void
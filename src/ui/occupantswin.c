@@ -37,6 +37,7 @@
 #include "ui/ui.h"
 #include "ui/window.h"
 #include "ui/windows.h"
+#include "ui/frame.h"
 #include "config/preferences.h"
 
 static void
@@ -58,7 +59,7 @@ void
 occupantswin_occupants(const char * const roomjid)
 {
     ProfMucWin *mucwin = wins_get_muc(roomjid);
-    if (mucwin) {
+    if (mucwin && win_has_active_subwin(&mucwin->window) && win_has_pad(&mucwin->window)) {
         GList *occupants = muc_roster(roomjid);
         if (occupants) {
             ProfLayoutSplit *layout = (ProfLayoutSplit*)mucwin->window.layout;
@@ -116,5 +117,9 @@ occupantswin_occupants(const char * const roomjid)
         }
 
         g_list_free(occupants);
+
+        if (wins_is_current(&mucwin->window)) {
+            frame_mark_dirty(FRAME_WINDOW);
+        }
     }
 }
\ No newline at end of file
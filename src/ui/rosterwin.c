@@ -34,16 +34,54 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "contact.h"
 #include "ui/ui.h"
 #include "ui/window.h"
 #include "ui/windows.h"
+#include "ui/frame.h"
 #include "config/preferences.h"
 #include "roster_list.h"
 
+// a line of the roster panel
+typedef struct roster_row_t {
+    char *text;
+    int attrs;
+} RosterRow;
+
+// rows as last drawn, diffed against the rows built for the next frame
+static GPtrArray *drawn_rows = NULL;
+static int drawn_cols = 0;
+
+// the roster changed since it was last drawn
+static gboolean stale = TRUE;
+
+static void
+_rosterwin_row_free(RosterRow *row)
+{
+    free(row->text);
+    free(row);
+}
+
+static void
+_rosterwin_add_row(GPtrArray *rows, theme_item_t theme_item, const char * const indent,
+    const char * const text)
+{
+    RosterRow *row = malloc(sizeof(RosterRow));
+    row->text = g_strconcat(indent, text, NULL);
+    row->attrs = theme_attrs(theme_item);
+    g_ptr_array_add(rows, row);
+}
+
+static gboolean
+_rosterwin_row_equal(RosterRow *a, RosterRow *b)
+{
+    return a->attrs == b->attrs && strcmp(a->text, b->text) == 0;
+}
+
 static void
-_rosterwin_contact(ProfLayoutSplit *layout, PContact contact)
+_rosterwin_contact(GPtrArray *rows, PContact contact)
 {
     if (p_contact_subscribed(contact)) {
         const char *name = p_contact_name_or_jid(contact);
@@ -51,14 +89,7 @@ _rosterwin_contact(ProfLayoutSplit *layout, PContact contact)
 
         if ((g_strcmp0(presence, "offline") != 0) || ((g_strcmp0(presence, "offline") == 0) &&
                 (prefs_get_boolean(PREF_ROSTER_OFFLINE)))) {
-            theme_item_t presence_colour = theme_main_presence_attrs(presence);
-
-            wattron(layout->subwin, theme_attrs(presence_colour));
-            GString *msg = g_string_new("   ");
-            g_string_append(msg, name);
-            win_printline_nowrap(layout->subwin, msg->str);
-            g_string_free(msg, TRUE);
-            wattroff(layout->subwin, theme_attrs(presence_colour));
+            _rosterwin_add_row(rows, theme_main_presence_attrs(presence), "   ", name);
 
             if (prefs_get_boolean(PREF_ROSTER_RESOURCE)) {
                 GList *resources = p_contact_get_available_resources(contact);
@@ -66,15 +97,8 @@ _rosterwin_contact(ProfLayoutSplit *layout, PContact contact)
                 while (curr_resource) {
                     Resource *resource = curr_resource->data;
                     const char *resource_presence = string_from_resource_presence(resource->presence);
-                    theme_item_t resource_presence_colour = theme_main_presence_attrs(resource_presence);
-
-                    wattron(layout->subwin, theme_attrs(resource_presence_colour));
-                    GString *msg = g_string_new("     ");
-                    g_string_append(msg, resource->name);
-                    win_printline_nowrap(layout->subwin, msg->str);
-                    g_string_free(msg, TRUE);
-                    wattroff(layout->subwin, theme_attrs(resource_presence_colour));
-
+                    _rosterwin_add_row(rows, theme_main_presence_attrs(resource_presence), "     ",
+                        resource->name);
                     curr_resource = g_list_next(curr_resource);
                 }
                 g_list_free(resources);
@@ -84,112 +108,173 @@ _rosterwin_contact(ProfLayoutSplit *layout, PContact contact)
 }
 
 static void
-_rosterwin_contacts_by_presence(ProfLayoutSplit *layout, const char * const presence, char *title)
+_rosterwin_contacts(GPtrArray *rows, GSList *contacts)
 {
-    wattron(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-    win_printline_nowrap(layout->subwin, title);
-    wattroff(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-
-    GSList *contacts = roster_get_contacts_by_presence(presence);
-    if (contacts) {
-        GSList *curr_contact = contacts;
-        while (curr_contact) {
-            PContact contact = curr_contact->data;
-            _rosterwin_contact(layout, contact);
-            curr_contact = g_slist_next(curr_contact);
-        }
+    GSList *curr_contact = contacts;
+    while (curr_contact) {
+        _rosterwin_contact(rows, curr_contact->data);
+        curr_contact = g_slist_next(curr_contact);
     }
     g_slist_free(contacts);
 }
 
 static void
-_rosterwin_contacts_by_group(ProfLayoutSplit *layout, char *group)
+_rosterwin_contacts_by_presence(GPtrArray *rows, const char * const presence, char *title)
+{
+    _rosterwin_add_row(rows, THEME_ROSTER_HEADER, "", title);
+    _rosterwin_contacts(rows, roster_get_contacts_by_presence(presence));
+}
+
+static void
+_rosterwin_contacts_by_group(GPtrArray *rows, char *group)
+{
+    _rosterwin_add_row(rows, THEME_ROSTER_HEADER, " -", group);
+    _rosterwin_contacts(rows, roster_get_group(group));
+}
+
+static void
+_rosterwin_contacts_by_no_group(GPtrArray *rows)
 {
-    wattron(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-    GString *title = g_string_new(" -");
-    g_string_append(title, group);
-    win_printline_nowrap(layout->subwin, title->str);
-    g_string_free(title, TRUE);
-    wattroff(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-
-    GSList *contacts = roster_get_group(group);
+    GSList *contacts = roster_get_nogroup();
     if (contacts) {
-        GSList *curr_contact = contacts;
-        while (curr_contact) {
-            PContact contact = curr_contact->data;
-            _rosterwin_contact(layout, contact);
-            curr_contact = g_slist_next(curr_contact);
+        _rosterwin_add_row(rows, THEME_ROSTER_HEADER, "", " -no group");
+    }
+    _rosterwin_contacts(rows, contacts);
+}
+
+static GPtrArray *
+_rosterwin_rows(void)
+{
+    GPtrArray *rows = g_ptr_array_new_with_free_func((GDestroyNotify)_rosterwin_row_free);
+
+    const char *by = prefs_peek_string(PREF_ROSTER_BY);
+    if (g_strcmp0(by, "presence") == 0) {
+        _rosterwin_contacts_by_presence(rows, "chat", " -Available for chat");
+        _rosterwin_contacts_by_presence(rows, "online", " -Online");
+        _rosterwin_contacts_by_presence(rows, "away", " -Away");
+        _rosterwin_contacts_by_presence(rows, "xa", " -Extended Away");
+        _rosterwin_contacts_by_presence(rows, "dnd", " -Do not disturb");
+        if (prefs_get_boolean(PREF_ROSTER_OFFLINE)) {
+            _rosterwin_contacts_by_presence(rows, "offline", " -Offline");
+        }
+    } else if (g_strcmp0(by, "group") == 0) {
+        GSList *groups = roster_get_groups();
+        GSList *curr_group = groups;
+        while (curr_group) {
+            _rosterwin_contacts_by_group(rows, curr_group->data);
+            curr_group = g_slist_next(curr_group);
+        }
+        g_slist_free_full(groups, free);
+        _rosterwin_contacts_by_no_group(rows);
+    } else {
+        GSList *contacts = roster_get_contacts();
+        if (contacts) {
+            _rosterwin_add_row(rows, THEME_ROSTER_HEADER, "", " -Roster");
         }
+        _rosterwin_contacts(rows, contacts);
     }
-    g_slist_free(contacts);
+
+    return rows;
 }
 
 static void
-_rosterwin_contacts_by_no_group(ProfLayoutSplit *layout)
+_rosterwin_draw_row(WINDOW *win, int y, RosterRow *row)
 {
-    GSList *contacts = roster_get_nogroup();
-    if (contacts) {
-        wattron(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-        win_printline_nowrap(layout->subwin, " -no group");
-        wattroff(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-
-        GSList *curr_contact = contacts;
-        while (curr_contact) {
-            PContact contact = curr_contact->data;
-            _rosterwin_contact(layout, contact);
-            curr_contact = g_slist_next(curr_contact);
+    wmove(win, y, 0);
+    wclrtoeol(win);
+    wattron(win, row->attrs);
+    waddnstr(win, row->text, getmaxx(win));
+    wattroff(win, row->attrs);
+}
+
+// bring the panel from the drawn rows to the new rows, a contact that
+// appeared, left or moved shifts the rows below it with a line insert or
+// delete instead of reprinting them
+static void
+_rosterwin_apply(WINDOW *win, GPtrArray *rows)
+{
+    guint old = 0;
+    guint new = 0;
+
+    while (old < drawn_rows->len && new < rows->len) {
+        RosterRow *old_row = g_ptr_array_index(drawn_rows, old);
+        RosterRow *new_row = g_ptr_array_index(rows, new);
+
+        if (_rosterwin_row_equal(old_row, new_row)) {
+            old++;
+            new++;
+        } else if (new + 1 < rows->len &&
+                _rosterwin_row_equal(old_row, g_ptr_array_index(rows, new + 1))) {
+            wmove(win, new, 0);
+            winsdelln(win, 1);
+            _rosterwin_draw_row(win, new, new_row);
+            new++;
+        } else if (old + 1 < drawn_rows->len &&
+                _rosterwin_row_equal(g_ptr_array_index(drawn_rows, old + 1), new_row)) {
+            wmove(win, new, 0);
+            winsdelln(win, -1);
+            old++;
+        } else {
+            _rosterwin_draw_row(win, new, new_row);
+            old++;
+            new++;
         }
     }
-    g_slist_free(contacts);
+
+    if (old < drawn_rows->len) {
+        wmove(win, new, 0);
+        wclrtobot(win);
+    }
+    for (; new < rows->len; new++) {
+        _rosterwin_draw_row(win, new, g_ptr_array_index(rows, new));
+    }
 }
 
 void
 rosterwin_roster(void)
 {
+    stale = TRUE;
+
     ProfWin *console = wins_get_console();
-    if (console) {
-        ProfLayoutSplit *layout = (ProfLayoutSplit*)console->layout;
-        assert(layout->memcheck == LAYOUT_SPLIT_MEMCHECK);
-
-       char *by = prefs_get_string(PREF_ROSTER_BY);
-        if (g_strcmp0(by, "presence") == 0) {
-            werase(layout->subwin);
-            _rosterwin_contacts_by_presence(layout, "chat", " -Available for chat");
-            _rosterwin_contacts_by_presence(layout, "online", " -Online");
-            _rosterwin_contacts_by_presence(layout, "away", " -Away");
-            _rosterwin_contacts_by_presence(layout, "xa", " -Extended Away");
-            _rosterwin_contacts_by_presence(layout, "dnd", " -Do not disturb");
-            if (prefs_get_boolean(PREF_ROSTER_OFFLINE)) {
-                _rosterwin_contacts_by_presence(layout, "offline", " -Offline");
-            }
-        } else if (g_strcmp0(by, "group") == 0) {
-            werase(layout->subwin);
-            GSList *groups = roster_get_groups();
-            GSList *curr_group = groups;
-            while (curr_group) {
-                _rosterwin_contacts_by_group(layout, curr_group->data);
-                curr_group = g_slist_next(curr_group);
-            }
-            g_slist_free_full(groups, free);
-            _rosterwin_contacts_by_no_group(layout);
-        } else {
-            GSList *contacts = roster_get_contacts();
-            if (contacts) {
-                werase(layout->subwin);
-
-                wattron(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-                win_printline_nowrap(layout->subwin, " -Roster");
-                wattroff(layout->subwin, theme_attrs(THEME_ROSTER_HEADER));
-
-                GSList *curr_contact = contacts;
-                while (curr_contact) {
-                    PContact contact = curr_contact->data;
-                    _rosterwin_contact(layout, contact);
-                    curr_contact = g_slist_next(curr_contact);
-                }
-            }
-            g_slist_free(contacts);
-        }
-        free(by);
+    if (console && wins_is_current(console)) {
+        frame_mark_dirty(FRAME_WINDOW);
+    }
+}
+
+// called as the console is pushed to the screen, so the panel is only
+// rebuilt when it can be seen
+void
+rosterwin_draw(ProfLayoutSplit *layout)
+{
+    assert(layout->memcheck == LAYOUT_SPLIT_MEMCHECK);
+    if (layout->subwin == NULL) {
+        return;
     }
-}
\ No newline at end of file
+
+    int cols = getmaxx(layout->subwin);
+    if (drawn_rows == NULL || cols != drawn_cols) {
+        rosterwin_forget();
+        werase(layout->subwin);
+        drawn_rows = g_ptr_array_new_with_free_func((GDestroyNotify)_rosterwin_row_free);
+        drawn_cols = cols;
+    } else if (!stale) {
+        return;
+    }
+
+    GPtrArray *rows = _rosterwin_rows();
+    _rosterwin_apply(layout->subwin, rows);
+    g_ptr_array_free(drawn_rows, TRUE);
+    drawn_rows = rows;
+    stale = FALSE;
+}
+
+// the panel was deleted, draw every row into the next one
+void
+rosterwin_forget(void)
+{
+    if (drawn_rows) {
+        g_ptr_array_free(drawn_rows, TRUE);
+        drawn_rows = NULL;
+    }
+    drawn_cols = 0;
+}
@@ -44,55 +44,59 @@
 #include <ncurses.h>
 #endif
 
+#include "common.h"
 #include "config/theme.h"
 #include "ui/ui.h"
 #include "ui/statusbar.h"
 #include "ui/inputwin.h"
+#include "ui/frame.h"
+#include "tools/intset.h"
+#include "timers.h"
 
-#define TIME_CHECK 60000000
+// columns at the right of the bar showing window numbers, the first and
+// last are kept for the markers of windows scrolled out of view
+#define WINS_WIDTH 34
 
 static WINDOW *status_bar;
 static char *message = NULL;
-//                          1  2  3  4  5  6  7  8  9  0  >
-static char _active[34] = "[ ][ ][ ][ ][ ][ ][ ][ ][ ][ ][ ]";
-static char *bracket = "- -";
-static int is_active[12];
-static GHashTable *remaining_active;
-static int is_new[12];
-static GHashTable *remaining_new;
 static GDateTime *last_time;
+static ProfTimer clock_timer;
+
+// open windows and those with new messages, by place in window order
+// (see win_num_to_order)
+static IntSet active_wins;
+static IntSet new_wins;
 static int current;
 
-static void _update_win_statuses(void);
-static void _mark_new(int num);
-static void _mark_active(int num);
-static void _mark_inactive(int num);
+// first window in view, the view scrolls to keep the current window in it
+static int view_start;
+
 static void _status_bar_draw(void);
+static void _status_bar_draw_wins(void);
+static guint _status_bar_scroll(guint width);
+static int _status_bar_win_width(int order);
+static gint _status_bar_clock_delay(void);
+static gint _status_bar_clock_timeout(void *data);
 
 void
 create_status_bar(void)
 {
-    int rows, cols, i;
+    int rows, cols;
     getmaxyx(stdscr, rows, cols);
 
-    is_active[1] = TRUE;
-    is_new[1] = FALSE;
-    for (i = 2; i < 12; i++) {
-        is_active[i] = FALSE;
-        is_new[i] = FALSE;
+    if (active_wins == NULL) {
+        active_wins = intset_new();
+        new_wins = intset_new();
+    } else {
+        intset_clear(active_wins);
+        intset_clear(new_wins);
     }
-    remaining_active = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
-    remaining_new = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, NULL);
+    intset_add(active_wins, 1);
     current = 1;
-
-    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
+    view_start = 1;
 
     status_bar = newwin(1, cols, rows-2, 0);
     wbkgd(status_bar, theme_attrs(THEME_STATUS_TEXT));
-    wattron(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, cols - 34, _active);
-    mvwprintw(status_bar, 0, cols - 34 + ((current - 1) * 3), bracket);
-    wattroff(status_bar, bracket_attrs);
 
     if (last_time != NULL) {
         g_date_time_unref(last_time);
@@ -100,6 +104,10 @@ create_status_bar(void)
     last_time = g_date_time_new_now_local();
 
     _status_bar_draw();
+
+    if (clock_timer == NULL) {
+        clock_timer = timers_add("clock", _status_bar_clock_delay(), _status_bar_clock_timeout, NULL);
+    }
 }
 
 void
@@ -114,196 +122,75 @@ status_bar_resize(void)
     int rows, cols;
     getmaxyx(stdscr, rows, cols);
 
-    werase(status_bar);
-
-    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
-
     mvwin(status_bar, rows-2, 0);
     wresize(status_bar, 1, cols);
     wbkgd(status_bar, theme_attrs(THEME_STATUS_TEXT));
-    wattron(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, cols - 34, _active);
-    mvwprintw(status_bar, 0, cols - 34 + ((current - 1) * 3), bracket);
-    wattroff(status_bar, bracket_attrs);
-
-    if (message != NULL) {
-        mvwprintw(status_bar, 0, 10, message);
-    }
-    if (last_time != NULL) {
-        g_date_time_unref(last_time);
-    }
-    last_time = g_date_time_new_now_local();
 
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_set_all_inactive(void)
 {
-    int i = 0;
-    for (i = 0; i < 12; i++) {
-        is_active[i] = FALSE;
-        is_new[i] = FALSE;
-        _mark_inactive(i);
-    }
-
-    g_hash_table_remove_all(remaining_active);
-    g_hash_table_remove_all(remaining_new);
+    intset_clear(active_wins);
+    intset_clear(new_wins);
 
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_current(int i)
 {
-    if (i == 0) {
-        current = 10;
-    } else if (i > 10) {
-        current = 11;
-    } else {
-        current = i;
-    }
-    int cols = getmaxx(stdscr);
-    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
-    wattron(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, cols - 34, _active);
-    mvwprintw(status_bar, 0, cols - 34 + ((current - 1) * 3), bracket);
-    wattroff(status_bar, bracket_attrs);
+    current = win_num_to_order(i);
 
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_inactive(const int win)
 {
-    int true_win = win;
-    if (true_win == 0) {
-        true_win = 10;
-    }
-
-    // extra windows
-    if (true_win > 10) {
-        g_hash_table_remove(remaining_active, GINT_TO_POINTER(true_win));
-        g_hash_table_remove(remaining_new, GINT_TO_POINTER(true_win));
-
-        // still have new windows
-        if (g_hash_table_size(remaining_new) != 0) {
-            is_active[11] = TRUE;
-            is_new[11] = TRUE;
-            _mark_new(11);
+    int order = win_num_to_order(win);
+    intset_remove(active_wins, order);
+    intset_remove(new_wins, order);
 
-        // still have active winsows
-        } else if (g_hash_table_size(remaining_active) != 0) {
-            is_active[11] = TRUE;
-            is_new[11] = FALSE;
-            _mark_active(11);
-
-        // no active or new windows
-        } else {
-            is_active[11] = FALSE;
-            is_new[11] = FALSE;
-            _mark_inactive(11);
-        }
-
-    // visible window indicators
-    } else {
-        is_active[true_win] = FALSE;
-        is_new[true_win] = FALSE;
-        _mark_inactive(true_win);
-    }
-
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_active(const int win)
 {
-    int true_win = win;
-    if (true_win == 0) {
-        true_win = 10;
-    }
-
-    // extra windows
-    if (true_win > 10) {
-        g_hash_table_add(remaining_active, GINT_TO_POINTER(true_win));
-        g_hash_table_remove(remaining_new, GINT_TO_POINTER(true_win));
-
-        // still have new windows
-        if (g_hash_table_size(remaining_new) != 0) {
-            is_active[11] = TRUE;
-            is_new[11] = TRUE;
-            _mark_new(11);
+    int order = win_num_to_order(win);
+    intset_add(active_wins, order);
+    intset_remove(new_wins, order);
 
-        // only active windows
-        } else {
-            is_active[11] = TRUE;
-            is_new[11] = FALSE;
-            _mark_active(11);
-        }
-
-    // visible winsow indicators
-    } else {
-        is_active[true_win] = TRUE;
-        is_new[true_win] = FALSE;
-        _mark_active(true_win);
-    }
-
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_new(const int win)
 {
-    int true_win = win;
-    if (true_win == 0) {
-        true_win = 10;
-    }
-
-    if (true_win > 10) {
-        g_hash_table_add(remaining_active, GINT_TO_POINTER(true_win));
-        g_hash_table_add(remaining_new, GINT_TO_POINTER(true_win));
-
-        is_active[11] = TRUE;
-        is_new[11] = TRUE;
-        _mark_new(11);
+    int order = win_num_to_order(win);
+    intset_add(active_wins, order);
+    intset_add(new_wins, order);
 
-    } else {
-        is_active[true_win] = TRUE;
-        is_new[true_win] = TRUE;
-        _mark_new(true_win);
-    }
-
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_get_password(void)
 {
     status_bar_print_message("Enter password:");
-
-    _status_bar_draw();
 }
 
 void
 status_bar_print_message(const char * const msg)
 {
-    werase(status_bar);
-
     if (message != NULL) {
         free(message);
     }
     message = strdup(msg);
-    mvwprintw(status_bar, 0, 10, message);
-
-    int cols = getmaxx(stdscr);
-    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
 
-    wattron(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, cols - 34, _active);
-    mvwprintw(status_bar, 0, cols - 34 + ((current - 1) * 3), bracket);
-    wattroff(status_bar, bracket_attrs);
-
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
@@ -314,123 +201,209 @@ status_bar_clear(void)
         message = NULL;
     }
 
-    werase(status_bar);
-
-    int cols = getmaxx(stdscr);
-    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
-
-    wattron(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, cols - 34, _active);
-    mvwprintw(status_bar, 0, cols - 34 + ((current - 1) * 3), bracket);
-    wattroff(status_bar, bracket_attrs);
-
-    _status_bar_draw();
+    frame_mark_dirty(FRAME_STATUSBAR);
 }
 
 void
 status_bar_clear_message(void)
 {
-    if (message != NULL) {
-        free(message);
-        message = NULL;
-    }
+    status_bar_clear();
+}
 
+static void
+_status_bar_draw(void)
+{
     werase(status_bar);
 
-    int cols = getmaxx(stdscr);
+    if (last_time != NULL) {
+        g_date_time_unref(last_time);
+    }
+    last_time = g_date_time_new_now_local();
+    gchar *date_fmt = g_date_time_format(last_time, "%H:%M");
+    assert(date_fmt != NULL);
+
     int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
 
     wattron(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, cols - 34, _active);
-    mvwprintw(status_bar, 0, cols - 34 + ((current - 1) * 3), bracket);
+    mvwaddch(status_bar, 0, 1, '[');
+    wattroff(status_bar, bracket_attrs);
+    mvwprintw(status_bar, 0, 2, date_fmt);
+    wattron(status_bar, bracket_attrs);
+    mvwaddch(status_bar, 0, 7, ']');
     wattroff(status_bar, bracket_attrs);
+    g_free(date_fmt);
 
-    _status_bar_draw();
+    if (message != NULL) {
+        mvwprintw(status_bar, 0, 10, "%s", message);
+    }
+
+    _status_bar_draw_wins();
+
+    wnoutrefresh(status_bar);
+    inp_put_back();
 }
 
+// draw the windows in view as [n], the current one as -n-, with < and >
+// marking windows scrolled out of view on either side
 static void
-_update_win_statuses(void)
+_status_bar_draw_wins(void)
 {
-    int i;
-    for(i = 1; i < 12; i++) {
-        if (is_new[i]) {
-            _mark_new(i);
+    guint count = intset_size(active_wins);
+    if (count == 0) {
+        return;
+    }
+
+    int cols = getmaxx(stdscr);
+    int col = cols - WINS_WIDTH;
+    guint width = WINS_WIDTH - 2;
+    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
+    int new_attrs = theme_attrs(THEME_STATUS_NEW);
+    int active_attrs = theme_attrs(THEME_STATUS_ACTIVE);
+
+    guint start = _status_bar_scroll(width);
+    guint index = start;
+    guint used = 0;
+    col++;
+
+    while (index < count) {
+        int order = intset_nth(active_wins, index);
+        guint win_width = _status_bar_win_width(order);
+        if (used + win_width > width) {
+            break;
+        }
+
+        char *brackets = order == current ? "--" : "[]";
+        wattron(status_bar, bracket_attrs);
+        mvwaddch(status_bar, 0, col, brackets[0]);
+        wattroff(status_bar, bracket_attrs);
+
+        if (intset_contains(new_wins, order)) {
+            wattron(status_bar, new_attrs | A_BLINK);
+            wprintw(status_bar, "%d", win_order_to_num(order));
+            wattroff(status_bar, new_attrs | A_BLINK);
+        } else {
+            wattron(status_bar, active_attrs);
+            wprintw(status_bar, "%d", win_order_to_num(order));
+            wattroff(status_bar, active_attrs);
         }
-        else if (is_active[i]) {
-            _mark_active(i);
+
+        wattron(status_bar, bracket_attrs);
+        waddch(status_bar, brackets[1]);
+        wattroff(status_bar, bracket_attrs);
+
+        col += win_width;
+        used += win_width;
+        index++;
+    }
+
+    // windows before the view
+    if (start > 0) {
+        int first_new = intset_first(new_wins);
+        if (first_new != INTSET_NONE && first_new < intset_nth(active_wins, start)) {
+            wattron(status_bar, new_attrs | A_BLINK);
+            mvwaddch(status_bar, 0, cols - WINS_WIDTH, '<');
+            wattroff(status_bar, new_attrs | A_BLINK);
+        } else {
+            wattron(status_bar, active_attrs);
+            mvwaddch(status_bar, 0, cols - WINS_WIDTH, '<');
+            wattroff(status_bar, active_attrs);
         }
-        else {
-            _mark_inactive(i);
+    }
+
+    // windows after the view
+    if (index < count) {
+        int last_new = intset_last(new_wins);
+        if (last_new != INTSET_NONE && last_new > intset_nth(active_wins, index - 1)) {
+            wattron(status_bar, new_attrs | A_BLINK);
+            mvwaddch(status_bar, 0, cols - 1, '>');
+            wattroff(status_bar, new_attrs | A_BLINK);
+        } else {
+            wattron(status_bar, active_attrs);
+            mvwaddch(status_bar, 0, cols - 1, '>');
+            wattroff(status_bar, active_attrs);
         }
     }
 }
 
-static void
-_mark_new(int num)
+// move the view the least needed to show the current window, and to not
+// leave space at the end while windows before it are hidden, returns the
+// position of the first window in view
+static guint
+_status_bar_scroll(guint width)
 {
-    int active_pos = 1 + ((num-1) * 3);
-    int cols = getmaxx(stdscr);
-    int status_attrs = theme_attrs(THEME_STATUS_NEW);
-    wattron(status_bar, status_attrs);
-    wattron(status_bar, A_BLINK);
-    if (num == 10) {
-        mvwprintw(status_bar, 0, cols - 34 + active_pos, "0");
-    } else if (num > 10) {
-        mvwprintw(status_bar, 0, cols - 34 + active_pos, ">");
+    guint count = intset_size(active_wins);
+    guint start = intset_index(active_wins, view_start);
+    guint curr_index = intset_index(active_wins, current);
+    if (curr_index >= count) {
+        curr_index = count - 1;
+    }
+
+    // earliest start that still fits the last window
+    guint used = 0;
+    guint end_start = count;
+    while (end_start > 0) {
+        guint win_width = _status_bar_win_width(intset_nth(active_wins, end_start - 1));
+        if (used + win_width > width) {
+            break;
+        }
+        used += win_width;
+        end_start--;
+    }
+    if (start > end_start) {
+        start = end_start;
+    }
+
+    if (curr_index < start) {
+        start = curr_index;
     } else {
-        mvwprintw(status_bar, 0, cols - 34 + active_pos, "%d", num);
+        // earliest start that still fits the current window
+        used = 0;
+        guint curr_start = curr_index + 1;
+        while (curr_start > 0) {
+            guint win_width = _status_bar_win_width(intset_nth(active_wins, curr_start - 1));
+            if (used + win_width > width) {
+                break;
+            }
+            used += win_width;
+            curr_start--;
+        }
+        if (start < curr_start) {
+            start = curr_start;
+        }
     }
-    wattroff(status_bar, status_attrs);
-    wattroff(status_bar, A_BLINK);
+
+    view_start = intset_nth(active_wins, start);
+    return start;
 }
 
-static void
-_mark_active(int num)
+// columns taken by a window in the bar, the number and two brackets
+static int
+_status_bar_win_width(int order)
 {
-    int active_pos = 1 + ((num-1) * 3);
-    int cols = getmaxx(stdscr);
-    int status_attrs = theme_attrs(THEME_STATUS_ACTIVE);
-    wattron(status_bar, status_attrs);
-    if (num == 10) {
-        mvwprintw(status_bar, 0, cols - 34 + active_pos, "0");
-    } else if (num > 10) {
-        mvwprintw(status_bar, 0, cols - 34 + active_pos, ">");
-    } else {
-        mvwprintw(status_bar, 0, cols - 34 + active_pos, "%d", num);
+    int num = win_order_to_num(order);
+    int digits = 1;
+    while (num >= 10) {
+        num /= 10;
+        digits++;
     }
-    wattroff(status_bar, status_attrs);
+
+    return digits + 2;
 }
 
-static void
-_mark_inactive(int num)
+// redraw the clock as the minute changes
+static gint
+_status_bar_clock_timeout(void *data)
 {
-    int active_pos = 1 + ((num-1) * 3);
-    int cols = getmaxx(stdscr);
-    mvwaddch(status_bar, 0, cols - 34 + active_pos, ' ');
+    frame_mark_dirty(FRAME_STATUSBAR);
+    return _status_bar_clock_delay();
 }
 
-static void
-_status_bar_draw(void)
+static gint
+_status_bar_clock_delay(void)
 {
-    if (last_time != NULL) {
-        g_date_time_unref(last_time);
-    }
-    last_time = g_date_time_new_now_local();
-    gchar *date_fmt = g_date_time_format(last_time, "%H:%M");
-    assert(date_fmt != NULL);
-
-    int bracket_attrs = theme_attrs(THEME_STATUS_BRACKET);
-
-    wattron(status_bar, bracket_attrs);
-    mvwaddch(status_bar, 0, 1, '[');
-    wattroff(status_bar, bracket_attrs);
-    mvwprintw(status_bar, 0, 2, date_fmt);
-    wattron(status_bar, bracket_attrs);
-    mvwaddch(status_bar, 0, 7, ']');
-    wattroff(status_bar, bracket_attrs);
-    g_free(date_fmt);
+    GDateTime *now = g_date_time_new_now_local();
+    gint elapsed = g_date_time_get_seconds(now) * 1000;
+    g_date_time_unref(now);
 
-    _update_win_statuses();
-    wnoutrefresh(status_bar);
-    inp_put_back();
+    return 60000 - elapsed + 1;
 }
@@ -46,16 +46,23 @@
 #include "ui/inputwin.h"
 #include "ui/windows.h"
 #include "ui/window.h"
+#include "ui/frame.h"
 #include "roster_list.h"
 #include "chat_session.h"
+#include "timers.h"
+
+// how long a typing notification is shown without another
+#define TYPING_EXPIRY_MS 10000
 
 static WINDOW *win;
 static contact_presence_t current_presence;
 
 static gboolean typing;
-static GTimer *typing_elapsed;
+static ProfTimer typing_timer;
 
 static void _title_bar_draw(void);
+static void _title_bar_stop_typing(void);
+static gint _title_bar_typing_timeout(void *data);
 static void _show_self_presence(void);
 static void _show_contact_presence(ProfChatWin *chatwin);
 #ifdef HAVE_LIBOTR
@@ -78,19 +85,6 @@ create_title_bar(void)
 void
 title_bar_update_virtual(void)
 {
-    ProfWin *window = wins_get_current();
-    if (window->type != WIN_CONSOLE) {
-        if (typing_elapsed != NULL) {
-            gdouble seconds = g_timer_elapsed(typing_elapsed, NULL);
-
-            if (seconds >= 10) {
-                typing = FALSE;
-
-                g_timer_destroy(typing_elapsed);
-                typing_elapsed = NULL;
-            }
-        }
-    }
     _title_bar_draw();
 }
 
@@ -102,56 +96,68 @@ title_bar_resize(void)
     wresize(win, 1, cols);
     wbkgd(win, theme_attrs(THEME_TITLE_TEXT));
 
-    _title_bar_draw();
+    frame_mark_dirty(FRAME_TITLEBAR);
 }
 
 void
 title_bar_console(void)
 {
     werase(win);
-    if (typing_elapsed) {
-        g_timer_destroy(typing_elapsed);
-    }
-    typing_elapsed = NULL;
-    typing = FALSE;
+    _title_bar_stop_typing();
 
-    _title_bar_draw();
+    frame_mark_dirty(FRAME_TITLEBAR);
 }
 
 void
 title_bar_set_presence(contact_presence_t presence)
 {
     current_presence = presence;
-    _title_bar_draw();
+    frame_mark_dirty(FRAME_TITLEBAR);
 }
 
 void
 title_bar_switch(void)
 {
-    if (typing_elapsed != NULL) {
-        g_timer_destroy(typing_elapsed);
-        typing_elapsed = NULL;
-        typing = FALSE;
-    }
+    _title_bar_stop_typing();
 
-    _title_bar_draw();
+    frame_mark_dirty(FRAME_TITLEBAR);
 }
 
 void
 title_bar_set_typing(gboolean is_typing)
 {
     if (is_typing) {
-        if (typing_elapsed != NULL) {
-            g_timer_start(typing_elapsed);
+        if (typing_timer == NULL) {
+            typing_timer = timers_add("typing", TYPING_EXPIRY_MS, _title_bar_typing_timeout, NULL);
         } else {
-            typing_elapsed = g_timer_new();
+            timers_reset(typing_timer, TYPING_EXPIRY_MS);
         }
+    } else if (typing_timer != NULL) {
+        timers_reset(typing_timer, TIMER_STOP);
     }
 
     typing = is_typing;
 
+    frame_mark_dirty(FRAME_TITLEBAR);
+}
 
-    _title_bar_draw();
+static void
+_title_bar_stop_typing(void)
+{
+    if (typing_timer != NULL) {
+        timers_reset(typing_timer, TIMER_STOP);
+    }
+    typing = FALSE;
+}
+
+// the contact stopped typing without telling us
+static gint
+_title_bar_typing_timeout(void *data)
+{
+    typing = FALSE;
+    frame_mark_dirty(FRAME_TITLEBAR);
+
+    return TIMER_STOP;
 }
 
 static void
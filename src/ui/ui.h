@@ -55,6 +55,7 @@
 void ui_init(void);
 void ui_load_colours(void);
 void ui_update(void);
+void ui_update_now(void);
 void ui_close(void);
 void ui_redraw(void);
 void ui_resize(void);
@@ -62,6 +63,8 @@ GSList* ui_get_chat_recipients(void);
 gboolean ui_switch_win(const int i);
 void ui_next_win(void);
 void ui_previous_win(void);
+void ui_next_unread_win(void);
+void ui_next_mention_win(void);
 
 void ui_gone_secure(const char * const barejid, gboolean trusted);
 void ui_gone_insecure(const char * const barejid);
@@ -87,6 +90,7 @@ void ui_new_chat_win(const char * const barejid);
 void ui_new_private_win(const char * const fulljid);
 void ui_print_system_msg_from_recipient(const char * const barejid, const char *message);
 gint ui_unread(void);
+gint ui_mentions(void);
 void ui_close_connected_win(int index);
 int ui_close_all_wins(void);
 int ui_close_read_wins(void);
@@ -184,6 +188,7 @@ void ui_group_removed(const char * const contact, const char * const group);
 void ui_chat_win_contact_online(PContact contact, Resource *resource, GDateTime *last_activity);
 void ui_chat_win_contact_offline(PContact contact, char *resource, char *status);
 void ui_contact_offline(char *barejid, char *resource, char *status);
+void ui_contact_presence_changed(const char * const barejid);
 void ui_handle_recipient_not_found(const char * const recipient, const char * const err_msg);
 void ui_handle_recipient_error(const char * const recipient, const char * const err_msg);
 void ui_handle_error(const char * const err_msg);
@@ -229,7 +234,6 @@ void ui_statusbar_new(const int win);
 
 char * ui_readline(void);
 void ui_input_clear(void);
-void ui_input_nonblocking(gboolean);
 
 void ui_invalid_command_usage(const char * const usage, void (*setting_func)(void));
 
@@ -263,6 +267,8 @@ void cons_show_contacts(GSList * list);
 void cons_show_roster(GSList * list);
 void cons_show_roster_group(const char * const group, GSList * list);
 void cons_show_wins(void);
+void cons_show_stats(void);
+void cons_show_timers(void);
 void cons_show_status(const char * const barejid);
 void cons_show_info(PContact pcontact);
 void cons_show_caps(const char * const fulljid, resource_presence_t presence);
@@ -297,10 +303,12 @@ void cons_occupants_setting(void);
 void cons_roster_setting(void);
 void cons_presence_setting(void);
 void cons_wrap_setting(void);
+void cons_fuzzy_setting(void);
 void cons_time_setting(void);
 void cons_mouse_setting(void);
 void cons_statuses_setting(void);
 void cons_titlebar_setting(void);
+void cons_frame_rate_setting(void);
 void cons_notify_setting(void);
 void cons_show_desktop_prefs(void);
 void cons_states_setting(void);
@@ -316,13 +324,14 @@ void cons_reconnect_setting(void);
 void cons_autoping_setting(void);
 void cons_priority_setting(void);
 void cons_autoconnect_setting(void);
-void cons_inpblock_setting(void);
 void cons_show_contact_online(PContact contact, Resource *resource, GDateTime *last_activity);
 void cons_show_contact_offline(PContact contact, char *resource, char *status);
 void cons_theme_colours(void);
 
 // roster window
 void rosterwin_roster(void);
+void rosterwin_draw(ProfLayoutSplit *layout);
+void rosterwin_forget(void);
 
 // occupants window
 void occupantswin_occupants(const char * const room);
@@ -335,7 +344,7 @@ void notify_typing(const char * const handle);
 void notify_message(const char * const handle, int win, const char * const text);
 void notify_room_message(const char * const handle, const char * const room,
     int win, const char * const text);
-void notify_remind(void);
+void notify_remind_reset(void);
 void notify_invite(const char * const from, const char * const room,
     const char * const reason);
 void notify_subscription(const char * const from);
@@ -32,6 +32,7 @@
  *
  */
 
+#define _XOPEN_SOURCE_EXTENDED
 #include "config.h"
 
 #include <stdlib.h>
@@ -50,16 +51,21 @@
 #include "roster_list.h"
 #include "ui/ui.h"
 #include "ui/window.h"
+#include "ui/windows.h"
+#include "ui/frame.h"
 #include "xmpp/xmpp.h"
+#include "tools/intern.h"
 
 #define CONS_WIN_TITLE "Profanity. Type /help for help information."
 #define XML_WIN_TITLE "XML Console"
 
 #define CEILING(X) (X-(int)(X) > 0 ? (int)(X+1) : (int)(X))
 
-static void _win_print(ProfWin *window, const char show_char, GDateTime *time,
-    int flags, theme_item_t theme_item, const char * const from, const char * const message);
-static void _win_print_wrapped(WINDOW *win, const char * const message);
+static void _win_print(WINDOW *win, ProfBuffEntry *e);
+static void _win_print_wrapped(WINDOW *win, ProfBuffEntry *e, const char * const message);
+static void _win_render(ProfWin *window, int start);
+static int _win_render_earlier(ProfWin *window, int lines);
+static void _win_make_room(ProfWin *window);
 
 int
 win_roster_cols(void)
@@ -77,37 +83,33 @@ win_occpuants_cols(void)
     return CEILING( (((double)cols) / 100) * occupants_win_percent);
 }
 
+// pads are not allocated when a window is created, see win_load_pad
 static ProfLayout*
-_win_create_simple_layout(void)
+_win_create_simple_layout(int buffer_capacity)
 {
-    int cols = getmaxx(stdscr);
-
     ProfLayoutSimple *layout = malloc(sizeof(ProfLayoutSimple));
     layout->base.type = LAYOUT_SIMPLE;
-    layout->base.win = newpad(PAD_SIZE, cols);
-    wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-    layout->base.buffer = buffer_create();
+    layout->base.win = NULL;
+    layout->base.buffer = buffer_create_with_capacity(buffer_capacity);
     layout->base.y_pos = 0;
     layout->base.paged = 0;
-    scrollok(layout->base.win, TRUE);
+    layout->base.buff_rendered = 0;
 
     return &layout->base;
 }
 
 static ProfLayout*
-_win_create_split_layout(void)
+_win_create_split_layout(int buffer_capacity)
 {
-    int cols = getmaxx(stdscr);
-
     ProfLayoutSplit *layout = malloc(sizeof(ProfLayoutSplit));
     layout->base.type = LAYOUT_SPLIT;
-    layout->base.win = newpad(PAD_SIZE, cols);
-    wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-    layout->base.buffer = buffer_create();
+    layout->base.win = NULL;
+    layout->base.buffer = buffer_create_with_capacity(buffer_capacity);
     layout->base.y_pos = 0;
     layout->base.paged = 0;
-    scrollok(layout->base.win, TRUE);
+    layout->base.buff_rendered = 0;
     layout->subwin = NULL;
+    layout->subwin_shown = FALSE;
     layout->sub_y_pos = 0;
     layout->memcheck = LAYOUT_SPLIT_MEMCHECK;
 
@@ -119,7 +121,7 @@ win_create_console(void)
 {
     ProfConsoleWin *new_win = malloc(sizeof(ProfConsoleWin));
     new_win->window.type = WIN_CONSOLE;
-    new_win->window.layout = _win_create_split_layout();
+    new_win->window.layout = _win_create_split_layout(BUFF_SIZE_CONSOLE);
 
     return &new_win->window;
 }
@@ -129,15 +131,15 @@ win_create_chat(const char * const barejid)
 {
     ProfChatWin *new_win = malloc(sizeof(ProfChatWin));
     new_win->window.type = WIN_CHAT;
-    new_win->window.layout = _win_create_simple_layout();
+    new_win->window.layout = _win_create_simple_layout(BUFF_SIZE_CHAT);
 
-    new_win->barejid = strdup(barejid);
+    new_win->barejid = (char*)intern_ref(barejid);
     new_win->resource_override = NULL;
     new_win->is_otr = FALSE;
     new_win->is_trusted = FALSE;
     new_win->history_shown = FALSE;
     new_win->unread = 0;
-    new_win->state = chat_state_new();
+    new_win->state = chat_state_new(barejid);
 
     new_win->memcheck = PROFCHATWIN_MEMCHECK;
 
@@ -148,34 +150,15 @@ ProfWin*
 win_create_muc(const char * const roomjid)
 {
     ProfMucWin *new_win = malloc(sizeof(ProfMucWin));
-    int cols = getmaxx(stdscr);
-
     new_win->window.type = WIN_MUC;
+    new_win->window.layout = _win_create_split_layout(BUFF_SIZE_MUC);
 
-    ProfLayoutSplit *layout = malloc(sizeof(ProfLayoutSplit));
-    layout->base.type = LAYOUT_SPLIT;
-
-    if (prefs_get_boolean(PREF_OCCUPANTS)) {
-        int subwin_cols = win_occpuants_cols();
-        layout->base.win = newpad(PAD_SIZE, cols - subwin_cols);
-        wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-        layout->subwin = newpad(PAD_SIZE, subwin_cols);;
-        wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
-    } else {
-        layout->base.win = newpad(PAD_SIZE, (cols));
-        wbkgd(layout->base.win, theme_attrs(THEME_TEXT));
-        layout->subwin = NULL;
-    }
-    layout->sub_y_pos = 0;
-    layout->memcheck = LAYOUT_SPLIT_MEMCHECK;
-    layout->base.buffer = buffer_create();
-    layout->base.y_pos = 0;
-    layout->base.paged = 0;
-    scrollok(layout->base.win, TRUE);
-    new_win->window.layout = (ProfLayout*)layout;
+    ProfLayoutSplit *layout = (ProfLayoutSplit*)new_win->window.layout;
+    layout->subwin_shown = prefs_get_boolean(PREF_OCCUPANTS);
 
-    new_win->roomjid = strdup(roomjid);
+    new_win->roomjid = (char*)intern_ref(roomjid);
     new_win->unread = 0;
+    new_win->mentions = 0;
 
     new_win->memcheck = PROFMUCWIN_MEMCHECK;
 
@@ -187,9 +170,9 @@ win_create_muc_config(const char * const roomjid, DataForm *form)
 {
     ProfMucConfWin *new_win = malloc(sizeof(ProfMucConfWin));
     new_win->window.type = WIN_MUC_CONFIG;
-    new_win->window.layout = _win_create_simple_layout();
+    new_win->window.layout = _win_create_simple_layout(BUFF_SIZE_MUC_CONFIG);
 
-    new_win->roomjid = strdup(roomjid);
+    new_win->roomjid = (char*)intern_ref(roomjid);
     new_win->form = form;
 
     new_win->memcheck = PROFCONFWIN_MEMCHECK;
@@ -202,9 +185,9 @@ win_create_private(const char * const fulljid)
 {
     ProfPrivateWin *new_win = malloc(sizeof(ProfPrivateWin));
     new_win->window.type = WIN_PRIVATE;
-    new_win->window.layout = _win_create_simple_layout();
+    new_win->window.layout = _win_create_simple_layout(BUFF_SIZE_PRIVATE);
 
-    new_win->fulljid = strdup(fulljid);
+    new_win->fulljid = (char*)intern_ref(fulljid);
     new_win->unread = 0;
 
     new_win->memcheck = PROFPRIVATEWIN_MEMCHECK;
@@ -217,7 +200,7 @@ win_create_xmlconsole(void)
 {
     ProfXMLWin *new_win = malloc(sizeof(ProfXMLWin));
     new_win->window.type = WIN_XML;
-    new_win->window.layout = _win_create_simple_layout();
+    new_win->window.layout = _win_create_simple_layout(BUFF_SIZE_XML);
 
     new_win->memcheck = PROFXMLWIN_MEMCHECK;
 
@@ -273,6 +256,18 @@ win_get_title(ProfWin *window)
     return NULL;
 }
 
+static int
+_win_subwin_cols(ProfWin *window)
+{
+    if (window->type == WIN_MUC) {
+        return win_occpuants_cols();
+    } else if (window->type == WIN_CONSOLE) {
+        return win_roster_cols();
+    } else {
+        return 0;
+    }
+}
+
 void
 win_hide_subwin(ProfWin *window)
 {
@@ -280,17 +275,22 @@ win_hide_subwin(ProfWin *window)
         ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
         if (layout->subwin) {
             delwin(layout->subwin);
+            if (window->type == WIN_CONSOLE) {
+                rosterwin_forget();
+            }
         }
         layout->subwin = NULL;
+        layout->subwin_shown = FALSE;
         layout->sub_y_pos = 0;
-        int cols = getmaxx(stdscr);
-        wresize(layout->base.win, PAD_SIZE, cols);
-        win_redraw(window);
-    } else {
-        int cols = getmaxx(stdscr);
-        wresize(window->layout->win, PAD_SIZE, cols);
-        win_redraw(window);
     }
+
+    if (window->layout->win == NULL) {
+        return;
+    }
+
+    int cols = getmaxx(stdscr);
+    wresize(window->layout->win, PAD_SIZE, cols);
+    win_redraw(window);
 }
 
 void
@@ -303,56 +303,144 @@ win_show_subwin(ProfWin *window)
         return;
     }
 
-    if (window->type == WIN_MUC) {
-        subwin_cols = win_occpuants_cols();
-    } else if (window->type == WIN_CONSOLE) {
-        subwin_cols = win_roster_cols();
+    ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
+    layout->subwin_shown = TRUE;
+
+    // created with the rest of the pads when the window is next focused
+    if (layout->base.win == NULL) {
+        return;
     }
 
-    ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
+    subwin_cols = _win_subwin_cols(window);
     layout->subwin = newpad(PAD_SIZE, subwin_cols);
     wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
     wresize(layout->base.win, PAD_SIZE, cols - subwin_cols);
     win_redraw(window);
 }
 
+gboolean
+win_has_pad(ProfWin *window)
+{
+    return (window->layout->win != NULL);
+}
+
+// allocate the pads of a window and render them from its buffer
 void
-win_free(ProfWin* window)
+win_load_pad(ProfWin *window)
+{
+    if (window->layout->win) {
+        return;
+    }
+
+    int cols = getmaxx(stdscr);
+    int subwin_cols = 0;
+
+    if (window->layout->type == LAYOUT_SPLIT) {
+        ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
+        if (layout->subwin_shown) {
+            subwin_cols = _win_subwin_cols(window);
+            layout->subwin = newpad(PAD_SIZE, subwin_cols);
+            wbkgd(layout->subwin, theme_attrs(THEME_TEXT));
+        }
+    }
+
+    window->layout->win = newpad(PAD_SIZE, cols - subwin_cols);
+    wbkgd(window->layout->win, theme_attrs(THEME_TEXT));
+    scrollok(window->layout->win, TRUE);
+    window->layout->paged = 0;
+    win_redraw(window);
+
+    if (subwin_cols > 0) {
+        if (window->type == WIN_MUC) {
+            ProfMucWin *mucwin = (ProfMucWin*)window;
+            assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+            occupantswin_occupants(mucwin->roomjid);
+        } else if (window->type == WIN_CONSOLE) {
+            rosterwin_roster();
+        }
+    }
+}
+
+// free the pads of a window, the buffer is kept so they can be
+// rendered again by win_load_pad
+void
+win_unload_pad(ProfWin *window)
 {
     if (window->layout->type == LAYOUT_SPLIT) {
         ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
         if (layout->subwin) {
             delwin(layout->subwin);
+            layout->subwin = NULL;
+            if (window->type == WIN_CONSOLE) {
+                rosterwin_forget();
+            }
         }
-        buffer_free(layout->base.buffer);
-        delwin(layout->base.win);
-    } else {
-        buffer_free(window->layout->buffer);
+        layout->sub_y_pos = 0;
+    }
+
+    if (window->layout->win) {
         delwin(window->layout->win);
+        window->layout->win = NULL;
+    }
+    window->layout->y_pos = 0;
+    window->layout->paged = 0;
+    window->layout->buff_rendered = 0;
+}
+
+// approximate memory used by the pads of a window
+long
+win_pad_bytes(ProfWin *window)
+{
+    long cells = 0;
+
+    if (window->layout->win) {
+        cells += (long)getmaxy(window->layout->win) * getmaxx(window->layout->win);
+    }
+    if (window->layout->type == LAYOUT_SPLIT) {
+        ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
+        if (layout->subwin) {
+            cells += (long)getmaxy(layout->subwin) * getmaxx(layout->subwin);
+        }
     }
+
+    return cells * sizeof(cchar_t);
+}
+
+// memory used by the pads of a loaded window at the current terminal width
+long
+win_pad_bytes_loaded(void)
+{
+    return (long)PAD_SIZE * getmaxx(stdscr) * sizeof(cchar_t);
+}
+
+void
+win_free(ProfWin* window)
+{
+    win_unload_pad(window);
+    buffer_free(window->layout->buffer);
     free(window->layout);
 
     if (window->type == WIN_CHAT) {
         ProfChatWin *chatwin = (ProfChatWin*)window;
-        free(chatwin->barejid);
+        intern_unref(chatwin->barejid);
         free(chatwin->resource_override);
         chat_state_free(chatwin->state);
     }
 
     if (window->type == WIN_MUC) {
         ProfMucWin *mucwin = (ProfMucWin*)window;
-        free(mucwin->roomjid);
+        intern_unref(mucwin->roomjid);
     }
 
     if (window->type == WIN_MUC_CONFIG) {
         ProfMucConfWin *mucconf = (ProfMucConfWin*)window;
-        free(mucconf->roomjid);
+        intern_unref(mucconf->roomjid);
         form_destroy(mucconf->form);
     }
 
     if (window->type == WIN_PRIVATE) {
         ProfPrivateWin *privatewin = (ProfPrivateWin*)window;
-        free(privatewin->fulljid);
+        intern_unref(privatewin->fulljid);
     }
 
     free(window);
@@ -389,16 +477,22 @@ win_handle_page(ProfWin *window, const wint_t ch, const int result)
                         *page_start = y - page_space;
 
                     window->layout->paged = 1;
-                    win_update_virtual(window);
+                    frame_mark_dirty(FRAME_WINDOW);
                 } else if (mouse_event.bstate & BUTTON4_PRESSED) { // mouse wheel up
                     *page_start -= 4;
 
+                    // went past beginning, render earlier lines from the buffer
+                    if (*page_start < 0) {
+                        *page_start += _win_render_earlier(window, -(*page_start));
+                        y = getcury(window->layout->win);
+                    }
+
                     // went past beginning, show first page
                     if (*page_start < 0)
                         *page_start = 0;
 
                     window->layout->paged = 1;
-                    win_update_virtual(window);
+                    frame_mark_dirty(FRAME_WINDOW);
                 }
             }
         }
@@ -408,12 +502,18 @@ win_handle_page(ProfWin *window, const wint_t ch, const int result)
     if (ch == KEY_PPAGE) {
         *page_start -= page_space;
 
+        // went past beginning, render earlier lines from the buffer
+        if (*page_start < 0) {
+            *page_start += _win_render_earlier(window, -(*page_start));
+            y = getcury(window->layout->win);
+        }
+
         // went past beginning, show first page
         if (*page_start < 0)
             *page_start = 0;
 
         window->layout->paged = 1;
-        win_update_virtual(window);
+        frame_mark_dirty(FRAME_WINDOW);
 
     // page down
     } else if (ch == KEY_NPAGE) {
@@ -428,7 +528,7 @@ win_handle_page(ProfWin *window, const wint_t ch, const int result)
             *page_start = y - page_space - 1;
 
         window->layout->paged = 1;
-        win_update_virtual(window);
+        frame_mark_dirty(FRAME_WINDOW);
     }
 
     // switch off page if last line and space line visible
@@ -449,7 +549,7 @@ win_handle_page(ProfWin *window, const wint_t ch, const int result)
             if (*sub_y_pos < 0)
                 *sub_y_pos = 0;
 
-            win_update_virtual(window);
+            frame_mark_dirty(FRAME_WINDOW);
 
         // alt down arrow
         } else if ((result == KEY_CODE_YES) && ((ch == 524) || (ch == 336))) {
@@ -463,7 +563,7 @@ win_handle_page(ProfWin *window, const wint_t ch, const int result)
             else if (*sub_y_pos >= sub_y)
                 *sub_y_pos = sub_y - page_space - 1;
 
-            win_update_virtual(window);
+            frame_mark_dirty(FRAME_WINDOW);
         }
     }
 }
@@ -471,6 +571,10 @@ win_handle_page(ProfWin *window, const wint_t ch, const int result)
 void
 win_update_virtual(ProfWin *window)
 {
+    if (window->layout->win == NULL) {
+        return;
+    }
+
     int rows, cols;
     getmaxyx(stdscr, rows, cols);
     int subwin_cols = 0;
@@ -478,11 +582,10 @@ win_update_virtual(ProfWin *window)
     if (window->layout->type == LAYOUT_SPLIT) {
         ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
         if (layout->subwin) {
-            if (window->type == WIN_MUC) {
-                subwin_cols = win_occpuants_cols();
-            } else {
-                subwin_cols = win_roster_cols();
+            if (window->type == WIN_CONSOLE) {
+                rosterwin_draw(layout);
             }
+            subwin_cols = _win_subwin_cols(window);
             pnoutrefresh(layout->base.win, layout->base.y_pos, 0, 1, 0, rows-3, (cols-subwin_cols)-1);
             pnoutrefresh(layout->subwin, layout->sub_y_pos, 0, 1, (cols-subwin_cols), rows-3, cols-1);
         } else {
@@ -845,18 +948,28 @@ void
 win_save_print(ProfWin *window, const char show_char, GTimeVal *tstamp,
     int flags, theme_item_t theme_item, const char * const from, const char * const message)
 {
-    GDateTime *time;
+    gint64 time;
 
     if (tstamp == NULL) {
-        time = g_date_time_new_now_local();
+        time = g_get_real_time();
     } else {
-        time = g_date_time_new_from_timeval_utc(tstamp);
+        time = (gint64)tstamp->tv_sec * G_USEC_PER_SEC + tstamp->tv_usec;
     }
 
-    buffer_push(window->layout->buffer, show_char, time, flags, theme_item, from, message);
-    _win_print(window, show_char, time, flags, theme_item, from, message);
-    // TODO: cross-reference.. this should be replaced by a real event-based system
-    ui_input_nonblocking(TRUE);
+    // windows without a pad only buffer, they are rendered when loaded
+    if (window->layout->win == NULL) {
+        buffer_push(window->layout->buffer, show_char, time, flags, theme_item, from, message);
+    } else {
+        _win_make_room(window);
+        buffer_push(window->layout->buffer, show_char, time, flags, theme_item, from, message);
+        int size = buffer_size(window->layout->buffer);
+        _win_print(window->layout->win, buffer_yield_entry(window->layout->buffer, size - 1));
+        window->layout->buff_rendered++;
+
+        if (wins_is_current(window)) {
+            frame_mark_dirty(FRAME_WINDOW);
+        }
+    }
 }
 
 void
@@ -872,9 +985,14 @@ win_save_newline(ProfWin *window)
 }
 
 static void
-_win_print(ProfWin *window, const char show_char, GDateTime *time,
-    int flags, theme_item_t theme_item, const char * const from, const char * const message)
+_win_print(WINDOW *win, ProfBuffEntry *e)
 {
+    const char show_char = e->show_char;
+    int flags = e->flags;
+    theme_item_t theme_item = e->theme_item;
+    const char * const from = e->from;
+    const char * const message = e->message;
+
     // flags : 1st bit =  0/1 - me/not me
     //         2nd bit =  0/1 - date/no date
     //         3rd bit =  0/1 - eol/no eol
@@ -886,21 +1004,27 @@ _win_print(ProfWin *window, const char show_char, GDateTime *time,
 
     if ((flags & NO_DATE) == 0) {
         gchar *date_fmt = NULL;
-        char *time_pref = prefs_get_string(PREF_TIME);
+        const char *format = NULL;
+        const char *time_pref = prefs_peek_string(PREF_TIME);
         if (g_strcmp0(time_pref, "minutes") == 0) {
-            date_fmt = g_date_time_format(time, "%H:%M");
+            format = "%H:%M";
         } else if (g_strcmp0(time_pref, "seconds") == 0) {
-            date_fmt = g_date_time_format(time, "%H:%M:%S");
+            format = "%H:%M:%S";
+        }
+
+        if (format) {
+            GDateTime *time = g_date_time_new_from_unix_local(e->time / G_USEC_PER_SEC);
+            date_fmt = g_date_time_format(time, format);
+            g_date_time_unref(time);
         }
-        free(time_pref);
 
         if (date_fmt) {
             if ((flags & NO_COLOUR_DATE) == 0) {
-                wattron(window->layout->win, theme_attrs(THEME_TIME));
+                wattron(win, theme_attrs(THEME_TIME));
             }
-            wprintw(window->layout->win, "%s %c ", date_fmt, show_char);
+            wprintw(win, "%s %c ", date_fmt, show_char);
             if ((flags & NO_COLOUR_DATE) == 0) {
-                wattroff(window->layout->win, theme_attrs(THEME_TIME));
+                wattroff(win, theme_attrs(THEME_TIME));
             }
         }
         g_free(date_fmt);
@@ -915,118 +1039,279 @@ _win_print(ProfWin *window, const char show_char, GDateTime *time,
             colour = 0;
         }
 
-        wattron(window->layout->win, colour);
+        wattron(win, colour);
         if (strncmp(message, "/me ", 4) == 0) {
-            wprintw(window->layout->win, "*%s ", from);
+            wprintw(win, "*%s ", from);
             offset = 4;
             me_message = TRUE;
         } else {
-            wprintw(window->layout->win, "%s: ", from);
-            wattroff(window->layout->win, colour);
+            wprintw(win, "%s: ", from);
+            wattroff(win, colour);
         }
     }
 
     if (!me_message) {
-        wattron(window->layout->win, theme_attrs(theme_item));
+        wattron(win, theme_attrs(theme_item));
     }
 
     if (prefs_get_boolean(PREF_WRAP)) {
-        _win_print_wrapped(window->layout->win, message+offset);
+        _win_print_wrapped(win, e, message+offset);
     } else {
-        wprintw(window->layout->win, "%s", message+offset);
+        wprintw(win, "%s", message+offset);
     }
 
     if ((flags & NO_EOL) == 0) {
-        wprintw(window->layout->win, "\n");
+        wprintw(win, "\n");
     }
 
     if (me_message) {
-        wattroff(window->layout->win, colour);
+        wattroff(win, colour);
     } else {
-        wattroff(window->layout->win, theme_attrs(theme_item));
+        wattroff(win, theme_attrs(theme_item));
     }
 }
 
 static void
 _win_indent(WINDOW *win, int size)
 {
-    int i = 0;
-    for (i = 0; i < size; i++) {
-        waddch(win, ' ');
+    static const char spaces[] = "                ";
+    int max = sizeof(spaces) - 1;
+
+    while (size > 0) {
+        int n = size < max ? size : max;
+        waddnstr(win, spaces, n);
+        size -= n;
     }
 }
 
 static void
-_win_print_wrapped(WINDOW *win, const char * const message)
+_win_print_wrapped(WINDOW *win, ProfBuffEntry *e, const char * const message)
 {
-    int linei = 0;
-    int wordi = 0;
-    char *word = malloc(strlen(message) + 1);
-
-    char *time_pref = prefs_get_string(PREF_TIME);
+    const char *time_pref = prefs_peek_string(PREF_TIME);
     int indent = 0;
     if (g_strcmp0(time_pref, "minutes") == 0) {
         indent = 8;
     } else if (g_strcmp0(time_pref, "seconds") == 0) {
         indent = 11;
     }
-    free(time_pref);
 
-    while (message[linei] != '\0') {
-        if (message[linei] == ' ') {
-            waddch(win, ' ');
-            linei++;
-        } else if (message[linei] == '\n') {
+    int startx = getcurx(win);
+    int width = getmaxx(win);
+    if (indent >= width) {
+        indent = 0;
+    }
+
+    LineLayout *wrap = buffer_entry_wrap(e, message, startx, width, indent);
+
+    int pos = 0;
+    int i;
+    for (i = 0; i < wrap->count; i++) {
+        LineBreak *brk = &wrap->breaks[i];
+        if (brk->offset > pos) {
+            waddnstr(win, message + pos, brk->offset - pos);
+        }
+        pos = brk->offset;
+
+        switch (brk->type) {
+        case BREAK_NEWLINE:
+            pos++;
             waddch(win, '\n');
             _win_indent(win, indent);
-            linei++;
-        } else {
-            wordi = 0;
-            while (message[linei] != ' ' && message[linei] != '\n' && message[linei] != '\0') {
-                word[wordi++] = message[linei++];
-            }
-            word[wordi] = '\0';
-
-            int curx = getcurx(win);
-            int maxx = getmaxx(win);
-
-            // word larger than line
-            if (strlen(word) > (maxx - indent)) {
-                int i;
-                for (i = 0; i < wordi; i++) {
-                    curx = getcurx(win);
-                    if (curx < indent) {
-                        _win_indent(win, indent);
-                    }
-                    waddch(win, word[i]);
-                }
-            } else {
-                if (curx + strlen(word) > maxx) {
-                    waddch(win, '\n');
-                    _win_indent(win, indent);
-                }
-                if (curx < indent) {
-                    _win_indent(win, indent);
-                }
-                wprintw(win, "%s", word);
+            break;
+        case BREAK_WRAP:
+            waddch(win, '\n');
+            _win_indent(win, indent);
+            break;
+        case BREAK_INDENT:
+            _win_indent(win, indent);
+            break;
+        }
+    }
+
+    if (message[pos] != '\0') {
+        waddstr(win, message + pos);
+    }
+}
+
+// find the first buffer entry of the logical line that is lines complete
+// lines before end, entries with NO_EOL are joined with the entry that follows,
+// entries before the clear point are never included
+static int
+_win_line_start(ProfBuff buffer, int end, int lines)
+{
+    int cleared = buffer_cleared(buffer);
+    int found = 0;
+    int i = end - 1;
+
+    while (i >= cleared) {
+        ProfBuffEntry *e = buffer_yield_entry(buffer, i);
+        if ((e->flags & NO_EOL) == 0) {
+            if (found == lines) {
+                break;
             }
+            found++;
         }
+        i--;
     }
 
-    free(word);
+    return i + 1;
+}
+
+// make sure there is at least a screen of rows below the cursor of the pad
+static void
+_win_pad_grow(WINDOW *win)
+{
+    int rows = getmaxy(stdscr);
+    int maxy, maxx;
+    getmaxyx(win, maxy, maxx);
+
+    if (maxy - getcury(win) <= rows) {
+        wresize(win, maxy * 2, maxx);
+    }
+}
+
+// render the buffer entries from start to the end of the buffer into the pad
+static void
+_win_render(ProfWin *window, int start)
+{
+    ProfLayout *layout = window->layout;
+    int size = buffer_size(layout->buffer);
+
+    werase(layout->win);
+
+    int i;
+    for (i = start; i < size; i++) {
+        _win_pad_grow(layout->win);
+        _win_print(layout->win, buffer_yield_entry(layout->buffer, i));
+    }
+
+    layout->buff_rendered = size - start;
+}
+
+// render the lines before the first rendered entry above the current pad
+// contents, returns the number of rows inserted at the top of the pad
+static int
+_win_render_earlier(ProfWin *window, int lines)
+{
+    ProfLayout *layout = window->layout;
+    int size = buffer_size(layout->buffer);
+    int end = size - layout->buff_rendered;
+    if (end <= buffer_cleared(layout->buffer)) {
+        return 0;
+    }
+
+    int start = _win_line_start(layout->buffer, end, lines);
+    int rows = getmaxy(stdscr);
+    int maxy, cols;
+    getmaxyx(layout->win, maxy, cols);
+
+    WINDOW *scratch = newpad(rows * 2, cols);
+    wbkgd(scratch, theme_attrs(THEME_TEXT));
+    scrollok(scratch, TRUE);
+
+    int i;
+    for (i = start; i < end; i++) {
+        _win_pad_grow(scratch);
+        _win_print(scratch, buffer_yield_entry(layout->buffer, i));
+    }
+
+    int added = getcury(scratch);
+    if (getcurx(scratch) > 0) {
+        added++;
+    }
+
+    if (added > 0) {
+        int cury, curx;
+        getyx(layout->win, cury, curx);
+
+        int needed = cury + added + rows;
+        if (maxy < needed) {
+            wresize(layout->win, needed > maxy * 2 ? needed : maxy * 2, cols);
+        }
+
+        wmove(layout->win, 0, 0);
+        winsdelln(layout->win, added);
+        copywin(scratch, layout->win, 0, 0, 0, 0, added - 1, cols - 1, FALSE);
+        wmove(layout->win, cury + added, curx);
+    }
+    delwin(scratch);
+
+    layout->buff_rendered = size - start;
+
+    return added;
+}
+
+// called before printing a new entry, when the pad is nearly full it either
+// grows (when paged, to keep what the user is looking at) or is re-rendered
+// with only the last screen of lines
+static void
+_win_make_room(ProfWin *window)
+{
+    ProfLayout *layout = window->layout;
+    int rows = getmaxy(stdscr);
+    int maxy, cols;
+    getmaxyx(layout->win, maxy, cols);
+
+    if (maxy - getcury(layout->win) > rows) {
+        return;
+    }
+
+    if (layout->paged) {
+        _win_pad_grow(layout->win);
+    } else {
+        if (maxy > PAD_SIZE) {
+            wresize(layout->win, PAD_SIZE, cols);
+        }
+        int size = buffer_size(layout->buffer);
+        _win_render(window, _win_line_start(layout->buffer, size, rows));
+    }
 }
 
 void
 win_redraw(ProfWin *window)
 {
-    int i, size;
-    werase(window->layout->win);
-    size = buffer_size(window->layout->buffer);
+    ProfLayout *layout = window->layout;
+    if (layout->win == NULL) {
+        return;
+    }
 
-    for (i = 0; i < size; i++) {
-        ProfBuffEntry *e = buffer_yield_entry(window->layout->buffer, i);
-        _win_print(window, e->show_char, e->time, e->flags, e->theme_item, e->from, e->message);
+    int size = buffer_size(layout->buffer);
+    int start;
+
+    // keep the lines the user has scrolled back to, otherwise
+    // only render enough lines to fill the screen
+    if (layout->paged) {
+        start = size - layout->buff_rendered;
+        int cleared = buffer_cleared(layout->buffer);
+        if (start < cleared) {
+            start = cleared;
+        }
+    } else {
+        start = _win_line_start(layout->buffer, size, getmaxy(stdscr));
     }
+
+    _win_render(window, start);
+
+    if (!layout->paged) {
+        win_move_to_end(window);
+    }
+    frame_mark_dirty(FRAME_WINDOW);
+}
+
+void
+win_clear(ProfWin *window)
+{
+    // the buffer remembers the clear so redraws and reloads of the pad
+    // only render what was printed after it
+    buffer_mark_cleared(window->layout->buffer);
+    window->layout->buff_rendered = 0;
+
+    if (window->layout->win == NULL) {
+        return;
+    }
+
+    werase(window->layout->win);
+    frame_mark_dirty(FRAME_WINDOW);
 }
 
 gboolean
@@ -1034,7 +1319,7 @@ win_has_active_subwin(ProfWin *window)
 {
     if (window->layout->type == LAYOUT_SPLIT) {
         ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
-        return (layout->subwin != NULL);
+        return layout->subwin_shown;
     } else {
         return FALSE;
     }
@@ -1060,6 +1345,19 @@ win_unread(ProfWin *window)
     }
 }
 
+// unread room messages containing our nick
+int
+win_mentions(ProfWin *window)
+{
+    if (window->type == WIN_MUC) {
+        ProfMucWin *mucwin = (ProfMucWin*) window;
+        assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
+        return mucwin->mentions;
+    } else {
+        return 0;
+    }
+}
+
 void
 win_printline_nowrap(WINDOW *win, char *msg)
 {
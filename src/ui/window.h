@@ -59,6 +59,14 @@
 
 #define PAD_SIZE 1000
 
+// number of entries kept in the history buffer of each window type
+#define BUFF_SIZE_CONSOLE       BUFF_SIZE
+#define BUFF_SIZE_CHAT          BUFF_SIZE
+#define BUFF_SIZE_MUC           2000
+#define BUFF_SIZE_MUC_CONFIG    400
+#define BUFF_SIZE_PRIVATE       BUFF_SIZE
+#define BUFF_SIZE_XML           2000
+
 #define LAYOUT_SPLIT_MEMCHECK       12345671
 #define PROFCHATWIN_MEMCHECK        22374522
 #define PROFMUCWIN_MEMCHECK         52345276
@@ -77,6 +85,7 @@ typedef struct prof_layout_t {
     ProfBuff buffer;
     int y_pos;
     int paged;
+    int buff_rendered;
 } ProfLayout;
 
 typedef struct prof_layout_simple_t {
@@ -86,6 +95,7 @@ typedef struct prof_layout_simple_t {
 typedef struct prof_layout_split_t {
     ProfLayout base;
     WINDOW *subwin;
+    gboolean subwin_shown;
     int sub_y_pos;
     unsigned long memcheck;
 } ProfLayoutSplit;
@@ -108,6 +118,8 @@ typedef struct prof_console_win_t {
     ProfWin window;
 } ProfConsoleWin;
 
+// jids in chat, room and private windows are interned, see tools/intern.h
+
 typedef struct prof_chat_win_t {
     ProfWin window;
     char *barejid;
@@ -124,6 +136,7 @@ typedef struct prof_muc_win_t {
     ProfWin window;
     char *roomjid;
     int unread;
+    int mentions;
     unsigned long memcheck;
 } ProfMucWin;
 
@@ -173,7 +186,13 @@ void win_save_print(ProfWin *window, const char show_char, GTimeVal *tstamp, int
 void win_save_println(ProfWin *window, const char * const message);
 void win_save_newline(ProfWin *window);
 void win_redraw(ProfWin *window);
+void win_clear(ProfWin *window);
 void win_hide_subwin(ProfWin *window);
+gboolean win_has_pad(ProfWin *window);
+void win_load_pad(ProfWin *window);
+void win_unload_pad(ProfWin *window);
+long win_pad_bytes(ProfWin *window);
+long win_pad_bytes_loaded(void);
 void win_show_subwin(ProfWin *window);
 int win_roster_cols(void);
 int win_occpuants_cols(void);
@@ -181,6 +200,7 @@ void win_printline_nowrap(WINDOW *win, char *msg);
 void win_handle_page(ProfWin *current, const wint_t ch, const int result);
 
 int win_unread(ProfWin *window);
+int win_mentions(ProfWin *window);
 gboolean win_has_active_subwin(ProfWin *window);
 
 #endif
@@ -53,22 +53,161 @@
 #include "ui/statusbar.h"
 #include "ui/window.h"
 #include "ui/windows.h"
+#include "ui/frame.h"
+#include "tools/intern.h"
+#include "tools/intset.h"
+
+// maximum number of windows other than the console holding ncurses pads,
+// most recently focused first
+#define PAD_LRU_SIZE 5
 
 static GHashTable *windows;
+static GList *pad_lru;
 static int current;
 static int max_cols;
 
+// lookups into windows by interned jid and by window, the keys belong to
+// the windows
+static GHashTable *chat_wins;
+static GHashTable *muc_wins;
+static GHashTable *muc_conf_wins;
+static GHashTable *private_wins;
+static GHashTable *win_nums;
+
+// window numbers in the order they are shown, those with unread messages
+// and those with unread mentions, see win_num_to_order
+static IntSet win_order;
+static IntSet unread_wins;
+static IntSet mention_wins;
+
+// sums of unread messages and mentions over all windows
+static int total_unread;
+static int total_mentions;
+
+static void
+_wins_insert(int num, ProfWin *window)
+{
+    g_hash_table_insert(windows, GINT_TO_POINTER(num), window);
+    g_hash_table_insert(win_nums, window, GINT_TO_POINTER(num));
+    intset_add(win_order, win_num_to_order(num));
+    if (win_unread(window) > 0) {
+        intset_add(unread_wins, win_num_to_order(num));
+        total_unread += win_unread(window);
+    }
+    if (win_mentions(window) > 0) {
+        intset_add(mention_wins, win_num_to_order(num));
+        total_mentions += win_mentions(window);
+    }
+
+    switch (window->type)
+    {
+        case WIN_CHAT:
+            g_hash_table_insert(chat_wins, ((ProfChatWin*)window)->barejid, window);
+            break;
+        case WIN_MUC:
+            g_hash_table_insert(muc_wins, ((ProfMucWin*)window)->roomjid, window);
+            break;
+        case WIN_MUC_CONFIG:
+            g_hash_table_insert(muc_conf_wins, ((ProfMucConfWin*)window)->roomjid, window);
+            break;
+        case WIN_PRIVATE:
+            g_hash_table_insert(private_wins, ((ProfPrivateWin*)window)->fulljid, window);
+            break;
+        default:
+            break;
+    }
+}
+
+static void
+_wins_index_remove(GHashTable *index, const char * const key, ProfWin *window)
+{
+    if (g_hash_table_lookup(index, key) == window) {
+        g_hash_table_remove(index, key);
+    }
+}
+
+// take the window out of windows and the lookups without freeing it
+static ProfWin *
+_wins_steal(int num)
+{
+    ProfWin *window = g_hash_table_lookup(windows, GINT_TO_POINTER(num));
+    if (window == NULL) {
+        return NULL;
+    }
+
+    g_hash_table_steal(windows, GINT_TO_POINTER(num));
+    g_hash_table_remove(win_nums, window);
+    intset_remove(win_order, win_num_to_order(num));
+    intset_remove(unread_wins, win_num_to_order(num));
+    intset_remove(mention_wins, win_num_to_order(num));
+    total_unread -= win_unread(window);
+    total_mentions -= win_mentions(window);
+
+    switch (window->type)
+    {
+        case WIN_CHAT:
+            _wins_index_remove(chat_wins, ((ProfChatWin*)window)->barejid, window);
+            break;
+        case WIN_MUC:
+            _wins_index_remove(muc_wins, ((ProfMucWin*)window)->roomjid, window);
+            break;
+        case WIN_MUC_CONFIG:
+            _wins_index_remove(muc_conf_wins, ((ProfMucConfWin*)window)->roomjid, window);
+            break;
+        case WIN_PRIVATE:
+            _wins_index_remove(private_wins, ((ProfPrivateWin*)window)->fulljid, window);
+            break;
+        default:
+            break;
+    }
+
+    return window;
+}
+
+static void
+_wins_pad_lru_touch(ProfWin *window)
+{
+    win_load_pad(window);
+
+    // the console is written to from anywhere, it always keeps its pads
+    if (window->type == WIN_CONSOLE) {
+        return;
+    }
+
+    pad_lru = g_list_remove(pad_lru, window);
+    pad_lru = g_list_prepend(pad_lru, window);
+
+    if (g_list_length(pad_lru) > PAD_LRU_SIZE) {
+        GList *last = g_list_last(pad_lru);
+        win_unload_pad(last->data);
+        pad_lru = g_list_delete_link(pad_lru, last);
+    }
+}
+
 void
 wins_init(void)
 {
     windows = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL,
         (GDestroyNotify)win_free);
+    pad_lru = NULL;
+
+    chat_wins = g_hash_table_new(g_direct_hash, g_direct_equal);
+    muc_wins = g_hash_table_new(g_direct_hash, g_direct_equal);
+    muc_conf_wins = g_hash_table_new(g_direct_hash, g_direct_equal);
+    private_wins = g_hash_table_new(g_direct_hash, g_direct_equal);
+    win_nums = g_hash_table_new(g_direct_hash, g_direct_equal);
+    win_order = intset_new();
+    unread_wins = intset_new();
+    mention_wins = intset_new();
+    total_unread = 0;
+    total_mentions = 0;
 
     max_cols = getmaxx(stdscr);
     ProfWin *console = win_create_console();
-    g_hash_table_insert(windows, GINT_TO_POINTER(1), console);
+    _wins_insert(1, console);
 
     current = 1;
+    _wins_pad_lru_touch(console);
 }
 
 ProfWin *
@@ -80,89 +219,41 @@ wins_get_console(void)
 ProfChatWin *
 wins_get_chat(const char * const barejid)
 {
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
-
-    while (curr != NULL) {
-        ProfWin *window = curr->data;
-        if (window->type == WIN_CHAT) {
-            ProfChatWin *chatwin = (ProfChatWin*)window;
-            if (g_strcmp0(chatwin->barejid, barejid) == 0) {
-                g_list_free(values);
-                return chatwin;
-            }
-        }
-        curr = g_list_next(curr);
+    if (chat_wins == NULL || barejid == NULL) {
+        return NULL;
     }
 
-    g_list_free(values);
-    return NULL;
+    return g_hash_table_lookup(chat_wins, intern_lookup(barejid));
 }
 
 ProfMucConfWin *
 wins_get_muc_conf(const char * const roomjid)
 {
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
-
-    while (curr != NULL) {
-        ProfWin *window = curr->data;
-        if (window->type == WIN_MUC_CONFIG) {
-            ProfMucConfWin *confwin = (ProfMucConfWin*)window;
-            if (g_strcmp0(confwin->roomjid, roomjid) == 0) {
-                g_list_free(values);
-                return confwin;
-            }
-        }
-        curr = g_list_next(curr);
+    if (muc_conf_wins == NULL || roomjid == NULL) {
+        return NULL;
     }
 
-    g_list_free(values);
-    return NULL;
+    return g_hash_table_lookup(muc_conf_wins, intern_lookup(roomjid));
 }
 
 ProfMucWin *
 wins_get_muc(const char * const roomjid)
 {
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
-
-    while (curr != NULL) {
-        ProfWin *window = curr->data;
-        if (window->type == WIN_MUC) {
-            ProfMucWin *mucwin = (ProfMucWin*)window;
-            if (g_strcmp0(mucwin->roomjid, roomjid) == 0) {
-                g_list_free(values);
-                return mucwin;
-            }
-        }
-        curr = g_list_next(curr);
+    if (muc_wins == NULL || roomjid == NULL) {
+        return NULL;
     }
 
-    g_list_free(values);
-    return NULL;
+    return g_hash_table_lookup(muc_wins, intern_lookup(roomjid));
 }
 
 ProfPrivateWin *
 wins_get_private(const char * const fulljid)
 {
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
-
-    while (curr != NULL) {
-        ProfWin *window = curr->data;
-        if (window->type == WIN_PRIVATE) {
-            ProfPrivateWin *privatewin = (ProfPrivateWin*)window;
-            if (g_strcmp0(privatewin->fulljid, fulljid) == 0) {
-                g_list_free(values);
-                return privatewin;
-            }
-        }
-        curr = g_list_next(curr);
+    if (private_wins == NULL || fulljid == NULL) {
+        return NULL;
     }
 
-    g_list_free(values);
-    return NULL;
+    return g_hash_table_lookup(private_wins, intern_lookup(fulljid));
 }
 
 ProfWin *
@@ -255,6 +346,9 @@ wins_set_current_by_num(int i)
     ProfWin *window = g_hash_table_lookup(windows, GINT_TO_POINTER(i));
     if (window) {
         current = i;
+        _wins_pad_lru_touch(window);
+        total_unread -= win_unread(window);
+        total_mentions -= win_mentions(window);
         if (window->type == WIN_CHAT) {
             ProfChatWin *chatwin = (ProfChatWin*) window;
             assert(chatwin->memcheck == PROFCHATWIN_MEMCHECK);
@@ -263,10 +357,14 @@ wins_set_current_by_num(int i)
             ProfMucWin *mucwin = (ProfMucWin*) window;
             assert(mucwin->memcheck == PROFMUCWIN_MEMCHECK);
             mucwin->unread = 0;
+            mucwin->mentions = 0;
         } else if (window->type == WIN_PRIVATE) {
             ProfPrivateWin *privatewin = (ProfPrivateWin*) window;
             privatewin->unread = 0;
         }
+        intset_remove(unread_wins, win_num_to_order(i));
+        intset_remove(mention_wins, win_num_to_order(i));
+        frame_mark_dirty(FRAME_WINDOW | FRAME_TITLEBAR);
     }
 }
 
@@ -279,28 +377,13 @@ wins_get_by_num(int i)
 ProfWin *
 wins_get_next(void)
 {
-    // get and sort win nums
-    GList *keys = g_hash_table_get_keys(windows);
-    keys = g_list_sort(keys, cmp_win_num);
-    GList *curr = keys;
-
-    // find our place in the list
-    while (curr != NULL) {
-        if (current == GPOINTER_TO_INT(curr->data)) {
-            break;
-        }
-        curr = g_list_next(curr);
-    }
+    int next = intset_next(win_order, win_num_to_order(current));
 
     // if there is a next window return it
-    curr = g_list_next(curr);
-    if (curr != NULL) {
-        int next = GPOINTER_TO_INT(curr->data);
-        g_list_free(keys);
-        return wins_get_by_num(next);
+    if (next != INTSET_NONE) {
+        return wins_get_by_num(win_order_to_num(next));
     // otherwise return the first window (console)
     } else {
-        g_list_free(keys);
         return wins_get_console();
     }
 }
@@ -308,51 +391,106 @@ wins_get_next(void)
 ProfWin *
 wins_get_previous(void)
 {
-    // get and sort win nums
-    GList *keys = g_hash_table_get_keys(windows);
-    keys = g_list_sort(keys, cmp_win_num);
-    GList *curr = keys;
-
-    // find our place in the list
-    while (curr != NULL) {
-        if (current == GPOINTER_TO_INT(curr->data)) {
-            break;
-        }
-        curr = g_list_next(curr);
-    }
+    int previous = intset_prev(win_order, win_num_to_order(current));
 
     // if there is a previous window return it
-    curr = g_list_previous(curr);
-    if (curr != NULL) {
-        int previous = GPOINTER_TO_INT(curr->data);
-        g_list_free(keys);
-        return wins_get_by_num(previous);
+    if (previous != INTSET_NONE) {
+        return wins_get_by_num(win_order_to_num(previous));
     // otherwise return the last window
     } else {
-        int new_num = GPOINTER_TO_INT(g_list_last(keys)->data);
-        g_list_free(keys);
-        return wins_get_by_num(new_num);
+        return wins_get_by_num(win_order_to_num(intset_last(win_order)));
+    }
+}
+
+// the first window in the set after the current one, wrapping around to
+// the start, NULL when the set is empty
+static ProfWin *
+_wins_get_next_in(IntSet set)
+{
+    int next = intset_next(set, win_num_to_order(current));
+    if (next == INTSET_NONE) {
+        next = intset_first(set);
+    }
+
+    if (next == INTSET_NONE) {
+        return NULL;
+    } else {
+        return wins_get_by_num(win_order_to_num(next));
+    }
+}
+
+ProfWin *
+wins_get_next_unread(void)
+{
+    return _wins_get_next_in(unread_wins);
+}
+
+ProfWin *
+wins_get_next_mention(void)
+{
+    return _wins_get_next_in(mention_wins);
+}
+
+void
+wins_add_unread(ProfWin *window)
+{
+    switch (window->type)
+    {
+        case WIN_CHAT:
+            ((ProfChatWin*)window)->unread++;
+            break;
+        case WIN_MUC:
+            ((ProfMucWin*)window)->unread++;
+            break;
+        case WIN_PRIVATE:
+            ((ProfPrivateWin*)window)->unread++;
+            break;
+        default:
+            return;
+    }
+
+    int num = wins_get_num(window);
+    if (num != -1) {
+        intset_add(unread_wins, win_num_to_order(num));
+        total_unread++;
     }
 }
 
+void
+wins_add_mention(ProfWin *window)
+{
+    if (window->type != WIN_MUC) {
+        return;
+    }
+
+    ((ProfMucWin*)window)->mentions++;
+
+    int num = wins_get_num(window);
+    if (num != -1) {
+        intset_add(mention_wins, win_num_to_order(num));
+        total_mentions++;
+    }
+}
+
+// the console is always window 1, so the first free number is the first
+// gap in the order after it
+static int
+_wins_next_available(void)
+{
+    return win_order_to_num(intset_first_gap(win_order, 1));
+}
+
 int
 wins_get_num(ProfWin *window)
 {
-    GList *keys = g_hash_table_get_keys(windows);
-    GList *curr = keys;
+    gpointer num_p = NULL;
 
-    while (curr != NULL) {
-        gconstpointer num_p = curr->data;
-        ProfWin *curr_win = g_hash_table_lookup(windows, num_p);
-        if (curr_win == window) {
-            g_list_free(keys);
-            return GPOINTER_TO_INT(num_p);
-        }
-        curr = g_list_next(curr);
+    // window 10 is stored as 0, so look up the key rather than the value
+    if (g_hash_table_lookup_extended(win_nums, window, NULL, &num_p)) {
+        return GPOINTER_TO_INT(num_p);
+    } else {
+        return -1;
     }
-
-    g_list_free(keys);
-    return -1;
 }
 
 int
@@ -377,10 +515,15 @@ wins_close_by_num(int i)
         if (i == current) {
             current = 1;
             ProfWin *window = wins_get_current();
-            win_update_virtual(window);
+            _wins_pad_lru_touch(window);
+            frame_mark_dirty(FRAME_WINDOW | FRAME_TITLEBAR);
         }
 
-        g_hash_table_remove(windows, GINT_TO_POINTER(i));
+        ProfWin *closing = _wins_steal(i);
+        if (closing) {
+            pad_lru = g_list_remove(pad_lru, closing);
+            win_free(closing);
+        }
         status_bar_inactive(i);
     }
 }
@@ -389,8 +532,7 @@ void
 wins_clear_current(void)
 {
     ProfWin *window = wins_get_current();
-    werase(window->layout->win);
-    win_update_virtual(window);
+    win_clear(window);
 }
 
 gboolean
@@ -408,72 +550,82 @@ wins_is_current(ProfWin *window)
 ProfWin *
 wins_new_xmlconsole(void)
 {
-    GList *keys = g_hash_table_get_keys(windows);
-    int result = get_next_available_win_num(keys);
-    g_list_free(keys);
+    int result = _wins_next_available();
     ProfWin *newwin = win_create_xmlconsole();
-    g_hash_table_insert(windows, GINT_TO_POINTER(result), newwin);
+    _wins_insert(result, newwin);
     return newwin;
 }
 
 ProfWin *
 wins_new_chat(const char * const barejid)
 {
-    GList *keys = g_hash_table_get_keys(windows);
-    int result = get_next_available_win_num(keys);
-    g_list_free(keys);
+    int result = _wins_next_available();
     ProfWin *newwin = win_create_chat(barejid);
-    g_hash_table_insert(windows, GINT_TO_POINTER(result), newwin);
+    _wins_insert(result, newwin);
     return newwin;
 }
 
 ProfWin *
 wins_new_muc(const char * const roomjid)
 {
-    GList *keys = g_hash_table_get_keys(windows);
-    int result = get_next_available_win_num(keys);
-    g_list_free(keys);
+    int result = _wins_next_available();
     ProfWin *newwin = win_create_muc(roomjid);
-    g_hash_table_insert(windows, GINT_TO_POINTER(result), newwin);
+    _wins_insert(result, newwin);
     return newwin;
 }
 
 ProfWin *
 wins_new_muc_config(const char * const roomjid, DataForm *form)
 {
-    GList *keys = g_hash_table_get_keys(windows);
-    int result = get_next_available_win_num(keys);
-    g_list_free(keys);
+    int result = _wins_next_available();
     ProfWin *newwin = win_create_muc_config(roomjid, form);
-    g_hash_table_insert(windows, GINT_TO_POINTER(result), newwin);
+    _wins_insert(result, newwin);
     return newwin;
 }
 
 ProfWin *
 wins_new_private(const char * const fulljid)
 {
-    GList *keys = g_hash_table_get_keys(windows);
-    int result = get_next_available_win_num(keys);
-    g_list_free(keys);
+    int result = _wins_next_available();
     ProfWin *newwin = win_create_private(fulljid);
-    g_hash_table_insert(windows, GINT_TO_POINTER(result), newwin);
+    _wins_insert(result, newwin);
     return newwin;
 }
 
 int
 wins_get_total_unread(void)
 {
-    int result = 0;
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
+    return total_unread;
+}
 
-    while (curr != NULL) {
-        ProfWin *window = curr->data;
-        result += win_unread(window);
-        curr = g_list_next(curr);
+int
+wins_get_total_mentions(void)
+{
+    return total_mentions;
+}
+
+// numbers of windows with nothing unread in order, walking the window
+// order and the unread windows side by side
+GList *
+wins_get_read_nums(void)
+{
+    GList *result = NULL;
+    guint unread_index = 0;
+    guint unread_size = intset_size(unread_wins);
+    guint i;
+
+    for (i = 0; i < intset_size(win_order); i++) {
+        int order = intset_nth(win_order, i);
+        while (unread_index < unread_size && intset_nth(unread_wins, unread_index) < order) {
+            unread_index++;
+        }
+        if (unread_index < unread_size && intset_nth(unread_wins, unread_index) == order) {
+            continue;
+        }
+        result = g_list_prepend(result, GINT_TO_POINTER(win_order_to_num(order)));
     }
-    g_list_free(values);
-    return result;
+
+    return g_list_reverse(result);
 }
 
 void
@@ -487,6 +639,11 @@ wins_resize_all(void)
         ProfWin *window = curr->data;
         int subwin_cols = 0;
 
+        if (!win_has_pad(window)) {
+            curr = g_list_next(curr);
+            continue;
+        }
+
         if (window->layout->type == LAYOUT_SPLIT) {
             ProfLayoutSplit *layout = (ProfLayoutSplit*)window->layout;
             if (layout->subwin) {
@@ -510,45 +667,21 @@ wins_resize_all(void)
     }
     g_list_free(values);
 
-    ProfWin *current_win = wins_get_current();
-    win_update_virtual(current_win);
+    frame_mark_dirty(FRAME_WINDOW);
 }
 
 void
 wins_hide_subwin(ProfWin *window)
 {
-    int rows, cols;
-    getmaxyx(stdscr, rows, cols);
-
     win_hide_subwin(window);
-
-    ProfWin *current_win = wins_get_current();
-    if ((current_win->type == WIN_MUC) || (current_win->type == WIN_CONSOLE)) {
-        pnoutrefresh(current_win->layout->win, current_win->layout->y_pos, 0, 1, 0, rows-3, cols-1);
-    }
+    frame_mark_dirty(FRAME_WINDOW);
 }
 
 void
 wins_show_subwin(ProfWin *window)
 {
-    int rows, cols;
-    getmaxyx(stdscr, rows, cols);
-    int subwin_cols = 0;
-
     win_show_subwin(window);
-
-    ProfWin *current_win = wins_get_current();
-    if (current_win->type == WIN_MUC) {
-        ProfLayoutSplit *layout = (ProfLayoutSplit*)current_win->layout;
-        subwin_cols = win_occpuants_cols();
-        pnoutrefresh(layout->base.win, layout->base.y_pos, 0, 1, 0, rows-3, (cols-subwin_cols)-1);
-        pnoutrefresh(layout->subwin, layout->sub_y_pos, 0, 1, (cols-subwin_cols), rows-3, cols-1);
-    } else if (current_win->type == WIN_CONSOLE) {
-        ProfLayoutSplit *layout = (ProfLayoutSplit*)current_win->layout;
-        subwin_cols = win_roster_cols();
-        pnoutrefresh(layout->base.win, layout->base.y_pos, 0, 1, 0, rows-3, (cols-subwin_cols)-1);
-        pnoutrefresh(layout->subwin, layout->sub_y_pos, 0, 1, (cols-subwin_cols), rows-3, cols-1);
-    }
+    frame_mark_dirty(FRAME_WINDOW);
 }
 
 ProfXMLWin *
@@ -595,22 +728,21 @@ GSList *
 wins_get_prune_wins(void)
 {
     GSList *result = NULL;
-    GList *values = g_hash_table_get_values(windows);
-    GList *curr = values;
+    GList *read_nums = wins_get_read_nums();
+    GList *curr = read_nums;
 
     while (curr != NULL) {
-        ProfWin *window = curr->data;
-        if (win_unread(window) == 0 &&
-                window->type != WIN_MUC &&
+        ProfWin *window = wins_get_by_num(GPOINTER_TO_INT(curr->data));
+        if (window->type != WIN_MUC &&
                 window->type != WIN_MUC_CONFIG &&
                 window->type != WIN_XML &&
                 window->type != WIN_CONSOLE) {
-            result = g_slist_append(result, window);
+            result = g_slist_prepend(result, window);
         }
         curr = g_list_next(curr);
     }
-    g_list_free(values);
-    return result;
+    g_list_free(read_nums);
+    return g_slist_reverse(result);
 }
 
 void
@@ -623,11 +755,6 @@ wins_lost_connection(void)
         ProfWin *window = curr->data;
         if (window->type != WIN_CONSOLE) {
             win_save_print(window, '-', NULL, 0, THEME_ERROR, "", "Lost connection.");
-
-            // if current win, set current_win_dirty
-            if (wins_is_current(window)) {
-                win_update_virtual(window);
-            }
         }
         curr = g_list_next(curr);
     }
@@ -644,9 +771,9 @@ wins_swap(int source_win, int target_win)
 
         // target window empty
         if (target == NULL) {
-            g_hash_table_steal(windows, GINT_TO_POINTER(source_win));
+            _wins_steal(source_win);
             status_bar_inactive(source_win);
-            g_hash_table_insert(windows, GINT_TO_POINTER(target_win), source);
+            _wins_insert(target_win, source);
             if (win_unread(source) > 0) {
                 status_bar_new(target_win);
             } else {
@@ -659,10 +786,10 @@ wins_swap(int source_win, int target_win)
 
         // target window occupied
         } else {
-            g_hash_table_steal(windows, GINT_TO_POINTER(source_win));
-            g_hash_table_steal(windows, GINT_TO_POINTER(target_win));
-            g_hash_table_insert(windows, GINT_TO_POINTER(source_win), target);
-            g_hash_table_insert(windows, GINT_TO_POINTER(target_win), source);
+            _wins_steal(source_win);
+            _wins_steal(target_win);
+            _wins_insert(source_win, target);
+            _wins_insert(target_win, source);
             if (win_unread(source) > 0) {
                 status_bar_new(target_win);
             } else {
@@ -686,41 +813,36 @@ wins_swap(int source_win, int target_win)
 gboolean
 wins_tidy(void)
 {
-    gboolean tidy_required = FALSE;
-    // check for gaps
-    GList *keys = g_hash_table_get_keys(windows);
-    keys = g_list_sort(keys, cmp_win_num);
-
-    // get last used
-    GList *last = g_list_last(keys);
-    int last_num = GPOINTER_TO_INT(last->data);
-
-    // find first free num TODO - Will sort again
-    int next_available = get_next_available_win_num(keys);
-
     // found gap (next available before last window)
-    if (cmp_win_num(GINT_TO_POINTER(next_available), GINT_TO_POINTER(last_num)) < 0) {
-        tidy_required = TRUE;
-    }
-
-    if (tidy_required) {
+    if (intset_first_gap(win_order, 1) < intset_last(win_order)) {
         status_bar_set_all_inactive();
-        GHashTable *new_windows = g_hash_table_new_full(g_direct_hash,
-            g_direct_equal, NULL, (GDestroyNotify)win_free);
 
-        int num = 1;
+        GList *keys = NULL;
+        guint i;
+        for (i = 0; i < intset_size(win_order); i++) {
+            keys = g_list_append(keys, GINT_TO_POINTER(win_order_to_num(intset_nth(win_order, i))));
+        }
+
+        GList *tidy_wins = NULL;
         GList *curr = keys;
         while (curr != NULL) {
-            ProfWin *window = g_hash_table_lookup(windows, curr->data);
+            tidy_wins = g_list_append(tidy_wins, _wins_steal(GPOINTER_TO_INT(curr->data)));
+            curr = g_list_next(curr);
+        }
+
+        int num = 1;
+        curr = tidy_wins;
+        while (curr != NULL) {
+            ProfWin *window = curr->data;
             if (num == 10) {
-                g_hash_table_insert(new_windows, GINT_TO_POINTER(0), window);
+                _wins_insert(0, window);
                 if (win_unread(window) > 0) {
                     status_bar_new(0);
                 } else {
                     status_bar_active(0);
                 }
             } else {
-                g_hash_table_insert(new_windows, GINT_TO_POINTER(num), window);
+                _wins_insert(num, window);
                 if (win_unread(window) > 0) {
                     status_bar_new(num);
                 } else {
@@ -731,13 +853,12 @@ wins_tidy(void)
             curr = g_list_next(curr);
         }
 
-        windows = new_windows;
+        g_list_free(tidy_wins);
         current = 1;
         ui_switch_win(1);
         g_list_free(keys);
         return TRUE;
     } else {
-        g_list_free(keys);
         return FALSE;
     }
 }
@@ -859,5 +980,15 @@ wins_create_summary(void)
 void
 wins_destroy(void)
 {
+    g_list_free(pad_lru);
+    pad_lru = NULL;
+    g_hash_table_destroy(chat_wins);
+    g_hash_table_destroy(muc_wins);
+    g_hash_table_destroy(muc_conf_wins);
+    g_hash_table_destroy(private_wins);
+    g_hash_table_destroy(win_nums);
+    intset_free(win_order);
+    intset_free(unread_wins);
+    intset_free(mention_wins);
     g_hash_table_destroy(windows);
 }
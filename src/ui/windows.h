@@ -62,6 +62,10 @@ ProfWin * wins_get_by_num(int i);
 
 ProfWin * wins_get_next(void);
 ProfWin * wins_get_previous(void);
+ProfWin * wins_get_next_unread(void);
+void wins_add_unread(ProfWin *window);
+ProfWin * wins_get_next_mention(void);
+void wins_add_mention(ProfWin *window);
 int wins_get_num(ProfWin *window);
 int wins_get_current_num(void);
 void wins_close_current(void);
@@ -69,6 +73,8 @@ void wins_close_by_num(int i);
 void wins_clear_current(void);
 gboolean wins_is_current(ProfWin *window);
 int wins_get_total_unread(void);
+int wins_get_total_mentions(void);
+GList * wins_get_read_nums(void);
 void wins_resize_all(void);
 GSList * wins_get_chat_recipients(void);
 GSList * wins_get_prune_wins(void);
@@ -43,6 +43,7 @@
 #include "log.h"
 #include "muc.h"
 #include "server_events.h"
+#include "timers.h"
 #include "xmpp/connection.h"
 #include "xmpp/stanza.h"
 #include "xmpp/xmpp.h"
@@ -50,14 +51,16 @@
 #include "ui/ui.h"
 
 #define BOOKMARK_TIMEOUT 5000
+#define BOOKMARK_REQUEST_ID "bookmark_init_request"
 
 static Autocomplete bookmark_ac;
 static GList *bookmark_list;
+static ProfTimer request_timer;
 
 static int _bookmark_handle_result(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
-static int _bookmark_handle_delete(xmpp_conn_t * const conn,
-    void * const userdata);
+static gint _bookmark_request_timeout(void *data);
+static void _bookmark_request_cancel(void);
 static void _bookmark_item_destroy(gpointer item);
 static int _match_bookmark_by_jid(gconstpointer a, gconstpointer b);
 static void _send_bookmarks(void);
@@ -65,13 +68,9 @@ static void _send_bookmarks(void);
 void
 bookmark_request(void)
 {
-    char *id;
-    xmpp_conn_t *conn = connection_get_conn();
     xmpp_ctx_t *ctx = connection_get_ctx();
     xmpp_stanza_t *iq;
 
-    id = strdup("bookmark_init_request");
-
     autocomplete_free(bookmark_ac);
     bookmark_ac = autocomplete_new();
     if (bookmark_list != NULL) {
@@ -79,12 +78,14 @@ bookmark_request(void)
         bookmark_list = NULL;
     }
 
-    xmpp_timed_handler_add(conn, _bookmark_handle_delete, BOOKMARK_TIMEOUT, id);
-    xmpp_id_handler_add(conn, _bookmark_handle_result, id, id);
+    _bookmark_request_cancel();
+    request_timer = timers_add("bookmark request", BOOKMARK_TIMEOUT,
+        _bookmark_request_timeout, NULL);
+    connection_id_handler_add(_bookmark_handle_result, BOOKMARK_REQUEST_ID, NULL);
 
     iq = stanza_create_bookmarks_storage_request(ctx);
-    xmpp_stanza_set_id(iq, id);
-    xmpp_send(conn, iq);
+    xmpp_stanza_set_id(iq, BOOKMARK_REQUEST_ID);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -238,7 +239,6 @@ _bookmark_handle_result(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata)
 {
     xmpp_ctx_t *ctx = connection_get_ctx();
-    char *id = (char *)userdata;
     xmpp_stanza_t *ptr;
     xmpp_stanza_t *nick;
     xmpp_stanza_t *password_st;
@@ -250,8 +250,8 @@ _bookmark_handle_result(xmpp_conn_t * const conn,
     Jid *my_jid;
     Bookmark *item;
 
-    xmpp_timed_handler_delete(conn, _bookmark_handle_delete);
-    g_free(id);
+    timers_remove(request_timer);
+    request_timer = NULL;
 
     name = xmpp_stanza_get_name(stanza);
     if (!name || strcmp(name, STANZA_NAME_IQ) != 0) {
@@ -351,20 +351,24 @@ _bookmark_handle_result(xmpp_conn_t * const conn,
     return 0;
 }
 
-static int
-_bookmark_handle_delete(xmpp_conn_t * const conn,
-    void * const userdata)
+static gint
+_bookmark_request_timeout(void *data)
 {
-    char *id = (char *)userdata;
+    log_debug("Timeout for handler with id=%s", BOOKMARK_REQUEST_ID);
 
-    assert(id != NULL);
+    _bookmark_request_cancel();
 
-    log_debug("Timeout for handler with id=%s", id);
-
-    xmpp_id_handler_delete(conn, _bookmark_handle_result, id);
-    g_free(id);
+    return TIMER_STOP;
+}
 
-    return 0;
+static void
+_bookmark_request_cancel(void)
+{
+    if (request_timer != NULL) {
+        connection_id_handler_delete(_bookmark_handle_result, BOOKMARK_REQUEST_ID);
+        timers_remove(request_timer);
+        request_timer = NULL;
+    }
 }
 
 static void
@@ -394,7 +398,6 @@ _match_bookmark_by_jid(gconstpointer a, gconstpointer b)
 static void
 _send_bookmarks(void)
 {
-    xmpp_conn_t *conn = connection_get_conn();
     xmpp_ctx_t *ctx = connection_get_ctx();
 
     xmpp_stanza_t *iq = xmpp_stanza_new(ctx);
@@ -466,6 +469,6 @@ _send_bookmarks(void)
     xmpp_stanza_release(storage);
     xmpp_stanza_release(query);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
\ No newline at end of file
@@ -47,6 +47,7 @@
 
 #include "common.h"
 #include "log.h"
+#include "timers.h"
 #include "xmpp/xmpp.h"
 #include "xmpp/stanza.h"
 #include "xmpp/form.h"
@@ -58,12 +59,29 @@ static GKeyFile *cache;
 static GHashTable *jid_to_ver;
 static GHashTable *jid_to_caps;
 
+// how long a contact has to answer before the next one waiting is asked
+#define CAPS_REQUEST_TIMEOUT_MS 30000
+
+// an in flight disco#info for a ver, and the jids waiting on it
+typedef struct caps_request_t {
+    char *ver;
+    char *node;
+    char *id;
+    GSList *waiting;
+    ProfTimer timeout;
+} CapsRequest;
+
+// ver -> CapsRequest
+static GHashTable *ver_requests;
+
 static char *my_sha1;
 
 static gchar* _get_cache_file(void);
 static void _save_cache(void);
 static Capabilities * _caps_by_ver(const char * const ver);
 static Capabilities * _caps_by_jid(const char * const jid);
+static gint _request_timeout(void *data);
+static void _request_free(CapsRequest *request);
 Capabilities * _caps_copy(Capabilities *caps);
 
 void
@@ -82,6 +100,7 @@ caps_init(void)
 
     jid_to_ver = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_free);
     jid_to_caps = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)caps_destroy);
+    ver_requests = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, (GDestroyNotify)_request_free);
 
     my_sha1 = NULL;
 }
@@ -146,6 +165,102 @@ caps_contains(const char * const ver)
     return (g_key_file_has_group(cache, ver));
 }
 
+gboolean
+caps_request_pending(const char * const ver, const char * const node,
+    const char * const jid, const char * const id)
+{
+    CapsRequest *request = g_hash_table_lookup(ver_requests, ver);
+    if (request) {
+        request->waiting = g_slist_append(request->waiting, strdup(jid));
+        return TRUE;
+    }
+
+    // first request for this ver, the requester is mapped by the response
+    request = malloc(sizeof(CapsRequest));
+    request->ver = strdup(ver);
+    request->node = strdup(node);
+    request->id = strdup(id);
+    request->waiting = NULL;
+    request->timeout = timers_add("caps request", CAPS_REQUEST_TIMEOUT_MS,
+        _request_timeout, request);
+    g_hash_table_insert(ver_requests, strdup(ver), request);
+    return FALSE;
+}
+
+// the request with id was answered or timed out, when ver is still not cached
+// the next waiting contact is asked, so one bad client does not leave the
+// others without caps
+void
+caps_request_next(const char * const ver, const char * const id)
+{
+    CapsRequest *request = g_hash_table_lookup(ver_requests, ver);
+    if (!request) {
+        return;
+    }
+
+    if (caps_contains(ver)) {
+        GSList *curr = request->waiting;
+        while (curr) {
+            caps_map_jid_to_ver(curr->data, ver);
+            curr = g_slist_next(curr);
+        }
+        g_hash_table_remove(ver_requests, ver);
+        return;
+    }
+
+    // a late reply, the next contact was asked when it timed out
+    if (g_strcmp0(request->id, id) != 0) {
+        return;
+    }
+
+    if (!request->waiting) {
+        g_hash_table_remove(ver_requests, ver);
+        return;
+    }
+
+    GSList *next = request->waiting;
+    request->waiting = g_slist_remove_link(request->waiting, next);
+    char *jid = next->data;
+    g_slist_free_1(next);
+
+    log_info("Capabilities still not cached: %s, asking %s", ver, jid);
+    free(request->id);
+    request->id = create_unique_id("caps");
+    timers_reset(request->timeout, CAPS_REQUEST_TIMEOUT_MS);
+    iq_send_caps_request(jid, request->id, request->node, ver);
+    free(jid);
+}
+
+void
+caps_requests_clear(void)
+{
+    g_hash_table_remove_all(ver_requests);
+}
+
+static gint
+_request_timeout(void *data)
+{
+    CapsRequest *request = data;
+    log_info("Capabilities request timed out: %s", request->ver);
+
+    // asking the next contact resets the timer, when none are left the
+    // request and its timer are freed
+    caps_request_next(request->ver, request->id);
+
+    return TIMER_STOP;
+}
+
+static void
+_request_free(CapsRequest *request)
+{
+    timers_remove(request->timeout);
+    free(request->ver);
+    free(request->node);
+    free(request->id);
+    g_slist_free_full(request->waiting, free);
+    free(request);
+}
+
 static Capabilities *
 _caps_by_ver(const char * const ver)
 {
@@ -630,6 +745,8 @@ caps_close(void)
     cache = NULL;
     g_hash_table_destroy(jid_to_ver);
     g_hash_table_destroy(jid_to_caps);
+    caps_requests_clear();
+    g_hash_table_destroy(ver_requests);
 }
 
 void
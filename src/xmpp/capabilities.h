@@ -45,6 +45,10 @@ void caps_add_by_ver(const char * const ver, Capabilities *caps);
 void caps_add_by_jid(const char * const jid, Capabilities *caps);
 void caps_map_jid_to_ver(const char * const jid, const char * const ver);
 gboolean caps_contains(const char * const ver);
+gboolean caps_request_pending(const char * const ver, const char * const node,
+    const char * const jid, const char * const id);
+void caps_request_next(const char * const ver, const char * const id);
+void caps_requests_clear(void);
 
 char* caps_create_sha1_str(xmpp_stanza_t * const query);
 xmpp_stanza_t* caps_create_query_response_stanza(xmpp_ctx_t * const ctx);
@@ -46,11 +46,13 @@
 #include "muc.h"
 #include "profanity.h"
 #include "server_events.h"
+#include "timers.h"
 #include "xmpp/bookmark.h"
 #include "xmpp/capabilities.h"
 #include "xmpp/connection.h"
 #include "xmpp/iq.h"
 #include "xmpp/message.h"
+#include "xmpp/netthread.h"
 #include "xmpp/presence.h"
 #include "xmpp/roster.h"
 #include "xmpp/stanza.h"
@@ -65,6 +67,8 @@ static struct _jabber_conn_t {
     int priority;
     int tls_disabled;
     char *domain;
+    char *fulljid;      // our bound jid, jid_view points into it
+    JidView jid_view;
 } jabber_conn;
 
 static GHashTable *available_resources;
@@ -83,10 +87,14 @@ static struct {
     int port;
 } saved_details;
 
-static GTimer *reconnect_timer;
+static ProfTimer reconnect_timer;
+
+// stanza dumps are kept for the xml console whatever the log level
+static gboolean xmlconsole_open;
 
 static log_level_t _get_log_level(xmpp_log_level_t xmpp_level);
 static xmpp_log_level_t _get_xmpp_log_level();
+static xmpp_log_level_t _get_net_log_level(void);
 static void _xmpp_file_logger(void * const userdata,
     const xmpp_log_level_t level, const char * const area,
     const char * const msg);
@@ -95,6 +103,7 @@ static xmpp_log_t * _xmpp_get_file_logger();
 static jabber_conn_status_t _jabber_connect(const char * const fulljid,
     const char * const passwd, const char * const altdomain, int port);
 static void _jabber_reconnect(void);
+static gint _jabber_reconnect_timeout(void *data);
 
 static void _connection_handler(xmpp_conn_t * const conn,
     const xmpp_conn_event_t status, const int error,
@@ -103,6 +112,7 @@ static void _connection_handler(xmpp_conn_t * const conn,
 void _connection_free_saved_account(void);
 void _connection_free_saved_details(void);
 void _connection_free_session_data(void);
+static void _connection_set_jid(const char * const fulljid);
 
 void
 jabber_init(const int disable_tls)
@@ -114,6 +124,7 @@ jabber_init(const int disable_tls)
     jabber_conn.ctx = NULL;
     jabber_conn.tls_disabled = disable_tls;
     jabber_conn.domain = NULL;
+    jabber_conn.fulljid = NULL;
     presence_sub_requests_init();
     caps_init();
     available_resources = g_hash_table_new_full(g_str_hash, g_str_equal, free,
@@ -191,14 +202,15 @@ jabber_disconnect(void)
     if (jabber_conn.conn_status == JABBER_CONNECTED) {
         log_info("Closing connection");
         jabber_conn.conn_status = JABBER_DISCONNECTING;
-        xmpp_disconnect(jabber_conn.conn);
+        netthread_disconnect();
 
         while (jabber_get_connection_status() == JABBER_DISCONNECTING) {
-            jabber_process_events();
+            jabber_process_events(10);
         }
         _connection_free_saved_account();
         _connection_free_saved_details();
         _connection_free_session_data();
+        netthread_stop();
         if (jabber_conn.conn != NULL) {
             xmpp_conn_release(jabber_conn.conn);
             jabber_conn.conn = NULL;
@@ -207,11 +219,13 @@ jabber_disconnect(void)
             xmpp_ctx_free(jabber_conn.ctx);
             jabber_conn.ctx = NULL;
         }
+    } else {
+        netthread_stop();
     }
 
     jabber_conn.conn_status = JABBER_STARTED;
     FREE_SET_NULL(jabber_conn.presence_message);
-    FREE_SET_NULL(jabber_conn.domain);
+    _connection_set_jid(NULL);
 }
 
 void
@@ -220,34 +234,15 @@ jabber_shutdown(void)
     _connection_free_saved_account();
     _connection_free_saved_details();
     _connection_free_session_data();
+    netthread_stop();
     xmpp_shutdown();
     free(jabber_conn.log);
 }
 
 void
-jabber_process_events(void)
-{
-    int reconnect_sec;
-
-    switch (jabber_conn.conn_status)
-    {
-        case JABBER_CONNECTED:
-        case JABBER_CONNECTING:
-        case JABBER_DISCONNECTING:
-            xmpp_run_once(jabber_conn.ctx, 10);
-            break;
-        case JABBER_DISCONNECTED:
-            reconnect_sec = prefs_get_reconnect();
-            if ((reconnect_sec != 0) && (reconnect_timer != NULL)) {
-                int elapsed_sec = g_timer_elapsed(reconnect_timer, NULL);
-                if (elapsed_sec > reconnect_sec) {
-                    _jabber_reconnect();
-                }
-            }
-            break;
-        default:
-            break;
-    }
+jabber_process_events(int millis)
+{
+    netthread_process_events(millis);
 }
 
 GList *
@@ -262,6 +257,19 @@ jabber_get_connection_status(void)
     return (jabber_conn.conn_status);
 }
 
+int
+jabber_get_fd(void)
+{
+    return netthread_get_fd();
+}
+
+void
+jabber_set_xmlconsole(gboolean open)
+{
+    xmlconsole_open = open;
+    netthread_set_log_level(_get_net_log_level());
+}
+
 xmpp_conn_t *
 connection_get_conn(void)
 {
@@ -280,6 +288,26 @@ jabber_get_fulljid(void)
     return xmpp_conn_get_jid(jabber_conn.conn);
 }
 
+const char *
+jabber_get_barejid(void)
+{
+    if (jabber_conn.fulljid == NULL) {
+        return NULL;
+    }
+
+    return jabber_conn.jid_view.barejid;
+}
+
+const JidView *
+connection_get_jid_view(void)
+{
+    if (jabber_conn.fulljid == NULL) {
+        return NULL;
+    }
+
+    return &jabber_conn.jid_view;
+}
+
 const char *
 jabber_get_domain(void)
 {
@@ -325,6 +353,32 @@ connection_remove_available_resource(const char * const resource)
     g_hash_table_remove(available_resources, resource);
 }
 
+void
+connection_send(xmpp_stanza_t * const stanza)
+{
+    netthread_send(stanza);
+}
+
+void
+connection_handler_add(xmpp_handler func, const char * const ns,
+    const char * const name, const char * const type, void * const userdata)
+{
+    netthread_handler_add(func, ns, name, type, userdata);
+}
+
+void
+connection_id_handler_add(xmpp_handler func, const char * const id,
+    void * const userdata)
+{
+    netthread_id_handler_add(func, id, userdata);
+}
+
+void
+connection_id_handler_delete(xmpp_handler func, const char * const id)
+{
+    netthread_id_handler_delete(func, id);
+}
+
 void
 _connection_free_saved_account(void)
 {
@@ -349,6 +403,28 @@ _connection_free_session_data(void)
     presence_clear_sub_requests();
 }
 
+// parse our bound jid once per session, handlers compare against the view
+static void
+_connection_set_jid(const char * const fulljid)
+{
+    FREE_SET_NULL(jabber_conn.fulljid);
+    FREE_SET_NULL(jabber_conn.domain);
+
+    if (fulljid == NULL) {
+        return;
+    }
+
+    jabber_conn.fulljid = strdup(fulljid);
+    if (!jid_view_parse(&jabber_conn.jid_view, jabber_conn.fulljid)) {
+        log_error("Could not parse bound jid: %s", fulljid);
+        FREE_SET_NULL(jabber_conn.fulljid);
+        return;
+    }
+
+    jabber_conn.domain = g_strndup(jabber_conn.fulljid + jabber_conn.jid_view.domain_start,
+        jabber_conn.jid_view.domain_len);
+}
+
 static jabber_conn_status_t
 _jabber_connect(const char * const fulljid, const char * const passwd,
     const char * const altdomain, int port)
@@ -376,6 +452,7 @@ _jabber_connect(const char * const fulljid, const char * const passwd,
     }
     jabber_conn.log = _xmpp_get_file_logger();
 
+    netthread_stop();
     if (jabber_conn.conn != NULL) {
         xmpp_conn_release(jabber_conn.conn);
     }
@@ -398,13 +475,22 @@ _jabber_connect(const char * const fulljid, const char * const passwd,
         xmpp_conn_disable_tls(jabber_conn.conn);
     }
 
-    int connect_status = xmpp_connect_client(jabber_conn.conn, altdomain, port,
-        _connection_handler, jabber_conn.ctx);
+    netthread_set_log_level(_get_net_log_level());
+    int connect_status = netthread_connect(jabber_conn.ctx, jabber_conn.conn,
+        altdomain, port, _connection_handler, jabber_conn.log);
 
-    if (connect_status == 0)
+    if (connect_status == 0) {
+        // in place before the network thread reads anything, libstrophe
+        // holds them back until the stream is authenticated
+        roster_add_handlers();
+        message_add_handlers();
+        presence_add_handlers();
+        iq_add_handlers();
+        netthread_start();
         jabber_conn.conn_status = JABBER_CONNECTING;
-    else
+    } else {
         jabber_conn.conn_status = JABBER_DISCONNECTED;
+    }
 
     return jabber_conn.conn_status;
 }
@@ -422,8 +508,25 @@ _jabber_reconnect(void)
         log_debug("Attempting reconnect with account %s", account->name);
         _jabber_connect(fulljid, saved_account.passwd, account->server, account->port);
         free(fulljid);
-        g_timer_start(reconnect_timer);
+        timers_reset(reconnect_timer, prefs_get_reconnect() * 1000);
+    }
+}
+
+static gint
+_jabber_reconnect_timeout(void *data)
+{
+    gint reconnect_sec = prefs_get_reconnect();
+    if (reconnect_sec == 0) {
+        return TIMER_STOP;
+    }
+
+    // still trying the previous attempt
+    if (jabber_conn.conn_status != JABBER_DISCONNECTED) {
+        return reconnect_sec * 1000;
     }
+
+    _jabber_reconnect();
+    return reconnect_sec * 1000;
 }
 
 static void
@@ -453,24 +556,22 @@ _connection_handler(xmpp_conn_t * const conn,
             _connection_free_saved_details();
         }
 
-        Jid *my_jid = jid_create(jabber_get_fulljid());
-        jabber_conn.domain = strdup(my_jid->domainpart);
-        jid_destroy(my_jid);
+        _connection_set_jid(jabber_get_fulljid());
 
         chat_sessions_init();
-
-        roster_add_handlers();
-        message_add_handlers();
-        presence_add_handlers();
-        iq_add_handlers();
+        caps_requests_clear();
 
         roster_request();
         bookmark_request();
         jabber_conn.conn_status = JABBER_CONNECTED;
 
+        if (prefs_get_autoping() != 0) {
+            iq_set_autoping(prefs_get_autoping());
+        }
+
         if (prefs_get_reconnect() != 0) {
             if (reconnect_timer != NULL) {
-                g_timer_destroy(reconnect_timer);
+                timers_remove(reconnect_timer);
                 reconnect_timer = NULL;
             }
         }
@@ -484,7 +585,8 @@ _connection_handler(xmpp_conn_t * const conn,
             handle_lost_connection();
             if (prefs_get_reconnect() != 0) {
                 assert(reconnect_timer == NULL);
-                reconnect_timer = g_timer_new();
+                reconnect_timer = timers_add("reconnect", prefs_get_reconnect() * 1000,
+                    _jabber_reconnect_timeout, NULL);
                 // free resources but leave saved_user untouched
                 _connection_free_session_data();
             } else {
@@ -505,7 +607,7 @@ _connection_handler(xmpp_conn_t * const conn,
             } else {
                 log_debug("Connection handler: Restarting reconnect timer");
                 if (prefs_get_reconnect() != 0) {
-                    g_timer_start(reconnect_timer);
+                    timers_reset(reconnect_timer, prefs_get_reconnect() * 1000);
                 }
                 // free resources but leave saved_user untouched
                 _connection_free_session_data();
@@ -551,10 +653,26 @@ _get_xmpp_log_level()
     }
 }
 
+static xmpp_log_level_t
+_get_net_log_level(void)
+{
+    if (xmlconsole_open) {
+        return XMPP_LEVEL_DEBUG;
+    } else {
+        return _get_xmpp_log_level();
+    }
+}
+
 static void
 _xmpp_file_logger(void * const userdata, const xmpp_log_level_t level,
     const char * const area, const char * const msg)
 {
+    // log.c is not thread safe, lines from the network thread are written
+    // when the UI thread gets to them
+    if (netthread_log(level, area, msg)) {
+        return;
+    }
+
     log_level_t prof_level = _get_log_level(level);
     log_msg(prof_level, area, msg);
     if ((g_strcmp0(area, "xmpp") == 0) || (g_strcmp0(area, "conn")) == 0) {
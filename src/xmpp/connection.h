@@ -37,13 +37,22 @@
 
 #include <strophe.h>
 
+#include "jid.h"
 #include "resource.h"
 
 xmpp_conn_t *connection_get_conn(void);
 xmpp_ctx_t *connection_get_ctx(void);
+const JidView *connection_get_jid_view(void);
 void connection_set_priority(int priority);
 void connection_set_presence_message(const char * const message);
 void connection_add_available_resource(Resource *resource);
 void connection_remove_available_resource(const char * const resource);
 
+void connection_send(xmpp_stanza_t * const stanza);
+void connection_handler_add(xmpp_handler func, const char * const ns,
+    const char * const name, const char * const type, void * const userdata);
+void connection_id_handler_add(xmpp_handler func, const char * const id,
+    void * const userdata);
+void connection_id_handler_delete(xmpp_handler func, const char * const id);
+
 #endif
@@ -49,6 +49,7 @@
 #include "profanity.h"
 #include "config/preferences.h"
 #include "server_events.h"
+#include "timers.h"
 #include "xmpp/capabilities.h"
 #include "xmpp/connection.h"
 #include "xmpp/stanza.h"
@@ -56,7 +57,9 @@
 #include "roster_list.h"
 #include "xmpp/xmpp.h"
 
-#define HANDLE(ns, type, func) xmpp_handler_add(conn, func, ns, STANZA_NAME_IQ, type, ctx)
+#define HANDLE(ns, type, func) connection_handler_add(func, ns, STANZA_NAME_IQ, type, ctx)
+
+static ProfTimer autoping_timer;
 
 static int _error_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
@@ -92,8 +95,8 @@ static int _room_kick_result_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
 static int _manual_pong_handler(xmpp_conn_t *const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
-static int _ping_timed_handler(xmpp_conn_t * const conn,
-    void * const userdata);
+static gint _autoping_timeout(void *data);
+static void _autoping_reset(gint delay);
 static int _caps_response_handler(xmpp_conn_t *const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
 static int _caps_response_handler_for_jid(xmpp_conn_t *const conn,
@@ -104,7 +107,6 @@ static int _caps_response_handler_legacy(xmpp_conn_t *const conn,
 void
 iq_add_handlers(void)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     HANDLE(NULL,                STANZA_TYPE_ERROR,  _error_handler);
@@ -118,26 +120,17 @@ iq_add_handlers(void)
     HANDLE(STANZA_NS_VERSION,   STANZA_TYPE_RESULT, _version_result_handler);
 
     HANDLE(STANZA_NS_PING,      STANZA_TYPE_GET,    _ping_get_handler);
-
-    if (prefs_get_autoping() != 0) {
-        int millis = prefs_get_autoping() * 1000;
-        xmpp_timed_handler_add(conn, _ping_timed_handler, millis, ctx);
-    }
 }
 
 void
 iq_set_autoping(const int seconds)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
-    xmpp_ctx_t * const ctx = connection_get_ctx();
-
     if (jabber_get_connection_status() == JABBER_CONNECTED) {
-        xmpp_timed_handler_delete(conn, _ping_timed_handler);
-
         if (seconds != 0) {
             int millis = seconds * 1000;
-            xmpp_timed_handler_add(conn, _ping_timed_handler, millis,
-                ctx);
+            _autoping_reset(millis);
+        } else {
+            _autoping_reset(TIMER_STOP);
         }
     }
 }
@@ -145,42 +138,39 @@ iq_set_autoping(const int seconds)
 void
 iq_room_list_request(gchar *conferencejid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_disco_items_iq(ctx, "confreq", conferencejid);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_disco_info_request(gchar *jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     char *id = create_unique_id("disco_info");
     xmpp_stanza_t *iq = stanza_create_disco_info_iq(ctx, id, jid, NULL);
 
-    xmpp_id_handler_add(conn, _disco_info_response_handler, id, NULL);
+    connection_id_handler_add(_disco_info_response_handler, id, NULL);
 
     free(id);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_room_info_request(gchar *room)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     char *id = create_unique_id("room_disco_info");
     xmpp_stanza_t *iq = stanza_create_disco_info_iq(ctx, id, room, NULL);
 
-    xmpp_id_handler_add(conn, _disco_info_response_handler, id, room);
+    connection_id_handler_add(_disco_info_response_handler, id, room);
 
     free(id);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -188,7 +178,6 @@ void
 iq_send_caps_request_for_jid(const char * const to, const char * const id,
     const char * const node, const char * const ver)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     if (!node) {
@@ -205,9 +194,9 @@ iq_send_caps_request_for_jid(const char * const to, const char * const id,
     xmpp_stanza_t *iq = stanza_create_disco_info_iq(ctx, id, to, node_str->str);
     g_string_free(node_str, TRUE);
 
-    xmpp_id_handler_add(conn, _caps_response_handler_for_jid, id, strdup(to));
+    connection_id_handler_add(_caps_response_handler_for_jid, id, strdup(to));
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -215,7 +204,6 @@ void
 iq_send_caps_request(const char * const to, const char * const id,
     const char * const node, const char * const ver)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     if (!node) {
@@ -232,9 +220,9 @@ iq_send_caps_request(const char * const to, const char * const id,
     xmpp_stanza_t *iq = stanza_create_disco_info_iq(ctx, id, to, node_str->str);
     g_string_free(node_str, TRUE);
 
-    xmpp_id_handler_add(conn, _caps_response_handler, id, NULL);
+    connection_id_handler_add(_caps_response_handler, id, strdup(ver));
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -242,7 +230,6 @@ void
 iq_send_caps_request_legacy(const char * const to, const char * const id,
     const char * const node, const char * const ver)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     if (!node) {
@@ -258,120 +245,111 @@ iq_send_caps_request_legacy(const char * const to, const char * const id,
     g_string_printf(node_str, "%s#%s", node, ver);
     xmpp_stanza_t *iq = stanza_create_disco_info_iq(ctx, id, to, node_str->str);
 
-    xmpp_id_handler_add(conn, _caps_response_handler_legacy, id, node_str->str);
+    connection_id_handler_add(_caps_response_handler_legacy, id, node_str->str);
     g_string_free(node_str, FALSE);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_disco_items_request(gchar *jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_disco_items_iq(ctx, "discoitemsreq", jid);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_send_software_version(const char * const fulljid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_software_version_iq(ctx, fulljid);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_confirm_instant_room(const char * const room_jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_instant_room_request_iq(ctx, room_jid);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_destroy_room(const char * const room_jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_instant_room_destroy_iq(ctx, room_jid);
 
     char *id = xmpp_stanza_get_id(iq);
-    xmpp_id_handler_add(conn, _destroy_room_result_handler, id, NULL);
+    connection_id_handler_add(_destroy_room_result_handler, id, NULL);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_request_room_config_form(const char * const room_jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_config_request_iq(ctx, room_jid);
 
     char *id = xmpp_stanza_get_id(iq);
-    xmpp_id_handler_add(conn, _room_config_handler, id, NULL);
+    connection_id_handler_add(_room_config_handler, id, NULL);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_submit_room_config(const char * const room, DataForm *form)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_config_submit_iq(ctx, room, form);
 
     char *id = xmpp_stanza_get_id(iq);
-    xmpp_id_handler_add(conn, _room_config_submit_handler, id, NULL);
+    connection_id_handler_add(_room_config_submit_handler, id, NULL);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_room_config_cancel(const char * const room_jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_config_cancel_iq(ctx, room_jid);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_room_affiliation_list(const char * const room, char *affiliation)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_affiliation_list_iq(ctx, room, affiliation);
 
     char *id = xmpp_stanza_get_id(iq);
-    xmpp_id_handler_add(conn, _room_affiliation_list_result_handler, id, strdup(affiliation));
+    connection_id_handler_add(_room_affiliation_list_result_handler, id, strdup(affiliation));
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_room_kick_occupant(const char * const room, const char * const nick, const char * const reason)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_kick_iq(ctx, room, nick, reason);
 
     char *id = xmpp_stanza_get_id(iq);
-    xmpp_id_handler_add(conn, _room_kick_result_handler, id, strdup(nick));
+    connection_id_handler_add(_room_kick_result_handler, id, strdup(nick));
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -384,7 +362,6 @@ void
 iq_room_affiliation_set(const char * const room, const char * const jid, char *affiliation,
     const char * const reason)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_affiliation_set_iq(ctx, room, jid, affiliation, reason);
 
@@ -394,9 +371,9 @@ iq_room_affiliation_set(const char * const room, const char * const jid, char *a
     affiliation_set->item = strdup(jid);
     affiliation_set->privilege = strdup(affiliation);
 
-    xmpp_id_handler_add(conn, _room_affiliation_set_result_handler, id, affiliation_set);
+    connection_id_handler_add(_room_affiliation_set_result_handler, id, affiliation_set);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -404,7 +381,6 @@ void
 iq_room_role_set(const char * const room, const char * const nick, char *role,
     const char * const reason)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_role_set_iq(ctx, room, nick, role, reason);
 
@@ -414,38 +390,36 @@ iq_room_role_set(const char * const room, const char * const nick, char *role,
     role_set->item = strdup(nick);
     role_set->privilege = strdup(role);
 
-    xmpp_id_handler_add(conn, _room_role_set_result_handler, id, role_set);
+    connection_id_handler_add(_room_role_set_result_handler, id, role_set);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_room_role_list(const char * const room, char *role)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_room_role_list_iq(ctx, room, role);
 
     char *id = xmpp_stanza_get_id(iq);
-    xmpp_id_handler_add(conn, _room_role_list_result_handler, id, strdup(role));
+    connection_id_handler_add(_room_role_list_result_handler, id, strdup(role));
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 iq_send_ping(const char * const target)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_ping_iq(ctx, target);
     char *id = xmpp_stanza_get_id(iq);
 
     GDateTime *now = g_date_time_new_now_local();
-    xmpp_id_handler_add(conn, _manual_pong_handler, id, now);
+    connection_id_handler_add(_manual_pong_handler, id, now);
 
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -497,7 +471,7 @@ _pong_handler(xmpp_conn_t *const conn, xmpp_stanza_t * const stanza,
                     if (strcmp(errtype, "cancel") == 0) {
                         log_warning("Server ping (id=%s) error type 'cancel', disabling autoping.", id);
                         handle_autoping_cancel();
-                        xmpp_timed_handler_delete(conn, _ping_timed_handler);
+                        _autoping_reset(TIMER_STOP);
                     }
                 }
             }
@@ -512,6 +486,7 @@ static int
 _caps_response_handler(xmpp_conn_t *const conn, xmpp_stanza_t * const stanza,
     void * const userdata)
 {
+    char *ver = (char *)userdata;
     const char *id = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_ID);
     xmpp_stanza_t *query = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_QUERY);
 
@@ -530,6 +505,8 @@ _caps_response_handler(xmpp_conn_t *const conn, xmpp_stanza_t * const stanza,
     const char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
     if (!from) {
         log_info("No from attribute");
+        caps_request_next(ver, id);
+        free(ver);
         return 0;
     }
 
@@ -538,17 +515,23 @@ _caps_response_handler(xmpp_conn_t *const conn, xmpp_stanza_t * const stanza,
         char *error_message = stanza_get_error_message(stanza);
         log_warning("Error received for capabilities response from %s: ", from, error_message);
         free(error_message);
+        caps_request_next(ver, id);
+        free(ver);
         return 0;
     }
 
     if (query == NULL) {
         log_warning("No query element found.");
+        caps_request_next(ver, id);
+        free(ver);
         return 0;
     }
 
     char *node = xmpp_stanza_get_attribute(query, STANZA_ATTR_NODE);
     if (node == NULL) {
         log_warning("No node attribute found");
+        caps_request_next(ver, id);
+        free(ver);
         return 0;
     }
 
@@ -579,6 +562,9 @@ _caps_response_handler(xmpp_conn_t *const conn, xmpp_stanza_t * const stanza,
     g_free(generated_sha1);
     g_strfreev(split);
 
+    caps_request_next(ver, id);
+    free(ver);
+
     return 0;
 }
 
@@ -744,24 +730,35 @@ _manual_pong_handler(xmpp_conn_t *const conn, xmpp_stanza_t * const stanza,
     return 0;
 }
 
-static int
-_ping_timed_handler(xmpp_conn_t * const conn, void * const userdata)
+static gint
+_autoping_timeout(void *data)
 {
-    xmpp_ctx_t *ctx = (xmpp_ctx_t *)userdata;
+    // started again by the connection handler on the next login
+    if (jabber_get_connection_status() != JABBER_CONNECTED || prefs_get_autoping() == 0) {
+        return TIMER_STOP;
+    }
 
-    if (jabber_get_connection_status() == JABBER_CONNECTED) {
+    xmpp_ctx_t *ctx = connection_get_ctx();
+    xmpp_stanza_t *iq = stanza_create_ping_iq(ctx, NULL);
+    char *id = xmpp_stanza_get_id(iq);
 
-        xmpp_stanza_t *iq = stanza_create_ping_iq(ctx, NULL);
-        char *id = xmpp_stanza_get_id(iq);
+    // add pong handler
+    connection_id_handler_add(_pong_handler, id, ctx);
 
-        // add pong handler
-        xmpp_id_handler_add(conn, _pong_handler, id, ctx);
+    connection_send(iq);
+    xmpp_stanza_release(iq);
 
-        xmpp_send(conn, iq);
-        xmpp_stanza_release(iq);
-    }
+    return prefs_get_autoping() * 1000;
+}
 
-    return 1;
+static void
+_autoping_reset(gint delay)
+{
+    if (autoping_timer == NULL) {
+        autoping_timer = timers_add("autoping", delay, _autoping_timeout, NULL);
+    } else {
+        timers_reset(autoping_timer, delay);
+    }
 }
 
 static int
@@ -788,6 +785,11 @@ _version_result_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         return 1;
     }
 
+    JidView jidv;
+    if (!jid_view_parse(&jidv, jid)) {
+        return 1;
+    }
+
     char *name_str = NULL;
     char *version_str = NULL;
     char *os_str = NULL;
@@ -805,21 +807,18 @@ _version_result_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         os_str = xmpp_stanza_get_text(os);
     }
 
-    Jid *jidp = jid_create(jid);
     const char *presence = NULL;
-    if (muc_active(jidp->barejid)) {
-        Occupant *occupant = muc_roster_item(jidp->barejid, jidp->resourcepart);
+    if (muc_active(jidv.barejid)) {
+        Occupant *occupant = muc_roster_item(jidv.barejid, jidv.resourcepart);
         presence = string_from_resource_presence(occupant->presence);
     } else {
-        PContact contact = roster_get_contact(jidp->barejid);
-        Resource *resource = p_contact_get_resource(contact, jidp->resourcepart);
+        PContact contact = roster_get_contact(jidv.barejid);
+        Resource *resource = p_contact_get_resource(contact, jidv.resourcepart);
         presence = string_from_resource_presence(resource->presence);
     }
 
     handle_software_version_result(jid, presence, name_str, version_str, os_str);
 
-    jid_destroy(jidp);
-
     return 1;
 }
 
@@ -852,7 +851,7 @@ _ping_get_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         xmpp_stanza_set_attribute(pong, STANZA_ATTR_ID, id);
     }
 
-    xmpp_send(conn, pong);
+    connection_send(pong);
     xmpp_stanza_release(pong);
 
     return 1;
@@ -912,7 +911,7 @@ _version_get_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         xmpp_stanza_add_child(query, version);
         xmpp_stanza_add_child(response, query);
 
-        xmpp_send(conn, response);
+        connection_send(response);
 
         g_string_free(version_str, TRUE);
         xmpp_stanza_release(name_txt);
@@ -950,7 +949,7 @@ _disco_items_get_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         xmpp_stanza_set_name(query, STANZA_NAME_QUERY);
         xmpp_stanza_set_ns(query, XMPP_NS_DISCO_ITEMS);
         xmpp_stanza_add_child(response, query);
-        xmpp_send(conn, response);
+        connection_send(response);
 
         xmpp_stanza_release(response);
     }
@@ -988,7 +987,7 @@ _disco_info_get_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
             xmpp_stanza_set_attribute(query, STANZA_ATTR_NODE, node_str);
         }
         xmpp_stanza_add_child(response, query);
-        xmpp_send(conn, response);
+        connection_send(response);
 
         xmpp_stanza_release(query);
         xmpp_stanza_release(response);
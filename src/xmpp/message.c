@@ -50,7 +50,7 @@
 #include "xmpp/stanza.h"
 #include "xmpp/xmpp.h"
 
-#define HANDLE(ns, type, func) xmpp_handler_add(conn, func, ns, STANZA_NAME_MESSAGE, type, ctx)
+#define HANDLE(ns, type, func) connection_handler_add(func, ns, STANZA_NAME_MESSAGE, type, ctx)
 
 static int _groupchat_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
@@ -68,7 +68,6 @@ static int _message_error_handler(xmpp_conn_t * const conn,
 void
 message_add_handlers(void)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     HANDLE(NULL,                 STANZA_TYPE_ERROR,      _message_error_handler);
@@ -83,7 +82,6 @@ void
 message_send_chat(const char * const barejid, const char * const msg)
 {
     xmpp_stanza_t *message;
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     ChatSession *session = chat_session_get(barejid);
@@ -103,40 +101,37 @@ message_send_chat(const char * const barejid, const char * const msg)
         message = stanza_create_message(ctx, barejid, STANZA_TYPE_CHAT, msg, state);
     }
 
-    xmpp_send(conn, message);
+    connection_send(message);
     xmpp_stanza_release(message);
 }
 
 void
 message_send_private(const char * const fulljid, const char * const msg)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *message = stanza_create_message(ctx, fulljid, STANZA_TYPE_CHAT, msg, NULL);
 
-    xmpp_send(conn, message);
+    connection_send(message);
     xmpp_stanza_release(message);
 }
 
 void
 message_send_groupchat(const char * const roomjid, const char * const msg)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *message = stanza_create_message(ctx, roomjid, STANZA_TYPE_GROUPCHAT, msg, NULL);
 
-    xmpp_send(conn, message);
+    connection_send(message);
     xmpp_stanza_release(message);
 }
 
 void
 message_send_groupchat_subject(const char * const roomjid, const char * const subject)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *message = stanza_create_room_subject_message(ctx, roomjid, subject);
 
-    xmpp_send(conn, message);
+    connection_send(message);
     xmpp_stanza_release(message);
 }
 
@@ -144,22 +139,20 @@ void
 message_send_invite(const char * const roomjid, const char * const contact,
     const char * const reason)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *stanza = stanza_create_invite(ctx, roomjid, contact, reason);
 
-    xmpp_send(conn, stanza);
+    connection_send(stanza);
     xmpp_stanza_release(stanza);
 }
 
 void
 message_send_composing(const char * const jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_COMPOSING);
-    xmpp_send(conn, stanza);
+    connection_send(stanza);
     xmpp_stanza_release(stanza);
 
 }
@@ -167,31 +160,28 @@ message_send_composing(const char * const jid)
 void
 message_send_paused(const char * const jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_PAUSED);
-    xmpp_send(conn, stanza);
+    connection_send(stanza);
     xmpp_stanza_release(stanza);
 }
 
 void
 message_send_inactive(const char * const jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_INACTIVE);
 
-    xmpp_send(conn, stanza);
+    connection_send(stanza);
     xmpp_stanza_release(stanza);
 }
 
 void
 message_send_gone(const char * const jid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *stanza = stanza_create_chat_state(ctx, jid, STANZA_NAME_GONE);
-    xmpp_send(conn, stanza);
+    connection_send(stanza);
     xmpp_stanza_release(stanza);
 }
 
@@ -259,11 +249,10 @@ _muc_user_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
             return 1;
         }
 
-        Jid *jidp = jid_create(invitor_jid);
-        if (jidp == NULL) {
+        JidView invitor;
+        if (!jid_view_parse(&invitor, invitor_jid)) {
             return 1;
         }
-        char *invitor = jidp->barejid;
 
         char *reason = NULL;
         xmpp_stanza_t *reason_st = xmpp_stanza_get_child_by_name(invite, STANZA_NAME_REASON);
@@ -271,8 +260,7 @@ _muc_user_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
             reason = xmpp_stanza_get_text(reason_st);
         }
 
-        handle_room_invite(INVITE_MEDIATED, invitor, room, reason);
-        jid_destroy(jidp);
+        handle_room_invite(INVITE_MEDIATED, invitor.barejid, room, reason);
         if (reason != NULL) {
             xmpp_free(ctx, reason);
         }
@@ -288,7 +276,6 @@ _conference_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
     xmpp_stanza_t *xns_conference = xmpp_stanza_get_child_by_ns(stanza, STANZA_NS_CONFERENCE);
     char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
     char *room = NULL;
-    char *invitor = NULL;
     char *reason = NULL;
 
     if (from == NULL) {
@@ -302,17 +289,14 @@ _conference_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         return 1;
     }
 
-    Jid *jidp = jid_create(from);
-    if (jidp == NULL) {
+    JidView invitor;
+    if (!jid_view_parse(&invitor, from)) {
         return 1;
     }
-    invitor = jidp->barejid;
 
     reason = xmpp_stanza_get_attribute(xns_conference, STANZA_ATTR_REASON);
 
-    handle_room_invite(INVITE_DIRECT, invitor, room, reason);
-
-    jid_destroy(jidp);
+    handle_room_invite(INVITE_DIRECT, invitor.barejid, room, reason);
 
     return 1;
 }
@@ -349,21 +333,24 @@ _groupchat_handler(xmpp_conn_t * const conn,
     xmpp_ctx_t *ctx = connection_get_ctx();
     char *message = NULL;
     char *room_jid = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
-    Jid *jid = jid_create(room_jid);
+    JidView jid;
+    if (!jid_view_parse(&jid, room_jid)) {
+        log_error("Invalid room JID: %s", room_jid);
+        return 1;
+    }
 
     // handle room subject
     xmpp_stanza_t *subject = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_SUBJECT);
     if (subject != NULL) {
         message = xmpp_stanza_get_text(subject);
-        handle_room_subject(jid->barejid, jid->resourcepart, message);
+        handle_room_subject(jid.barejid, jid.resourcepart, message);
         xmpp_free(ctx, message);
 
-        jid_destroy(jid);
         return 1;
     }
 
     // handle room broadcasts
-    if (jid->resourcepart == NULL) {
+    if (jid.resourcepart == NULL) {
         xmpp_stanza_t *body = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_BODY);
         if (body != NULL) {
             message = xmpp_stanza_get_text(body);
@@ -373,20 +360,12 @@ _groupchat_handler(xmpp_conn_t * const conn,
             }
         }
 
-        jid_destroy(jid);
-        return 1;
-    }
-
-    if (!jid_is_valid_room_form(jid)) {
-        log_error("Invalid room JID: %s", jid->str);
-        jid_destroy(jid);
         return 1;
     }
 
     // room not active in profanity
-    if (!muc_active(jid->barejid)) {
-        log_error("Message received for inactive chat room: %s", jid->str);
-        jid_destroy(jid);
+    if (!muc_active(jid.barejid)) {
+        log_error("Message received for inactive chat room: %s", room_jid);
         return 1;
     }
 
@@ -400,16 +379,14 @@ _groupchat_handler(xmpp_conn_t * const conn,
         message = xmpp_stanza_get_text(body);
         if (message != NULL) {
             if (delayed) {
-                handle_room_history(jid->barejid, jid->resourcepart, tv_stamp, message);
+                handle_room_history(jid.barejid, jid.resourcepart, tv_stamp, message);
             } else {
-                handle_room_message(jid->barejid, jid->resourcepart, message);
+                handle_room_message(jid.barejid, jid.resourcepart, message);
             }
             xmpp_free(ctx, message);
         }
     }
 
-    jid_destroy(jid);
-
     return 1;
 }
 
@@ -434,10 +411,14 @@ _chat_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
     xmpp_ctx_t *ctx = connection_get_ctx();
     gchar *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
 
-    Jid *jid = jid_create(from);
+    JidView jid;
+    if (!jid_view_parse(&jid, from)) {
+        log_warning("Chat message received with invalid from attribute: %s", from);
+        return 1;
+    }
 
     // private message from chat room use full jid (room/nick)
-    if (muc_active(jid->barejid)) {
+    if (muc_active(jid.barejid)) {
         // determine if the notifications happened whilst offline
         GTimeVal tv_stamp;
         gboolean delayed = stanza_get_delay(stanza, &tv_stamp);
@@ -448,15 +429,14 @@ _chat_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
             char *message = xmpp_stanza_get_text(body);
             if (message != NULL) {
                 if (delayed) {
-                    handle_delayed_private_message(jid->str, message, tv_stamp);
+                    handle_delayed_private_message(from, message, tv_stamp);
                 } else {
-                    handle_incoming_private_message(jid->str, message);
+                    handle_incoming_private_message(from, message);
                 }
                 xmpp_free(ctx, message);
             }
         }
 
-        jid_destroy(jid);
         return 1;
 
     // standard chat message, use jid without resource
@@ -471,36 +451,35 @@ _chat_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
             char *message = xmpp_stanza_get_text(body);
             if (message != NULL) {
                 if (delayed) {
-                    handle_delayed_message(jid->barejid, message, tv_stamp);
+                    handle_delayed_message(jid.barejid, message, tv_stamp);
                 } else {
-                    handle_incoming_message(jid->barejid, jid->resourcepart, message);
+                    handle_incoming_message(jid.barejid, jid.resourcepart, message);
                 }
                 xmpp_free(ctx, message);
             }
         }
 
         // handle chat sessions and states
-        if (!delayed && jid->resourcepart) {
+        if (!delayed && jid.resourcepart) {
             gboolean gone = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_GONE) != NULL;
             gboolean typing = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_COMPOSING) != NULL;
             gboolean paused = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_PAUSED) != NULL;
             gboolean inactive = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_INACTIVE) != NULL;
             if (gone) {
-                handle_gone(jid->barejid, jid->resourcepart);
+                handle_gone(jid.barejid, jid.resourcepart);
             } else if (typing) {
-                handle_typing(jid->barejid, jid->resourcepart);
+                handle_typing(jid.barejid, jid.resourcepart);
             } else if (paused) {
-                handle_paused(jid->barejid, jid->resourcepart);
+                handle_paused(jid.barejid, jid.resourcepart);
             } else if (inactive) {
-                handle_inactive(jid->barejid, jid->resourcepart);
+                handle_inactive(jid.barejid, jid.resourcepart);
             } else if (stanza_contains_chat_state(stanza)) {
-                handle_activity(jid->barejid, jid->resourcepart, TRUE);
+                handle_activity(jid.barejid, jid.resourcepart, TRUE);
             } else {
-                handle_activity(jid->barejid, jid->resourcepart, FALSE);
+                handle_activity(jid.barejid, jid.resourcepart, FALSE);
             }
         }
 
-        jid_destroy(jid);
         return 1;
     }
 }
\ No newline at end of file
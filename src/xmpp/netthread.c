@@ -0,0 +1,862 @@
+/*
+ * netthread.c
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#include "config.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib.h>
+#include <strophe.h>
+
+#include "tools/spscqueue.h"
+#include "xmpp/netthread.h"
+
+// events and commands waiting in each direction before the sender backs off
+#define QUEUE_SIZE 4096
+
+// longest the network thread sleeps on the socket, libstrophe also needs
+// calling for its timed handlers
+#define NET_POLL_MS 1000
+
+// wait handed to libstrophe when the socket could not be watched, and the
+// longest sleep while it may have work the socket will not signal
+#define NET_RUN_MS 10
+
+// turns run without sleeping after the socket was readable, openssl may hold
+// a whole record of input while libstrophe takes one 4k buffer per turn
+#define NET_READ_TURNS 4
+
+// how long the network thread waits for space in a full event queue
+#define NET_BACKOFF_US 1000
+
+// handler time allowed per turn of the main loop, so input is still read
+// while a burst of stanzas is worked through
+#define EVENTS_BUDGET_US 10000
+
+typedef enum {
+    NET_HANDLER_STANZA,
+    NET_HANDLER_ID
+} net_handler_type_t;
+
+// a handler registered with libstrophe on the network thread on behalf of
+// the UI thread, func and userdata are only used on the UI thread
+typedef struct net_handler_t {
+    net_handler_type_t type;
+    xmpp_handler func;
+    void *userdata;
+    char *ns;
+    char *name;
+    char *stanza_type;
+    char *id;
+    // written by the network thread only, libstrophe drops it when next matched
+    gboolean net_removed;
+    // written by the UI thread only, stanzas already queued for it are dropped
+    gboolean ui_removed;
+} NetHandler;
+
+typedef enum {
+    NET_EVENT_CONNECTION,
+    NET_EVENT_STANZA,
+    NET_EVENT_LOG
+} net_event_type_t;
+
+// network thread to UI thread
+typedef struct net_event_t {
+    net_event_type_t type;
+    xmpp_conn_event_t status;
+    int error;
+    NetHandler *handler;
+    xmpp_stanza_t *stanza;
+    xmpp_log_level_t level;
+    char *area;
+    char *msg;
+} NetEvent;
+
+typedef enum {
+    NET_CMD_SEND,
+    NET_CMD_HANDLER_ADD,
+    NET_CMD_HANDLER_REMOVE,
+    NET_CMD_ID_HANDLER_ADD,
+    NET_CMD_DISCONNECT
+} net_cmd_type_t;
+
+// UI thread to network thread
+typedef struct net_cmd_t {
+    net_cmd_type_t type;
+    NetHandler *handler;
+    char *data;
+    size_t len;
+} NetCmd;
+
+// pipe written at most once until the reader clears it
+typedef struct net_wakeup_t {
+    int fds[2];
+    volatile gint pending;
+} NetWakeup;
+
+static GThread *thread;
+static GPrivate on_net_thread = G_PRIVATE_INIT(NULL);
+static volatile gint stopping = TRUE;
+static volatile gint log_level = XMPP_LEVEL_DEBUG;
+
+static xmpp_ctx_t *ctx;
+static xmpp_conn_t *conn;
+static xmpp_conn_handler conn_handler;
+static const xmpp_log_t *conn_log;
+
+static SpscQueue events;
+static SpscQueue commands;
+static NetWakeup ui_wakeup;
+static NetWakeup net_wakeup;
+
+// network thread only
+static int sock_fd;
+static gboolean net_done;
+static gboolean net_connected;
+// a handler ran during the last turn, more may be buffered behind it
+static gboolean net_dispatched;
+// output handed to libstrophe since the thread last slept
+static gboolean net_sent;
+// turns left before sleeping, input may be waiting inside openssl
+static int net_read_turns;
+
+// UI thread only
+static GList *handlers;
+static GQueue *backlog;
+
+static gpointer _net_thread(gpointer data);
+static gboolean _net_run_commands(void);
+static void _net_wait(void);
+static gboolean _net_writing(void);
+static gboolean _net_pending(void);
+static gboolean _net_buffering(void);
+static void _net_push_event(NetEvent *event);
+static int _net_stanza_handler(xmpp_conn_t * const conn,
+    xmpp_stanza_t * const stanza, void * const userdata);
+static void _net_conn_handler(xmpp_conn_t * const conn,
+    const xmpp_conn_event_t status, const int error,
+    xmpp_stream_error_t * const stream_error, void * const userdata);
+#ifdef HAVE_XMPP_SOCKOPT_CALLBACK
+static int _net_sockopt_handler(xmpp_conn_t *conn, void *sock);
+#endif
+
+static void _event_handle(NetEvent *event);
+static void _event_free(NetEvent *event);
+static void _command_push(NetCmd *cmd);
+static void _commands_flush(void);
+static void _command_free(NetCmd *cmd);
+static NetHandler * _handler_new(net_handler_type_t type, xmpp_handler func,
+    void *userdata);
+static void _handler_run(NetHandler *handler, xmpp_stanza_t *stanza);
+static void _handler_free(NetHandler *handler);
+
+static gboolean _wakeup_init(NetWakeup *wakeup);
+static void _wakeup_close(NetWakeup *wakeup);
+static void _wakeup_signal(NetWakeup *wakeup);
+static void _wakeup_clear(NetWakeup *wakeup);
+
+int
+netthread_connect(xmpp_ctx_t * const new_ctx, xmpp_conn_t * const new_conn,
+    const char * const altdomain, int port, xmpp_conn_handler handler,
+    const xmpp_log_t * const log)
+{
+    netthread_stop();
+
+    if (!_wakeup_init(&ui_wakeup)) {
+        return -1;
+    }
+    if (!_wakeup_init(&net_wakeup)) {
+        _wakeup_close(&ui_wakeup);
+        return -1;
+    }
+
+    ctx = new_ctx;
+    conn = new_conn;
+    conn_handler = handler;
+    conn_log = log;
+    events = spscqueue_new(QUEUE_SIZE);
+    commands = spscqueue_new(QUEUE_SIZE);
+    backlog = g_queue_new();
+    sock_fd = -1;
+    net_done = FALSE;
+    net_connected = FALSE;
+    net_dispatched = FALSE;
+    net_sent = FALSE;
+    net_read_turns = 0;
+    g_atomic_int_set(&stopping, FALSE);
+
+#ifdef HAVE_XMPP_SOCKOPT_CALLBACK
+    xmpp_conn_set_sockopt_callback(conn, _net_sockopt_handler);
+#endif
+
+    // resolving and opening the socket happen here, the thread takes over
+    // once there is a stream to read
+    int result = xmpp_connect_client(conn, altdomain, port, _net_conn_handler, NULL);
+    if (result != 0) {
+        netthread_stop();
+    }
+
+    return result;
+}
+
+void
+netthread_start(void)
+{
+    if (events == NULL || thread != NULL) {
+        return;
+    }
+
+    thread = g_thread_new("xmpp", _net_thread, NULL);
+}
+
+void
+netthread_disconnect(void)
+{
+    NetCmd *cmd = malloc(sizeof(NetCmd));
+    cmd->type = NET_CMD_DISCONNECT;
+    cmd->handler = NULL;
+    cmd->data = NULL;
+    _command_push(cmd);
+}
+
+void
+netthread_stop(void)
+{
+    if (events == NULL) {
+        return;
+    }
+
+    g_atomic_int_set(&stopping, TRUE);
+    if (thread != NULL) {
+        _wakeup_signal(&net_wakeup);
+        g_thread_join(thread);
+        thread = NULL;
+    }
+
+    NetEvent *event;
+    while ((event = spscqueue_pop(events)) != NULL) {
+        _event_free(event);
+    }
+    NetCmd *cmd;
+    while ((cmd = spscqueue_pop(commands)) != NULL) {
+        _command_free(cmd);
+    }
+    g_queue_free_full(backlog, (GDestroyNotify)_command_free);
+    backlog = NULL;
+
+    // libstrophe still holds these until the connection is released, the
+    // stopping flag keeps it from looking at them
+    g_list_free_full(handlers, (GDestroyNotify)_handler_free);
+    handlers = NULL;
+
+    spscqueue_free(events);
+    events = NULL;
+    spscqueue_free(commands);
+    commands = NULL;
+    _wakeup_close(&ui_wakeup);
+    _wakeup_close(&net_wakeup);
+}
+
+int
+netthread_get_fd(void)
+{
+    if (events == NULL) {
+        return -1;
+    }
+
+    return ui_wakeup.fds[0];
+}
+
+void
+netthread_process_events(int millis)
+{
+    if (events == NULL) {
+        return;
+    }
+
+    _commands_flush();
+
+    if (millis > 0 && spscqueue_is_empty(events)) {
+        struct pollfd fd = { ui_wakeup.fds[0], POLLIN, 0 };
+        poll(&fd, 1, millis);
+    }
+
+    _wakeup_clear(&ui_wakeup);
+
+    gint64 deadline = g_get_monotonic_time() + EVENTS_BUDGET_US;
+    NetEvent *event;
+    while (events != NULL && (event = spscqueue_pop(events)) != NULL) {
+        _event_handle(event);
+        _event_free(event);
+
+        // leave the rest for the next turn of the main loop
+        if (events != NULL && g_get_monotonic_time() >= deadline) {
+            if (!spscqueue_is_empty(events)) {
+                _wakeup_signal(&ui_wakeup);
+            }
+            break;
+        }
+    }
+}
+
+gboolean
+netthread_log(xmpp_log_level_t level, const char * const area,
+    const char * const msg)
+{
+    if (g_private_get(&on_net_thread) == NULL) {
+        return FALSE;
+    }
+
+    // most lines are stanza dumps at debug, dropped here before anything
+    // is copied
+    if (level < g_atomic_int_get(&log_level)) {
+        return TRUE;
+    }
+
+    NetEvent *event = malloc(sizeof(NetEvent));
+    event->type = NET_EVENT_LOG;
+    event->level = level;
+    event->area = strdup(area);
+    event->msg = strdup(msg);
+    event->stanza = NULL;
+    _net_push_event(event);
+
+    return TRUE;
+}
+
+void
+netthread_set_log_level(xmpp_log_level_t level)
+{
+    g_atomic_int_set(&log_level, level);
+}
+
+void
+netthread_send(xmpp_stanza_t * const stanza)
+{
+    if (events == NULL) {
+        return;
+    }
+
+    char *text;
+    size_t len;
+    if (xmpp_stanza_to_text(stanza, &text, &len) != 0) {
+        return;
+    }
+
+    // what xmpp_send would have logged
+    if (conn_log != NULL) {
+        char *msg = g_strdup_printf("SENT: %s", text);
+        conn_log->handler(conn_log->userdata, XMPP_LEVEL_DEBUG, "conn", msg);
+        g_free(msg);
+    }
+
+    NetCmd *cmd = malloc(sizeof(NetCmd));
+    cmd->type = NET_CMD_SEND;
+    cmd->handler = NULL;
+    cmd->data = text;
+    cmd->len = len;
+    _command_push(cmd);
+}
+
+void
+netthread_handler_add(xmpp_handler func, const char * const ns,
+    const char * const name, const char * const type, void * const userdata)
+{
+    if (events == NULL) {
+        return;
+    }
+
+    NetHandler *handler = _handler_new(NET_HANDLER_STANZA, func, userdata);
+    handler->ns = g_strdup(ns);
+    handler->name = g_strdup(name);
+    handler->stanza_type = g_strdup(type);
+
+    NetCmd *cmd = malloc(sizeof(NetCmd));
+    cmd->type = NET_CMD_HANDLER_ADD;
+    cmd->handler = handler;
+    cmd->data = NULL;
+    _command_push(cmd);
+}
+
+void
+netthread_id_handler_add(xmpp_handler func, const char * const id,
+    void * const userdata)
+{
+    if (events == NULL) {
+        return;
+    }
+
+    NetHandler *handler = _handler_new(NET_HANDLER_ID, func, userdata);
+    handler->id = g_strdup(id);
+
+    NetCmd *cmd = malloc(sizeof(NetCmd));
+    cmd->type = NET_CMD_ID_HANDLER_ADD;
+    cmd->handler = handler;
+    cmd->data = NULL;
+    _command_push(cmd);
+}
+
+void
+netthread_id_handler_delete(xmpp_handler func, const char * const id)
+{
+    // the network thread drops it when the reply arrives, which is also
+    // when the record is freed
+    GList *curr = handlers;
+    while (curr != NULL) {
+        NetHandler *handler = curr->data;
+        if (handler->type == NET_HANDLER_ID && handler->func == func &&
+                g_strcmp0(handler->id, id) == 0) {
+            handler->ui_removed = TRUE;
+        }
+        curr = g_list_next(curr);
+    }
+}
+
+static gpointer
+_net_thread(gpointer data)
+{
+    g_private_set(&on_net_thread, GINT_TO_POINTER(TRUE));
+
+    while (!g_atomic_int_get(&stopping) && !net_done) {
+        if (!_net_run_commands()) {
+            break;
+        }
+
+        if (sock_fd >= 0) {
+            net_dispatched = FALSE;
+            xmpp_run_once(ctx, 0);
+
+            // a turn reads at most one buffer, go round again before
+            // sleeping when it gave anything
+            if (!net_done && !net_dispatched) {
+                _net_wait();
+            }
+        } else {
+            xmpp_run_once(ctx, NET_RUN_MS);
+        }
+    }
+
+    return NULL;
+}
+
+// FALSE when the thread is being stopped
+static gboolean
+_net_run_commands(void)
+{
+    _wakeup_clear(&net_wakeup);
+
+    NetCmd *cmd;
+    while ((cmd = spscqueue_pop(commands)) != NULL) {
+        if (g_atomic_int_get(&stopping)) {
+            _command_free(cmd);
+            return FALSE;
+        }
+
+        NetHandler *handler = cmd->handler;
+        switch (cmd->type) {
+            case NET_CMD_SEND:
+                xmpp_send_raw(conn, cmd->data, cmd->len);
+                net_sent = TRUE;
+                break;
+            case NET_CMD_HANDLER_ADD:
+                xmpp_handler_add(conn, _net_stanza_handler, handler->ns,
+                    handler->name, handler->stanza_type, handler);
+                break;
+            case NET_CMD_HANDLER_REMOVE:
+                handler->net_removed = TRUE;
+                break;
+            case NET_CMD_ID_HANDLER_ADD:
+                xmpp_id_handler_add(conn, _net_stanza_handler, handler->id, handler);
+                break;
+            case NET_CMD_DISCONNECT:
+                xmpp_disconnect(conn);
+                break;
+        }
+        _command_free(cmd);
+    }
+
+    return TRUE;
+}
+
+static void
+_net_wait(void)
+{
+    struct pollfd fds[2];
+    nfds_t nfds = 0;
+
+    fds[nfds].fd = net_wakeup.fds[0];
+    fds[nfds].events = POLLIN;
+    nfds++;
+
+    int timeout = NET_POLL_MS;
+    if (sock_fd >= 0) {
+        fds[nfds].fd = sock_fd;
+        fds[nfds].events = POLLIN;
+        if (_net_writing()) {
+            fds[nfds].events |= POLLOUT;
+        }
+        nfds++;
+
+        if (net_read_turns > 0) {
+            net_read_turns--;
+            timeout = 0;
+        } else if (_net_pending()) {
+            timeout = NET_RUN_MS;
+        }
+    }
+
+    net_sent = FALSE;
+    if (poll(fds, nfds, timeout) > 0 && nfds > 1 &&
+            (fds[1].revents & POLLIN) && _net_buffering()) {
+        net_read_turns = NET_READ_TURNS;
+    }
+}
+
+// a connect finishing or queued output going out only shows as writable
+static gboolean
+_net_writing(void)
+{
+#ifdef HAVE_XMPP_CONN_IS_CONNECTING
+    if (xmpp_conn_is_connecting(conn)) {
+        return TRUE;
+    }
+#endif
+#ifdef HAVE_XMPP_CONN_SEND_QUEUE_LEN
+    if (xmpp_conn_send_queue_len(conn) > 0) {
+        return TRUE;
+    }
+#endif
+
+    return FALSE;
+}
+
+// libstrophe may have work the socket will not signal, where it cannot tell
+// us a connect or output is in progress
+static gboolean
+_net_pending(void)
+{
+#ifndef HAVE_XMPP_CONN_IS_CONNECTING
+    if (!net_connected) {
+        return TRUE;
+    }
+#endif
+#ifndef HAVE_XMPP_CONN_SEND_QUEUE_LEN
+    if (net_sent) {
+        return TRUE;
+    }
+#endif
+
+    return FALSE;
+}
+
+// reads may leave input behind in openssl, where the socket no longer shows it
+static gboolean
+_net_buffering(void)
+{
+#ifdef HAVE_XMPP_CONN_IS_SECURED
+    return xmpp_conn_is_secured(conn);
+#else
+    return TRUE;
+#endif
+}
+
+static void
+_net_push_event(NetEvent *event)
+{
+    // back off until the UI thread catches up, unless it is waiting for us
+    while (!spscqueue_push(events, event)) {
+        if (g_atomic_int_get(&stopping)) {
+            _event_free(event);
+            return;
+        }
+        _wakeup_signal(&ui_wakeup);
+        g_usleep(NET_BACKOFF_US);
+    }
+
+    _wakeup_signal(&ui_wakeup);
+}
+
+static int
+_net_stanza_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
+    void * const userdata)
+{
+    // handler records are already freed once stopping
+    if (g_atomic_int_get(&stopping)) {
+        return 0;
+    }
+
+    NetHandler *handler = userdata;
+    if (handler->net_removed) {
+        return 0;
+    }
+    net_dispatched = TRUE;
+
+    // id handlers fire once, the UI thread adds them again if asked to, and
+    // may free the record as soon as the event is pushed
+    int keep = handler->type == NET_HANDLER_STANZA;
+
+    // libstrophe reference counts are not atomic, the UI thread gets a
+    // copy of its own rather than a shared reference
+    NetEvent *event = malloc(sizeof(NetEvent));
+    event->type = NET_EVENT_STANZA;
+    event->handler = handler;
+    event->stanza = xmpp_stanza_copy(stanza);
+    event->area = NULL;
+    event->msg = NULL;
+    _net_push_event(event);
+
+    return keep;
+}
+
+static void
+_net_conn_handler(xmpp_conn_t * const conn, const xmpp_conn_event_t status,
+    const int error, xmpp_stream_error_t * const stream_error,
+    void * const userdata)
+{
+    if (g_atomic_int_get(&stopping)) {
+        return;
+    }
+
+    net_dispatched = TRUE;
+    if (status == XMPP_CONN_CONNECT) {
+        net_connected = TRUE;
+    }
+
+    // nothing more will be read, the UI thread joins us when it is done
+    if (status == XMPP_CONN_DISCONNECT) {
+        sock_fd = -1;
+        net_done = TRUE;
+    }
+
+    NetEvent *event = malloc(sizeof(NetEvent));
+    event->type = NET_EVENT_CONNECTION;
+    event->status = status;
+    event->error = error;
+    event->stanza = NULL;
+    event->area = NULL;
+    event->msg = NULL;
+    _net_push_event(event);
+}
+
+#ifdef HAVE_XMPP_SOCKOPT_CALLBACK
+// called by libstrophe once the socket exists, lets the thread poll it
+static int
+_net_sockopt_handler(xmpp_conn_t *conn, void *sock)
+{
+    sock_fd = *(int *)sock;
+    return xmpp_sockopt_cb_keepalive(conn, sock);
+}
+#endif
+
+static void
+_event_handle(NetEvent *event)
+{
+    switch (event->type) {
+        case NET_EVENT_CONNECTION:
+            conn_handler(conn, event->status, event->error, NULL, NULL);
+            break;
+        case NET_EVENT_STANZA:
+            _handler_run(event->handler, event->stanza);
+            break;
+        case NET_EVENT_LOG:
+            if (conn_log != NULL) {
+                conn_log->handler(conn_log->userdata, event->level, event->area,
+                    event->msg);
+            }
+            break;
+    }
+}
+
+static void
+_event_free(NetEvent *event)
+{
+    if (event->stanza != NULL) {
+        xmpp_stanza_release(event->stanza);
+    }
+    free(event->area);
+    free(event->msg);
+    free(event);
+}
+
+static void
+_command_push(NetCmd *cmd)
+{
+    if (commands == NULL) {
+        _command_free(cmd);
+        return;
+    }
+
+    // keep order behind anything that did not fit last time
+    g_queue_push_tail(backlog, cmd);
+    _commands_flush();
+}
+
+static void
+_commands_flush(void)
+{
+    gboolean pushed = FALSE;
+    NetCmd *cmd;
+    while ((cmd = g_queue_peek_head(backlog)) != NULL) {
+        if (!spscqueue_push(commands, cmd)) {
+            break;
+        }
+        g_queue_pop_head(backlog);
+        pushed = TRUE;
+    }
+
+    if (pushed) {
+        _wakeup_signal(&net_wakeup);
+    }
+}
+
+static void
+_command_free(NetCmd *cmd)
+{
+    if (cmd->data != NULL) {
+        xmpp_free(ctx, cmd->data);
+    }
+    free(cmd);
+}
+
+static NetHandler *
+_handler_new(net_handler_type_t type, xmpp_handler func, void *userdata)
+{
+    NetHandler *handler = malloc(sizeof(NetHandler));
+    handler->type = type;
+    handler->func = func;
+    handler->userdata = userdata;
+    handler->ns = NULL;
+    handler->name = NULL;
+    handler->stanza_type = NULL;
+    handler->id = NULL;
+    handler->net_removed = FALSE;
+    handler->ui_removed = FALSE;
+
+    handlers = g_list_prepend(handlers, handler);
+
+    return handler;
+}
+
+static void
+_handler_run(NetHandler *handler, xmpp_stanza_t *stanza)
+{
+    gboolean keep = FALSE;
+    if (!handler->ui_removed) {
+        keep = handler->func(conn, stanza, handler->userdata);
+    }
+
+    if (handler->type == NET_HANDLER_ID) {
+        if (keep && !handler->ui_removed) {
+            NetCmd *cmd = malloc(sizeof(NetCmd));
+            cmd->type = NET_CMD_ID_HANDLER_ADD;
+            cmd->handler = handler;
+            cmd->data = NULL;
+            _command_push(cmd);
+
+        // libstrophe already dropped it, nothing else refers to it
+        } else {
+            handlers = g_list_remove(handlers, handler);
+            _handler_free(handler);
+        }
+
+    } else if (!keep && !handler->ui_removed) {
+        handler->ui_removed = TRUE;
+
+        NetCmd *cmd = malloc(sizeof(NetCmd));
+        cmd->type = NET_CMD_HANDLER_REMOVE;
+        cmd->handler = handler;
+        cmd->data = NULL;
+        _command_push(cmd);
+    }
+}
+
+static void
+_handler_free(NetHandler *handler)
+{
+    g_free(handler->ns);
+    g_free(handler->name);
+    g_free(handler->stanza_type);
+    g_free(handler->id);
+    free(handler);
+}
+
+static gboolean
+_wakeup_init(NetWakeup *wakeup)
+{
+    if (pipe(wakeup->fds) != 0) {
+        return FALSE;
+    }
+
+    fcntl(wakeup->fds[0], F_SETFL, O_NONBLOCK);
+    fcntl(wakeup->fds[1], F_SETFL, O_NONBLOCK);
+    wakeup->pending = FALSE;
+
+    return TRUE;
+}
+
+static void
+_wakeup_close(NetWakeup *wakeup)
+{
+    close(wakeup->fds[0]);
+    close(wakeup->fds[1]);
+}
+
+static void
+_wakeup_signal(NetWakeup *wakeup)
+{
+    if (!g_atomic_int_compare_and_exchange(&wakeup->pending, FALSE, TRUE)) {
+        return;
+    }
+
+    if (write(wakeup->fds[1], "x", 1) < 0) {
+        // a full pipe wakes the reader anyway
+        return;
+    }
+}
+
+static void
+_wakeup_clear(NetWakeup *wakeup)
+{
+    // cleared before the queue is drained, anything pushed from now on
+    // writes to the pipe again
+    g_atomic_int_set(&wakeup->pending, FALSE);
+
+    char buf[64];
+    while (read(wakeup->fds[0], buf, sizeof(buf)) > 0) {
+    }
+}
@@ -0,0 +1,76 @@
+/*
+ * netthread.h
+ *
+ * Copyright (C) 2012 - 2015 James Booth <boothj5@gmail.com>
+ *
+ * This file is part of Profanity.
+ *
+ * Profanity is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * Profanity is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with Profanity.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ * In addition, as a special exception, the copyright holders give permission to
+ * link the code of portions of this program with the OpenSSL library under
+ * certain conditions as described in each individual source file, and
+ * distribute linked combinations including the two.
+ *
+ * You must obey the GNU General Public License in all respects for all of the
+ * code used other than OpenSSL. If you modify file(s) with this exception, you
+ * may extend this exception to your version of the file(s), but you are not
+ * obligated to do so. If you do not wish to do so, delete this exception
+ * statement from your version. If you delete this exception statement from all
+ * source files in the program, then also delete it here.
+ *
+ */
+
+#ifndef XMPP_NETTHREAD_H
+#define XMPP_NETTHREAD_H
+
+#include <glib.h>
+#include <strophe.h>
+
+// start connecting, handlers may be added before netthread_start
+int netthread_connect(xmpp_ctx_t * const ctx, xmpp_conn_t * const conn,
+    const char * const altdomain, int port, xmpp_conn_handler handler,
+    const xmpp_log_t * const log);
+
+// hand the connection to the network thread, libstrophe is only called from
+// that thread until netthread_stop
+void netthread_start(void);
+
+// ask the network thread to close the stream
+void netthread_disconnect(void);
+
+// stop and join the network thread, events not yet handled are dropped
+void netthread_stop(void);
+
+// readable when events are waiting, -1 without a network thread
+int netthread_get_fd(void);
+
+// wait up to millis for events then run their handlers on the calling thread
+void netthread_process_events(int millis);
+
+// queue a log line when called on the network thread, FALSE on any other thread
+gboolean netthread_log(xmpp_log_level_t level, const char * const area,
+    const char * const msg);
+
+// lines below level are dropped on the network thread rather than queued
+void netthread_set_log_level(xmpp_log_level_t level);
+
+void netthread_send(xmpp_stanza_t * const stanza);
+void netthread_handler_add(xmpp_handler func, const char * const ns,
+    const char * const name, const char * const type, void * const userdata);
+void netthread_id_handler_add(xmpp_handler func, const char * const id,
+    void * const userdata);
+void netthread_id_handler_delete(xmpp_handler func, const char * const id);
+
+#endif
@@ -52,7 +52,7 @@
 
 static Autocomplete sub_requests_ac;
 
-#define HANDLE(ns, type, func) xmpp_handler_add(conn, func, ns, \
+#define HANDLE(ns, type, func) connection_handler_add(func, ns, \
                                                 STANZA_NAME_PRESENCE, type, ctx)
 
 static int _unavailable_handler(xmpp_conn_t * const conn,
@@ -71,7 +71,7 @@ static int _presence_error_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata);
 
 void _send_caps_request(char *node, char *caps_key, char *id, char *from);
-static void _send_room_presence(xmpp_conn_t *conn, xmpp_stanza_t *presence);
+static void _send_room_presence(xmpp_stanza_t *presence);
 
 void
 presence_sub_requests_init(void)
@@ -82,7 +82,6 @@ presence_sub_requests_init(void)
 void
 presence_add_handlers(void)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     HANDLE(NULL,               STANZA_TYPE_ERROR,        _presence_error_handler);
@@ -100,7 +99,6 @@ presence_subscription(const char * const jid, const jabber_subscr_t action)
     assert(jid != NULL);
 
     xmpp_ctx_t * const ctx = connection_get_ctx();
-    xmpp_conn_t * const conn = connection_get_conn();
     const char *type = NULL;
 
     Jid *jidp = jid_create(jid);
@@ -132,7 +130,7 @@ presence_subscription(const char * const jid, const jabber_subscr_t action)
     xmpp_stanza_set_name(presence, STANZA_NAME_PRESENCE);
     xmpp_stanza_set_type(presence, type);
     xmpp_stanza_set_attribute(presence, STANZA_ATTR_TO, jidp->barejid);
-    xmpp_send(conn, presence);
+    connection_send(presence);
     xmpp_stanza_release(presence);
 
     jid_destroy(jidp);
@@ -209,7 +207,6 @@ presence_update(const resource_presence_t presence_type, const char * const msg,
     }
 
     xmpp_ctx_t * const ctx = connection_get_ctx();
-    xmpp_conn_t * const conn = connection_get_conn();
     const int pri =
         accounts_get_priority_for_presence_type(jabber_get_account_name(),
                                                 presence_type);
@@ -226,8 +223,8 @@ presence_update(const resource_presence_t presence_type, const char * const msg,
     stanza_attach_priority(ctx, presence, pri);
     stanza_attach_last_activity(ctx, presence, idle);
     stanza_attach_caps(ctx, presence);
-    xmpp_send(conn, presence);
-    _send_room_presence(conn, presence);
+    connection_send(presence);
+    _send_room_presence(presence);
     xmpp_stanza_release(presence);
 
     // set last presence for account
@@ -240,7 +237,7 @@ presence_update(const resource_presence_t presence_type, const char * const msg,
 }
 
 static void
-_send_room_presence(xmpp_conn_t *conn, xmpp_stanza_t *presence)
+_send_room_presence(xmpp_stanza_t *presence)
 {
     GList *rooms_p = muc_rooms();
     GList *rooms = rooms_p;
@@ -254,7 +251,7 @@ _send_room_presence(xmpp_conn_t *conn, xmpp_stanza_t *presence)
 
             xmpp_stanza_set_attribute(presence, STANZA_ATTR_TO, full_room_jid);
             log_debug("Sending presence to room: %s", full_room_jid);
-            xmpp_send(conn, presence);
+            connection_send(presence);
             free(full_room_jid);
         }
 
@@ -273,7 +270,6 @@ presence_join_room(char *room, char *nick, char * passwd)
 
     log_debug("Sending room join presence to: %s", jid->fulljid);
     xmpp_ctx_t *ctx = connection_get_ctx();
-    xmpp_conn_t *conn = connection_get_conn();
     resource_presence_t presence_type =
         accounts_get_last_presence(jabber_get_account_name());
     const char *show = stanza_get_presence_string_from_type(presence_type);
@@ -287,7 +283,7 @@ presence_join_room(char *room, char *nick, char * passwd)
     stanza_attach_priority(ctx, presence, pri);
     stanza_attach_caps(ctx, presence);
 
-    xmpp_send(conn, presence);
+    connection_send(presence);
     xmpp_stanza_release(presence);
 
     jid_destroy(jid);
@@ -301,7 +297,6 @@ presence_change_room_nick(const char * const room, const char * const nick)
 
     log_debug("Sending room nickname change to: %s, nick: %s", room, nick);
     xmpp_ctx_t *ctx = connection_get_ctx();
-    xmpp_conn_t *conn = connection_get_conn();
     resource_presence_t presence_type =
         accounts_get_last_presence(jabber_get_account_name());
     const char *show = stanza_get_presence_string_from_type(presence_type);
@@ -317,7 +312,7 @@ presence_change_room_nick(const char * const room, const char * const nick)
     stanza_attach_priority(ctx, presence, pri);
     stanza_attach_caps(ctx, presence);
 
-    xmpp_send(conn, presence);
+    connection_send(presence);
     xmpp_stanza_release(presence);
 
     free(full_room_jid);
@@ -330,13 +325,12 @@ presence_leave_chat_room(const char * const room_jid)
 
     log_debug("Sending room leave presence to: %s", room_jid);
     xmpp_ctx_t *ctx = connection_get_ctx();
-    xmpp_conn_t *conn = connection_get_conn();
     char *nick = muc_nick(room_jid);
 
     if (nick != NULL) {
         xmpp_stanza_t *presence = stanza_create_room_leave_presence(ctx, room_jid,
             nick);
-        xmpp_send(conn, presence);
+        connection_send(presence);
         xmpp_stanza_release(presence);
     }
 }
@@ -360,7 +354,11 @@ _presence_error_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
 
     // handle MUC join errors
     if (g_strcmp0(xmlns, STANZA_NS_MUC) == 0) {
-        Jid *fulljid = jid_create(from);
+        JidView room_jid;
+        if (!jid_view_parse(&room_jid, from)) {
+            log_warning("Room join error with invalid from attribute: %s", from);
+            return 1;
+        }
 
         char *error_cond = NULL;
         xmpp_stanza_t *reason_st = xmpp_stanza_get_child_by_ns(error_stanza, STANZA_NS_STANZAS);
@@ -371,9 +369,8 @@ _presence_error_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
             error_cond = "unknown";
         }
 
-        log_info("Error joining room: %s, reason: %s", fulljid->barejid, error_cond);
-        handle_room_join_error(fulljid->barejid, error_cond);
-        jid_destroy(fulljid);
+        log_info("Error joining room: %s, reason: %s", room_jid.barejid, error_cond);
+        handle_room_join_error(room_jid.barejid, error_cond);
         return 1;
     }
 
@@ -413,13 +410,15 @@ _unsubscribed_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata)
 {
     char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
-    Jid *from_jid = jid_create(from);
     log_debug("Unsubscribed presence handler fired for %s", from);
 
-    handle_subscription(from_jid->barejid, PRESENCE_UNSUBSCRIBED);
-    autocomplete_remove(sub_requests_ac, from_jid->barejid);
+    JidView from_jid;
+    if (!jid_view_parse(&from_jid, from)) {
+        return 1;
+    }
 
-    jid_destroy(from_jid);
+    handle_subscription(from_jid.barejid, PRESENCE_UNSUBSCRIBED);
+    autocomplete_remove(sub_requests_ac, from_jid.barejid);
 
     return 1;
 }
@@ -429,13 +428,15 @@ _subscribed_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata)
 {
     char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
-    Jid *from_jid = jid_create(from);
     log_debug("Subscribed presence handler fired for %s", from);
 
-    handle_subscription(from_jid->barejid, PRESENCE_SUBSCRIBED);
-    autocomplete_remove(sub_requests_ac, from_jid->barejid);
+    JidView from_jid;
+    if (!jid_view_parse(&from_jid, from)) {
+        return 1;
+    }
 
-    jid_destroy(from_jid);
+    handle_subscription(from_jid.barejid, PRESENCE_SUBSCRIBED);
+    autocomplete_remove(sub_requests_ac, from_jid.barejid);
 
     return 1;
 }
@@ -447,15 +448,13 @@ _subscribe_handler(xmpp_conn_t * const conn,
     char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
     log_debug("Subscribe presence handler fired for %s", from);
 
-    Jid *from_jid = jid_create(from);
-    if (from_jid == NULL) {
+    JidView from_jid;
+    if (!jid_view_parse(&from_jid, from)) {
         return 1;
     }
 
-    handle_subscription(from_jid->barejid, PRESENCE_SUBSCRIBE);
-    autocomplete_add(sub_requests_ac, from_jid->barejid);
-
-    jid_destroy(from_jid);
+    handle_subscription(from_jid.barejid, PRESENCE_SUBSCRIBE);
+    autocomplete_add(sub_requests_ac, from_jid.barejid);
 
     return 1;
 }
@@ -464,37 +463,32 @@ static int
 _unavailable_handler(xmpp_conn_t * const conn,
     xmpp_stanza_t * const stanza, void * const userdata)
 {
-    const char *jid = xmpp_conn_get_jid(conn);
     char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
     log_debug("Unavailable presence handler fired for %s", from);
 
-    Jid *my_jid = jid_create(jid);
-    Jid *from_jid = jid_create(from);
-    if (my_jid == NULL || from_jid == NULL) {
-        jid_destroy(my_jid);
-        jid_destroy(from_jid);
+    const JidView *my_jid = connection_get_jid_view();
+    JidView from_jid;
+    if (my_jid == NULL || !jid_view_parse(&from_jid, from)) {
         return 1;
     }
 
     char *status_str = stanza_get_status(stanza, NULL);
 
-    if (strcmp(my_jid->barejid, from_jid->barejid) !=0) {
-        if (from_jid->resourcepart != NULL) {
-            handle_contact_offline(from_jid->barejid, from_jid->resourcepart, status_str);
+    if (strcmp(my_jid->barejid, from_jid.barejid) !=0) {
+        if (from_jid.resourcepart != NULL) {
+            handle_contact_offline(from_jid.barejid, from_jid.resourcepart, status_str);
 
         // hack for servers that do not send full jid with unavailable presence
         } else {
-            handle_contact_offline(from_jid->barejid, "__prof_default", status_str);
+            handle_contact_offline(from_jid.barejid, "__prof_default", status_str);
         }
     } else {
-        if (from_jid->resourcepart != NULL) {
-            connection_remove_available_resource(from_jid->resourcepart);
+        if (from_jid.resourcepart != NULL) {
+            connection_remove_available_resource(from_jid.resourcepart);
         }
     }
 
     free(status_str);
-    jid_destroy(my_jid);
-    jid_destroy(from_jid);
 
     return 1;
 }
@@ -510,9 +504,13 @@ _handle_caps(char *jid, XMPPCaps *caps)
                 log_info("Capabilities cache hit: %s, for %s.", caps->ver, jid);
                 caps_map_jid_to_ver(jid, caps->ver);
             } else {
-                log_info("Capabilities cache miss: %s, for %s, sending service discovery request", caps->ver, jid);
                 char *id = create_unique_id("caps");
-                iq_send_caps_request(jid, id, caps->node, caps->ver);
+                if (caps->node && caps_request_pending(caps->ver, caps->node, jid, id)) {
+                    log_info("Capabilities request already sent for %s, queued %s", caps->ver, jid);
+                } else {
+                    log_info("Capabilities cache miss: %s, for %s, sending service discovery request", caps->ver, jid);
+                    iq_send_caps_request(jid, id, caps->node, caps->ver);
+                }
                 free(id);
             }
         }
@@ -558,9 +556,9 @@ _available_handler(xmpp_conn_t * const conn,
     }
 
     int err = 0;
-    XMPPPresence *xmpp_presence = stanza_parse_presence(stanza, &err);
+    XMPPPresence xmpp_presence;
 
-    if (!xmpp_presence) {
+    if (!stanza_parse_presence(stanza, &xmpp_presence, &err)) {
         char *from = NULL;
         switch(err) {
             case STANZA_PARSE_ERROR_NO_FROM:
@@ -576,31 +574,31 @@ _available_handler(xmpp_conn_t * const conn,
         }
         return 1;
     } else {
-        char *jid = jid_fulljid_or_barejid(xmpp_presence->jid);
-        log_debug("Presence available handler fired for: %s", jid);
+        log_debug("Presence available handler fired for: %s", jid_view_fulljid_or_barejid(&xmpp_presence.jid));
     }
 
-    const char *my_jid_str = xmpp_conn_get_jid(conn);
-    Jid *my_jid = jid_create(my_jid_str);
+    const JidView *my_jid = connection_get_jid_view();
+    if (my_jid == NULL) {
+        stanza_clear_presence(&xmpp_presence);
+        return 1;
+    }
 
     XMPPCaps *caps = stanza_parse_caps(stanza);
-    if ((g_strcmp0(my_jid->fulljid, xmpp_presence->jid->fulljid) != 0) && caps) {
+    if ((g_strcmp0(my_jid->fulljid, xmpp_presence.jid.fulljid) != 0) && caps) {
         log_info("Presence contains capabilities.");
-        char *jid = jid_fulljid_or_barejid(xmpp_presence->jid);
-        _handle_caps(jid, caps);
+        _handle_caps(jid_view_fulljid_or_barejid(&xmpp_presence.jid), caps);
     }
     stanza_free_caps(caps);
 
-    Resource *resource = stanza_resource_from_presence(xmpp_presence);
+    Resource *resource = stanza_resource_from_presence(&xmpp_presence);
 
-    if (g_strcmp0(xmpp_presence->jid->barejid, my_jid->barejid) == 0) {
+    if (g_strcmp0(xmpp_presence.jid.barejid, my_jid->barejid) == 0) {
         connection_add_available_resource(resource);
     } else {
-        handle_contact_online(xmpp_presence->jid->barejid, resource, xmpp_presence->last_activity);
+        handle_contact_online(xmpp_presence.jid.barejid, resource, xmpp_presence.last_activity);
     }
 
-    jid_destroy(my_jid);
-    stanza_free_presence(xmpp_presence);
+    stanza_clear_presence(&xmpp_presence);
 
     return 1;
 }
@@ -609,14 +607,13 @@ void
 _send_caps_request(char *node, char *caps_key, char *id, char *from)
 {
     xmpp_ctx_t *ctx = connection_get_ctx();
-    xmpp_conn_t *conn = connection_get_conn();
 
     if (node != NULL) {
         log_debug("Node string: %s.", node);
         if (!caps_contains(caps_key)) {
             log_debug("Capabilities not cached for '%s', sending discovery IQ.", from);
             xmpp_stanza_t *iq = stanza_create_disco_info_iq(ctx, id, from, node);
-            xmpp_send(conn, iq);
+            connection_send(iq);
             xmpp_stanza_release(iq);
         } else {
             log_debug("Capabilities already cached, for %s", caps_key);
@@ -638,13 +635,13 @@ _muc_user_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza, void *
     }
 
     // invalid from attribute
-    Jid *from_jid = jid_create(from);
-    if (from_jid == NULL || from_jid->resourcepart == NULL) {
+    JidView from_jid;
+    if (!jid_view_parse(&from_jid, from) || from_jid.resourcepart == NULL) {
         return 1;
     }
 
-    char *room = from_jid->barejid;
-    char *nick = from_jid->resourcepart;
+    char *room = from_jid.barejid;
+    char *nick = from_jid.resourcepart;
 
     char *show_str = stanza_get_show(stanza, "online");
     char *status_str = stanza_get_status(stanza, NULL);
@@ -665,7 +662,7 @@ _muc_user_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza, void *
 
     // handle self presence
     if (stanza_is_muc_self_presence(stanza, jabber_get_fulljid())) {
-        log_debug("Room self presence received from %s", from_jid->fulljid);
+        log_debug("Room self presence received from %s", from_jid.fulljid);
 
         // self unavailable
         if (g_strcmp0(type, STANZA_TYPE_UNAVAILABLE) == 0) {
@@ -718,7 +715,7 @@ _muc_user_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza, void *
 
     // handle presence from room members
     } else {
-        log_debug("Room presence received from %s", from_jid->fulljid);
+        log_debug("Room presence received from %s", from_jid.fulljid);
 
         if (g_strcmp0(type, STANZA_TYPE_UNAVAILABLE) == 0) {
 
@@ -771,7 +768,6 @@ _muc_user_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza, void *
 
     free(show_str);
     free(status_str);
-    jid_destroy(from_jid);
 
     return 1;
 }
\ No newline at end of file
@@ -49,7 +49,7 @@
 #include "xmpp/stanza.h"
 #include "xmpp/xmpp.h"
 
-#define HANDLE(type, func) xmpp_handler_add(conn, func, XMPP_NS_ROSTER, \
+#define HANDLE(type, func) connection_handler_add(func, XMPP_NS_ROSTER, \
 STANZA_NAME_IQ, type, ctx)
 
 // callback data for group commands
@@ -78,7 +78,6 @@ GSList * _get_groups_from_item(xmpp_stanza_t *item);
 void
 roster_add_handlers(void)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     HANDLE(STANZA_TYPE_SET,    _roster_set_handler);
@@ -88,41 +87,37 @@ roster_add_handlers(void)
 void
 roster_request(void)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_roster_iq(ctx);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 roster_send_add_new(const char * const barejid, const char * const name)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_roster_set(ctx, NULL, barejid, name, NULL);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 roster_send_remove(const char * const barejid)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_roster_remove_set(ctx, barejid);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
 void
 roster_send_name_change(const char * const barejid, const char * const new_name, GSList *groups)
 {
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
     xmpp_stanza_t *iq = stanza_create_roster_set(ctx, NULL, barejid, new_name,
         groups);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
 }
 
@@ -147,12 +142,11 @@ roster_send_add_to_group(const char * const group, PContact contact)
         data->name = strdup(p_contact_barejid(contact));
     }
 
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
-    xmpp_id_handler_add(conn, _group_add_handler, unique_id, data);
+    connection_id_handler_add(_group_add_handler, unique_id, data);
     xmpp_stanza_t *iq = stanza_create_roster_set(ctx, unique_id, p_contact_barejid(contact),
         p_contact_name(contact), new_groups);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
     free(unique_id);
 }
@@ -183,7 +177,6 @@ roster_send_remove_from_group(const char * const group, PContact contact)
         groups = g_slist_next(groups);
     }
 
-    xmpp_conn_t * const conn = connection_get_conn();
     xmpp_ctx_t * const ctx = connection_get_ctx();
 
     // add an id handler to handle the response
@@ -196,10 +189,10 @@ roster_send_remove_from_group(const char * const group, PContact contact)
         data->name = strdup(p_contact_barejid(contact));
     }
 
-    xmpp_id_handler_add(conn, _group_remove_handler, unique_id, data);
+    connection_id_handler_add(_group_remove_handler, unique_id, data);
     xmpp_stanza_t *iq = stanza_create_roster_set(ctx, unique_id, p_contact_barejid(contact),
         p_contact_name(contact), new_groups);
-    xmpp_send(conn, iq);
+    connection_send(iq);
     xmpp_stanza_release(iq);
     free(unique_id);
 }
@@ -232,13 +225,10 @@ _roster_set_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
     }
 
     // if from attribute exists and it is not current users barejid, ignore push
-    Jid *my_jid = jid_create(jabber_get_fulljid());
     const char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
-    if ((from != NULL) && (strcmp(from, my_jid->barejid) != 0)) {
-        jid_destroy(my_jid);
+    if ((from != NULL) && (g_strcmp0(from, jabber_get_barejid()) != 0)) {
         return 1;
     }
-    jid_destroy(my_jid);
 
     const char *barejid = xmpp_stanza_get_attribute(item, STANZA_ATTR_JID);
     const char *name = xmpp_stanza_get_attribute(item, STANZA_ATTR_NAME);
@@ -298,6 +288,7 @@ _roster_result_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
         xmpp_stanza_t *query = xmpp_stanza_get_child_by_name(stanza, STANZA_NAME_QUERY);
         xmpp_stanza_t *item = xmpp_stanza_get_children(query);
 
+        roster_load_begin();
         while (item != NULL) {
             const char *barejid = xmpp_stanza_get_attribute(item, STANZA_ATTR_JID);
             const char *name = xmpp_stanza_get_attribute(item, STANZA_ATTR_NAME);
@@ -324,6 +315,7 @@ _roster_result_handler(xmpp_conn_t * const conn, xmpp_stanza_t * const stanza,
 
             item = xmpp_stanza_get_next(item);
         }
+        roster_load_end();
 
         handle_roster_received();
 
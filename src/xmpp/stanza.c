@@ -1050,29 +1050,29 @@ stanza_is_muc_self_presence(xmpp_stanza_t * const stanza,
         // check if 'from' attribute identifies this user
         char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
         if (from) {
-            Jid *from_jid = jid_create(from);
-            if (muc_active(from_jid->barejid)) {
-                char *nick = muc_nick(from_jid->barejid);
-                if (g_strcmp0(from_jid->resourcepart, nick) == 0) {
-                    jid_destroy(from_jid);
+            JidView from_jid;
+            if (!jid_view_parse(&from_jid, from)) {
+                return FALSE;
+            }
+
+            if (muc_active(from_jid.barejid)) {
+                char *nick = muc_nick(from_jid.barejid);
+                if (g_strcmp0(from_jid.resourcepart, nick) == 0) {
                     return TRUE;
                 }
             }
 
             // check if a new nickname maps to a pending nick change for this user
-            if (muc_nick_change_pending(from_jid->barejid)) {
-                char *new_nick = from_jid->resourcepart;
+            if (muc_nick_change_pending(from_jid.barejid)) {
+                char *new_nick = from_jid.resourcepart;
                 if (new_nick) {
-                    char *nick = muc_nick(from_jid->barejid);
-                    char *old_nick = muc_old_nick(from_jid->barejid, new_nick);
+                    char *nick = muc_nick(from_jid.barejid);
+                    char *old_nick = muc_old_nick(from_jid.barejid, new_nick);
                     if (g_strcmp0(old_nick, nick) == 0) {
-                        jid_destroy(from_jid);
                         return TRUE;
                     }
                 }
             }
-
-            jid_destroy(from_jid);
         }
     }
 
@@ -1541,10 +1541,10 @@ stanza_resource_from_presence(XMPPPresence *presence)
     // create Resource
     Resource *resource = NULL;
     resource_presence_t resource_presence = resource_presence_from_string(presence->show);
-    if (presence->jid->resourcepart == NULL) { // hack for servers that do not send full jid
+    if (presence->jid.resourcepart == NULL) { // hack for servers that do not send full jid
         resource = resource_new("__prof_default", resource_presence, presence->status, presence->priority);
     } else {
-        resource = resource_new(presence->jid->resourcepart, resource_presence, presence->status, presence->priority);
+        resource = resource_new(presence->jid.resourcepart, resource_presence, presence->status, presence->priority);
     }
 
     return resource;
@@ -1568,43 +1568,31 @@ stanza_free_caps(XMPPCaps *caps)
 }
 
 void
-stanza_free_presence(XMPPPresence *presence)
+stanza_clear_presence(XMPPPresence *presence)
 {
     if (presence) {
-        if (presence->jid) {
-            jid_destroy(presence->jid);
-        }
         if (presence->last_activity) {
             g_date_time_unref(presence->last_activity);
         }
-        if (presence->show) {
-            free(presence->show);
-        }
-        if (presence->status) {
-            free(presence->status);
-        }
-        FREE_SET_NULL(presence);
+        FREE_SET_NULL(presence->show);
+        FREE_SET_NULL(presence->status);
     }
 }
 
-XMPPPresence *
-stanza_parse_presence(xmpp_stanza_t *stanza, int *err)
+gboolean
+stanza_parse_presence(xmpp_stanza_t *stanza, XMPPPresence *result, int *err)
 {
     char *from = xmpp_stanza_get_attribute(stanza, STANZA_ATTR_FROM);
     if (!from) {
         *err = STANZA_PARSE_ERROR_NO_FROM;
-        return NULL;
+        return FALSE;
     }
 
-    Jid *from_jid = jid_create(from);
-    if (!from_jid) {
+    if (!jid_view_parse(&result->jid, from)) {
         *err = STANZA_PARSE_ERROR_INVALID_FROM;
-        return NULL;
+        return FALSE;
     }
 
-    XMPPPresence *result = (XMPPPresence *)malloc(sizeof(XMPPPresence));
-    result->jid = from_jid;
-
     result->show = stanza_get_show(stanza, "online");
     result->status = stanza_get_status(stanza, NULL);
 
@@ -1627,5 +1615,5 @@ stanza_parse_presence(xmpp_stanza_t *stanza, int *err)
         free(priority_str);
     }
 
-    return result;
+    return TRUE;
 }
@@ -163,8 +163,9 @@ typedef struct caps_stanza_t {
     char *ver;
 } XMPPCaps;
 
+// parsed into a caller owned struct, jid points into the stanza
 typedef struct presence_stanza_t {
-    Jid *jid;
+    JidView jid;
     char *show;
     char *status;
     int priority;
@@ -277,8 +278,8 @@ char* stanza_get_actor(xmpp_stanza_t *stanza);
 char* stanza_get_reason(xmpp_stanza_t *stanza);
 
 Resource* stanza_resource_from_presence(XMPPPresence *presence);
-XMPPPresence* stanza_parse_presence(xmpp_stanza_t *stanza, int *err);
-void stanza_free_presence(XMPPPresence *presence);
+gboolean stanza_parse_presence(xmpp_stanza_t *stanza, XMPPPresence *presence, int *err);
+void stanza_clear_presence(XMPPPresence *presence);
 
 XMPPCaps* stanza_parse_caps(xmpp_stanza_t * const stanza);
 void stanza_free_caps(XMPPCaps *caps);
@@ -0,0 +1,145 @@
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools/autocomplete.h"
+#include "benchmarks.h"
+
+#define BENCH_ITEMS 100000
+#define FUZZY_ITEMS 50000
+
+static char *items[BENCH_ITEMS];
+
+// items in the autocompleter being measured
+static int count;
+
+// filled with count items before each lookup benchmark
+static Autocomplete filled;
+
+static Autocomplete
+_filled(void)
+{
+    Autocomplete ac = autocomplete_new();
+    int i;
+    for (i = 0; i < count; i++) {
+        autocomplete_add(ac, items[i]);
+    }
+
+    return ac;
+}
+
+static void
+_add(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        Autocomplete ac = _filled();
+        benchmark_consume(autocomplete_length(ac));
+        autocomplete_free(ac);
+    }
+}
+
+static void
+_complete(int iterations)
+{
+    Autocomplete ac = filled;
+    int i;
+    for (i = 0; i < iterations; i++) {
+        // a fresh search, then tab through a few matches
+        char search[] = { 'n', 'i', 'c', 'k', '0' + (i % 10), '\0' };
+        int tabs;
+        for (tabs = 0; tabs < 5; tabs++) {
+            gchar *found = autocomplete_complete(ac, search, FALSE);
+            benchmark_consume(found != NULL);
+            free(found);
+        }
+        autocomplete_reset(ac);
+    }
+}
+
+static void
+_contains(int iterations)
+{
+    Autocomplete ac = filled;
+    int i;
+    for (i = 0; i < iterations; i++) {
+        benchmark_consume(autocomplete_contains(ac, items[i % count]));
+    }
+}
+
+// a room's occupants leaving and rejoining
+static void
+_remove_add(int iterations)
+{
+    Autocomplete ac = filled;
+    int i;
+    for (i = 0; i < iterations; i++) {
+        autocomplete_remove(ac, items[i % count]);
+        autocomplete_add(ac, items[i % count]);
+    }
+    benchmark_consume(autocomplete_length(ac));
+}
+
+// nothing starts with the search so every tab ranks the whole list
+static void
+_fuzzy(int iterations)
+{
+    Autocomplete ac = filled;
+    int i;
+    for (i = 0; i < iterations; i++) {
+        char search[] = { 'k', '0' + (i % 10), '7', '\0' };
+        gchar *found = autocomplete_complete(ac, search, FALSE);
+        benchmark_consume(found != NULL);
+        free(found);
+        autocomplete_reset(ac);
+    }
+}
+
+static void
+_run(int items_count)
+{
+    char name[64];
+    count = items_count;
+
+    snprintf(name, sizeof(name), "autocomplete add %d", count);
+    benchmark_run(name, _add, 1);
+
+    filled = _filled();
+    snprintf(name, sizeof(name), "autocomplete complete %d", count);
+    benchmark_run(name, _complete, 10000);
+    snprintf(name, sizeof(name), "autocomplete contains %d", count);
+    benchmark_run(name, _contains, 10000);
+    snprintf(name, sizeof(name), "autocomplete remove add %d", count);
+    benchmark_run(name, _remove_add, 10000);
+    autocomplete_free(filled);
+}
+
+void
+bench_autocomplete(void)
+{
+    // shuffled so adds land all over the list
+    int i;
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        items[i] = g_strdup_printf("nick%d", (int)(((gint64)i * 7919) % BENCH_ITEMS));
+    }
+
+    _run(1000);
+    _run(10000);
+    _run(BENCH_ITEMS);
+
+    autocomplete_set_fuzzy(TRUE);
+    filled = autocomplete_new_fuzzy();
+    for (i = 0; i < FUZZY_ITEMS; i++) {
+        autocomplete_add(filled, items[i]);
+    }
+    // the first fuzzy search builds the character signatures
+    free(autocomplete_complete(filled, "k07", FALSE));
+    autocomplete_reset(filled);
+    benchmark_run("autocomplete fuzzy top 10 50000", _fuzzy, 1000);
+    autocomplete_free(filled);
+
+    for (i = 0; i < BENCH_ITEMS; i++) {
+        g_free(items[i]);
+    }
+}
@@ -0,0 +1 @@
+void bench_autocomplete(void);
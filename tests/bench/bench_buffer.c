@@ -0,0 +1,73 @@
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "ui/buffer.h"
+#include "benchmarks.h"
+
+#define BENCH_LINES BUFF_SIZE
+
+static const char * const senders[] = { "alice", "bob", "carol", "dave", "eve" };
+
+static const char * const messages[] = {
+    "ok",
+    "see you tomorrow",
+    "has anyone tried the new release yet, the changelog looks good",
+    "https://example.org/a/rather/long/pasted/link/to/some/document.html",
+    "Lorem ipsum dolor sit amet, consectetur adipiscing elit, sed do eiusmod "
+        "tempor incididunt ut labore et dolore magna aliqua."
+};
+
+static void
+_push_lines(ProfBuff buffer, int count)
+{
+    int i;
+    for (i = 0; i < count; i++) {
+        buffer_push(buffer, '-', g_get_real_time(), 0, 0,
+            senders[i % G_N_ELEMENTS(senders)], messages[i % G_N_ELEMENTS(messages)]);
+    }
+}
+
+static void
+_push_full(int iterations)
+{
+    ProfBuff buffer = buffer_create();
+    _push_lines(buffer, BENCH_LINES);
+    _push_lines(buffer, iterations);
+    benchmark_consume(buffer_size(buffer));
+    buffer_free(buffer);
+}
+
+static void
+_fill(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        ProfBuff buffer = buffer_create();
+        _push_lines(buffer, BENCH_LINES);
+        benchmark_consume(buffer_size(buffer));
+        buffer_free(buffer);
+    }
+}
+
+void
+bench_buffer(void)
+{
+    benchmark_run("buffer_push full buffer", _push_full, 1000000);
+    benchmark_run("buffer fill 1200 lines", _fill, 1000);
+
+    gsize text = 0;
+    int i;
+    for (i = 0; i < BENCH_LINES; i++) {
+        text += strlen(messages[i % G_N_ELEMENTS(messages)]) + 1;
+    }
+
+    ProfBuff buffer = buffer_create();
+    _push_lines(buffer, BENCH_LINES * 3);
+    benchmark_report("buffer memory per line",
+        (double)buffer_memory(buffer) / BENCH_LINES, "bytes");
+    benchmark_report("buffer memory per line, less text",
+        (double)(buffer_memory(buffer) - text) / BENCH_LINES, "bytes");
+    buffer_free(buffer);
+}
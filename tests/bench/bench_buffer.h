@@ -0,0 +1 @@
+void bench_buffer(void);
@@ -0,0 +1,43 @@
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "jid.h"
+#include "benchmarks.h"
+
+static const char * const froms[] = {
+    "alice@example.org/laptop",
+    "bob@jabber.example.com",
+    "room@conference.example.org/somebody with a long nick",
+    "carol@example.org/Psi+.a4b2c9",
+    "conference.example.org"
+};
+
+static void
+_jid_create(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        Jid *jid = jid_create(froms[i % G_N_ELEMENTS(froms)]);
+        benchmark_consume(strlen(jid->barejid));
+        jid_destroy(jid);
+    }
+}
+
+static void
+_jid_view_parse(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        JidView jid;
+        jid_view_parse(&jid, froms[i % G_N_ELEMENTS(froms)]);
+        benchmark_consume(strlen(jid.barejid));
+    }
+}
+
+void
+bench_jid(void)
+{
+    benchmark_run("jid_create", _jid_create, 1000000);
+    benchmark_run("jid_view_parse", _jid_view_parse, 1000000);
+}
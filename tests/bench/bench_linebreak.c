@@ -0,0 +1,98 @@
+#include <glib.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools/linebreak.h"
+#include "benchmarks.h"
+
+#define PASTE_SIZE (64 * 1024)
+
+static char *ascii_paste;
+static char *wide_paste;
+static char *mixed_paste;
+
+// repeat words until the message is size bytes, with a newline every lines_every words
+static char *
+_create_paste(const char * const words[], int count, int size, int lines_every)
+{
+    GString *paste = g_string_sized_new(size + 32);
+    int i = 0;
+    while (paste->len < size) {
+        g_string_append(paste, words[i % count]);
+        i++;
+        g_string_append_c(paste, i % lines_every == 0 ? '\n' : ' ');
+    }
+
+    return g_string_free(paste, FALSE);
+}
+
+static void
+_layout(const char * const paste, int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        LineLayout *layout = linebreak_layout(paste, 11, 80 + (i % 40), 11);
+        benchmark_consume(layout->count);
+        linebreak_free(layout);
+    }
+}
+
+static void
+_layout_ascii(int iterations)
+{
+    _layout(ascii_paste, iterations);
+}
+
+static void
+_layout_wide(int iterations)
+{
+    _layout(wide_paste, iterations);
+}
+
+static void
+_layout_mixed(int iterations)
+{
+    _layout(mixed_paste, iterations);
+}
+
+static void
+_display_len_ascii(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        benchmark_consume(linebreak_display_len(ascii_paste));
+    }
+}
+
+static void
+_display_len_wide(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        benchmark_consume(linebreak_display_len(wide_paste));
+    }
+}
+
+void
+bench_linebreak(void)
+{
+    const char * const ascii_words[] = { "Lorem", "ipsum", "dolor", "sit", "amet,",
+        "consectetur", "adipiscing", "elit.", "https://example.org/a/rather/long/pasted/link" };
+    const char * const wide_words[] = { "四", "ひらがな", "漢字かな交じり文", "三四五六", "한국어" };
+    const char * const mixed_words[] = { "Lorem", "ipsum", "ひらがな", "dolor", "😀", "café",
+        "三四五六", "consectetur" };
+
+    ascii_paste = _create_paste(ascii_words, G_N_ELEMENTS(ascii_words), PASTE_SIZE, 12);
+    wide_paste = _create_paste(wide_words, G_N_ELEMENTS(wide_words), PASTE_SIZE, 12);
+    mixed_paste = _create_paste(mixed_words, G_N_ELEMENTS(mixed_words), PASTE_SIZE, 12);
+
+    benchmark_run("linebreak_layout ascii 64k", _layout_ascii, 2000);
+    benchmark_run("linebreak_layout wide 64k", _layout_wide, 500);
+    benchmark_run("linebreak_layout mixed 64k", _layout_mixed, 500);
+    benchmark_run("linebreak_display_len ascii 64k", _display_len_ascii, 5000);
+    benchmark_run("linebreak_display_len wide 64k", _display_len_wide, 1000);
+
+    g_free(ascii_paste);
+    g_free(wide_paste);
+    g_free(mixed_paste);
+}
@@ -0,0 +1,123 @@
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "roster_list.h"
+#include "resource.h"
+#include "benchmarks.h"
+
+#define BENCH_CONTACTS 50000
+
+static const char * const groups[] = { "friends", "work", "family", "xmpp", "old school" };
+
+static const resource_presence_t presences[] = {
+    RESOURCE_ONLINE, RESOURCE_ONLINE, RESOURCE_AWAY, RESOURCE_ONLINE, RESOURCE_DND,
+    RESOURCE_XA, RESOURCE_CHAT
+};
+
+static char *barejids[BENCH_CONTACTS];
+static char *names[BENCH_CONTACTS];
+
+// contacts in the roster being measured
+static int count;
+
+// how the initial roster is added, one by one or as a load
+static gboolean bulk;
+
+static void
+_roster_load(void)
+{
+    int i;
+    roster_init();
+    if (bulk) {
+        roster_load_begin();
+    }
+    for (i = 0; i < count; i++) {
+        GSList *contact_groups = NULL;
+        if (i % 3 != 0) {
+            contact_groups = g_slist_append(contact_groups, strdup(groups[i % G_N_ELEMENTS(groups)]));
+        }
+        roster_add(barejids[i], names[i], contact_groups, "both", FALSE);
+    }
+    if (bulk) {
+        roster_load_end();
+    }
+}
+
+// about four in five contacts are online, as after a login
+static void
+_presence_burst(void)
+{
+    int i;
+    for (i = 0; i < count; i++) {
+        if (i % 5 != 0) {
+            Resource *resource = resource_new("laptop",
+                presences[i % G_N_ELEMENTS(presences)], NULL, 0);
+            roster_update_presence(barejids[i], resource, NULL);
+        }
+    }
+}
+
+// what the roster panel asks for once the burst has settled
+static void
+_roster_view(void)
+{
+    benchmark_consume(roster_count_online());
+    GSList *contacts = roster_get_contacts_online();
+    benchmark_consume(g_slist_length(contacts));
+    g_slist_free(contacts);
+}
+
+static void
+_load(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        _roster_load();
+        roster_free();
+    }
+}
+
+static void
+_login(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        _roster_load();
+        _presence_burst();
+        _roster_view();
+        roster_free();
+    }
+}
+
+void
+bench_roster(void)
+{
+    int i;
+    for (i = 0; i < BENCH_CONTACTS; i++) {
+        barejids[i] = g_strdup_printf("contact%d@example.org", i);
+        names[i] = g_strdup_printf("contact %d", i);
+    }
+
+    count = 5000;
+    bulk = FALSE;
+    benchmark_run("roster add 5000 contacts", _load, 5);
+    benchmark_run("roster login 5000 contacts", _login, 5);
+    count = 10000;
+    benchmark_run("roster add 10000 contacts", _load, 1);
+
+    bulk = TRUE;
+    count = 5000;
+    benchmark_run("roster load 5000 contacts", _load, 5);
+    benchmark_run("roster load login 5000 contacts", _login, 5);
+    count = 10000;
+    benchmark_run("roster load 10000 contacts", _load, 5);
+    count = 50000;
+    benchmark_run("roster load 50000 contacts", _load, 1);
+
+    for (i = 0; i < BENCH_CONTACTS; i++) {
+        g_free(barejids[i]);
+        g_free(names[i]);
+    }
+}
@@ -0,0 +1,88 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <glib.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "command/command.h"
+#include "muc.h"
+#include "roster_list.h"
+#include "ui/ui.h"
+#include "helpers.h"
+#include "benchmarks.h"
+
+// every command followed by the start of an argument, as when Tab is pressed
+static char **inputs;
+static int input_count;
+
+// finding the command's completion rules, as on each Tab
+static void
+_dispatch(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        benchmark_consume(cmd_completion_lookup(inputs[i % input_count]));
+    }
+}
+
+// the whole Tab, dispatch then the command's rules until one completes
+static void
+_tab(int iterations)
+{
+    int i;
+    for (i = 0; i < iterations; i++) {
+        char *found = cmd_autocomplete(inputs[i % input_count]);
+        if (found) {
+            benchmark_consume(strlen(found));
+            free(found);
+        }
+        cmd_reset_autocomplete();
+    }
+}
+
+static void
+_bench_completion(void **state)
+{
+    // rules that depend on the window see the console
+    will_return_always(ui_current_win_type, WIN_CONSOLE);
+
+    muc_init();
+    roster_init();
+    roster_add("alice@example.org", "Alice", NULL, "both", FALSE);
+    roster_add("bob@example.org", "Bob", NULL, "both", FALSE);
+    cmd_init();
+
+    Command *commands = cmd_get_all(&input_count);
+    inputs = malloc(input_count * sizeof(char *));
+    int i;
+    for (i = 0; i < input_count; i++) {
+        inputs[i] = g_strconcat(commands[i].cmd, " o", NULL);
+    }
+
+    benchmark_run("trie dispatch all commands", _dispatch, 100000);
+    benchmark_run("trie tab all commands", _tab, 100000);
+
+    for (i = 0; i < input_count; i++) {
+        g_free(inputs[i]);
+    }
+    free(inputs);
+    cmd_uninit();
+    roster_free();
+    muc_close();
+}
+
+void
+bench_trie(void)
+{
+    // the stub UI is mocked, so the benchmarks run as a test
+    const UnitTest benchmarks[] = {
+        unit_test_setup_teardown(_bench_completion,
+            load_preferences,
+            close_preferences),
+    };
+
+    run_tests(benchmarks);
+}
@@ -0,0 +1 @@
+void bench_trie(void);
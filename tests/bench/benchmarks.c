@@ -0,0 +1,60 @@
+#include <glib.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "benchmarks.h"
+#include "bench_linebreak.h"
+#include "bench_buffer.h"
+#include "bench_jid.h"
+#include "bench_roster.h"
+#include "bench_autocomplete.h"
+#include "bench_trie.h"
+
+static const char *filter = NULL;
+static volatile long sink;
+
+void
+benchmark_consume(long value)
+{
+    sink += value;
+}
+
+void
+benchmark_run(const char * const name, void (*func)(int iterations), int iterations)
+{
+    if (filter && strstr(name, filter) == NULL) {
+        return;
+    }
+
+    gint64 start = g_get_monotonic_time();
+    func(iterations);
+    gint64 elapsed = g_get_monotonic_time() - start;
+
+    printf("%-40s %8d ops %10.3f ms %12.3f us/op\n", name, iterations,
+        elapsed / 1000.0, (double)elapsed / iterations);
+}
+
+void
+benchmark_report(const char * const name, double value, const char * const unit)
+{
+    if (filter && strstr(name, filter) == NULL) {
+        return;
+    }
+
+    printf("%-40s %12.1f %s\n", name, value, unit);
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1) {
+        filter = argv[1];
+    }
+
+    bench_linebreak();
+    bench_buffer();
+    bench_jid();
+    bench_roster();
+    bench_autocomplete();
+    bench_trie();
+
+    return 0;
+}
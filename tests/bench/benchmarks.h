@@ -0,0 +1,13 @@
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+// runs the benchmark function, which performs iterations operations, and
+// prints the time taken per operation
+void benchmark_run(const char * const name, void (*func)(int iterations), int iterations);
+
+// prints a measurement other than time, such as memory used
+void benchmark_report(const char * const name, double value, const char * const unit);
+
+// keeps the compiler from discarding results that are otherwise unused
+void benchmark_consume(long value);
+#endif
@@ -39,7 +39,6 @@ char* otr_start_query(void)
     return (char*)mock();
 }
 
-void otr_poll(void) {}
 void otr_on_connect(ProfAccount *account) {}
 
 void otr_keygen(ProfAccount *account)
@@ -117,3 +117,231 @@ void add_two_same_updates(void **state)
     autocomplete_clear(ac);
     g_slist_free_full(result, g_free);
 }
+
+void add_all_adds_sorted_without_duplicates(void **state)
+{
+    Autocomplete ac = autocomplete_new();
+    GSList *items = NULL;
+    items = g_slist_append(items, "Help");
+    items = g_slist_append(items, "About");
+    items = g_slist_append(items, "Hello");
+    items = g_slist_append(items, "Help");
+    autocomplete_add_all(ac, items);
+    GSList *result = autocomplete_create_list(ac);
+
+    assert_int_equal(3, g_slist_length(result));
+    assert_string_equal("About", g_slist_nth_data(result, 0));
+    assert_string_equal("Hello", g_slist_nth_data(result, 1));
+    assert_string_equal("Help", g_slist_nth_data(result, 2));
+
+    autocomplete_free(ac);
+    g_slist_free(items);
+    g_slist_free_full(result, g_free);
+}
+
+void add_all_merges_with_existing(void **state)
+{
+    Autocomplete ac = autocomplete_new();
+    autocomplete_add(ac, "Hello");
+    autocomplete_add(ac, "Zebra");
+    GSList *items = NULL;
+    items = g_slist_append(items, "Help");
+    items = g_slist_append(items, "Hello");
+    items = g_slist_append(items, "About");
+    autocomplete_add_all(ac, items);
+    GSList *result = autocomplete_create_list(ac);
+
+    assert_int_equal(4, g_slist_length(result));
+    assert_string_equal("About", g_slist_nth_data(result, 0));
+    assert_string_equal("Hello", g_slist_nth_data(result, 1));
+    assert_string_equal("Help", g_slist_nth_data(result, 2));
+    assert_string_equal("Zebra", g_slist_nth_data(result, 3));
+
+    autocomplete_free(ac);
+    g_slist_free(items);
+    g_slist_free_full(result, g_free);
+}
+
+void fuzzy_not_used_when_disabled(void **state)
+{
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "/roster");
+
+    char *result = autocomplete_complete(ac, "/rstr", FALSE);
+
+    assert_null(result);
+
+    autocomplete_free(ac);
+}
+
+void fuzzy_not_used_for_plain_autocomplete(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new();
+    autocomplete_add(ac, "/roster");
+
+    char *result = autocomplete_complete(ac, "/rstr", FALSE);
+
+    assert_null(result);
+
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void fuzzy_finds_subsequence(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "/rooms");
+    autocomplete_add(ac, "/roster");
+    autocomplete_add(ac, "/status");
+
+    char *result = autocomplete_complete(ac, "/rstr", FALSE);
+
+    assert_string_equal("/roster", result);
+
+    free(result);
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void fuzzy_ignores_case(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "Bob");
+
+    char *result = autocomplete_complete(ac, "bo", FALSE);
+
+    assert_string_equal("Bob", result);
+
+    free(result);
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void fuzzy_prefers_prefix_matches(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "alice.bob");
+    autocomplete_add(ac, "bobby");
+
+    char *result1 = autocomplete_complete(ac, "bob", FALSE);
+    char *result2 = autocomplete_complete(ac, "bob", FALSE);
+
+    assert_string_equal("bobby", result1);
+    assert_string_equal("bobby", result2);
+
+    free(result1);
+    free(result2);
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void fuzzy_ranks_and_cycles_matches(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "abxoxb");
+    autocomplete_add(ac, "alice.bob");
+    autocomplete_add(ac, "carol");
+
+    char *result1 = autocomplete_complete(ac, "bob", FALSE);
+    char *result2 = autocomplete_complete(ac, "bob", FALSE);
+    char *result3 = autocomplete_complete(ac, "bob", FALSE);
+
+    assert_string_equal("alice.bob", result1);
+    assert_string_equal("abxoxb", result2);
+    assert_string_equal("alice.bob", result3);
+
+    free(result1);
+    free(result2);
+    free(result3);
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void fuzzy_ranks_recently_used_first(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "ann.smith");
+    autocomplete_add(ac, "bob.smith");
+
+    char *result1 = autocomplete_complete(ac, "smith", FALSE);
+    autocomplete_reset(ac);
+    char *result2 = autocomplete_complete(ac, "bob", FALSE);
+    autocomplete_reset(ac);
+    char *result3 = autocomplete_complete(ac, "smith", FALSE);
+
+    assert_string_equal("ann.smith", result1);
+    assert_string_equal("bob.smith", result2);
+    assert_string_equal("bob.smith", result3);
+
+    free(result1);
+    free(result2);
+    free(result3);
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void fuzzy_cycle_survives_remove(void **state)
+{
+    autocomplete_set_fuzzy(TRUE);
+    Autocomplete ac = autocomplete_new_fuzzy();
+    autocomplete_add(ac, "alice.bob");
+    autocomplete_add(ac, "abxoxb");
+    autocomplete_add(ac, "carol.bob");
+
+    char *result1 = autocomplete_complete(ac, "bob", FALSE);
+    autocomplete_remove(ac, "carol.bob");
+    char *result2 = autocomplete_complete(ac, "bob", FALSE);
+
+    assert_string_equal("alice.bob", result1);
+    assert_string_equal("abxoxb", result2);
+
+    free(result1);
+    free(result2);
+    autocomplete_free(ac);
+    autocomplete_set_fuzzy(FALSE);
+}
+
+void reset_all_restarts_search(void **state)
+{
+    Autocomplete ac = autocomplete_new();
+    autocomplete_add(ac, "abc");
+    autocomplete_add(ac, "abd");
+
+    char *result1 = autocomplete_complete(ac, "ab", FALSE);
+    char *result2 = autocomplete_complete(ac, "ab", FALSE);
+    autocomplete_reset_all();
+    char *result3 = autocomplete_complete(ac, "ab", FALSE);
+
+    assert_string_equal("abc", result1);
+    assert_string_equal("abd", result2);
+    assert_string_equal("abc", result3);
+
+    free(result1);
+    free(result2);
+    free(result3);
+    autocomplete_free(ac);
+}
+
+void reset_all_leaves_new_search_alone(void **state)
+{
+    Autocomplete ac = autocomplete_new();
+    autocomplete_add(ac, "abc");
+    autocomplete_add(ac, "abd");
+
+    autocomplete_reset_all();
+    char *result1 = autocomplete_complete(ac, "ab", FALSE);
+    char *result2 = autocomplete_complete(ac, "ab", FALSE);
+
+    assert_string_equal("abc", result1);
+    assert_string_equal("abd", result2);
+
+    free(result1);
+    free(result2);
+    autocomplete_free(ac);
+}
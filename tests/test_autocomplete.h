@@ -8,3 +8,15 @@ void add_two_and_complete_returns_second(void **state);
 void add_two_adds_two(void **state);
 void add_two_same_adds_one(void **state);
 void add_two_same_updates(void **state);
+void add_all_adds_sorted_without_duplicates(void **state);
+void add_all_merges_with_existing(void **state);
+void fuzzy_not_used_when_disabled(void **state);
+void fuzzy_not_used_for_plain_autocomplete(void **state);
+void fuzzy_finds_subsequence(void **state);
+void fuzzy_ignores_case(void **state);
+void fuzzy_prefers_prefix_matches(void **state);
+void fuzzy_ranks_and_cycles_matches(void **state);
+void fuzzy_ranks_recently_used_first(void **state);
+void fuzzy_cycle_survives_remove(void **state);
+void reset_all_restarts_search(void **state);
+void reset_all_leaves_new_search_alone(void **state);
@@ -0,0 +1,268 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#include "ui/buffer.h"
+
+static void
+_push_num(ProfBuff buffer, int num)
+{
+    char message[16];
+    snprintf(message, sizeof(message), "msg%d", num);
+    buffer_push(buffer, '-', g_get_real_time(), 0, 0, "", message);
+}
+
+void buffer_empty_after_create(void **state)
+{
+    ProfBuff buffer = buffer_create();
+
+    assert_int_equal(0, buffer_size(buffer));
+    assert_int_equal(BUFF_SIZE, buffer_capacity(buffer));
+
+    buffer_free(buffer);
+}
+
+void buffer_push_one_increases_size(void **state)
+{
+    ProfBuff buffer = buffer_create();
+    _push_num(buffer, 1);
+
+    assert_int_equal(1, buffer_size(buffer));
+
+    buffer_free(buffer);
+}
+
+void buffer_yield_returns_in_push_order(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(10);
+    _push_num(buffer, 1);
+    _push_num(buffer, 2);
+    _push_num(buffer, 3);
+
+    assert_string_equal("msg1", buffer_yield_entry(buffer, 0)->message);
+    assert_string_equal("msg2", buffer_yield_entry(buffer, 1)->message);
+    assert_string_equal("msg3", buffer_yield_entry(buffer, 2)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_size_stops_at_capacity(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(5);
+    int i;
+    for (i = 0; i < 8; i++) {
+        _push_num(buffer, i);
+    }
+
+    assert_int_equal(5, buffer_size(buffer));
+
+    buffer_free(buffer);
+}
+
+void buffer_evicts_oldest_when_full(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(3);
+    _push_num(buffer, 1);
+    _push_num(buffer, 2);
+    _push_num(buffer, 3);
+    _push_num(buffer, 4);
+
+    assert_string_equal("msg2", buffer_yield_entry(buffer, 0)->message);
+    assert_string_equal("msg3", buffer_yield_entry(buffer, 1)->message);
+    assert_string_equal("msg4", buffer_yield_entry(buffer, 2)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_wraps_many_times(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(100);
+    int i;
+    for (i = 0; i < 1050; i++) {
+        _push_num(buffer, i);
+    }
+
+    assert_int_equal(100, buffer_size(buffer));
+    assert_string_equal("msg950", buffer_yield_entry(buffer, 0)->message);
+    assert_string_equal("msg1049", buffer_yield_entry(buffer, 99)->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_push_has_no_wrap_layout(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(2);
+    _push_num(buffer, 1);
+
+    ProfBuffEntry *e = buffer_yield_entry(buffer, 0);
+    assert_null(e->wrap);
+
+    e->wrap = malloc(sizeof(LineLayout));
+    e->wrap->count = 0;
+    e->wrap->breaks = NULL;
+    _push_num(buffer, 2);
+    _push_num(buffer, 3);
+
+    assert_null(buffer_yield_entry(buffer, 1)->wrap);
+
+    buffer_free(buffer);
+}
+
+void buffer_mark_cleared_hides_pushed_entries(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(10);
+    assert_int_equal(0, buffer_cleared(buffer));
+
+    _push_num(buffer, 1);
+    _push_num(buffer, 2);
+    _push_num(buffer, 3);
+    buffer_mark_cleared(buffer);
+    _push_num(buffer, 4);
+
+    assert_int_equal(3, buffer_cleared(buffer));
+    assert_int_equal(4, buffer_size(buffer));
+    assert_string_equal("msg4", buffer_yield_entry(buffer, buffer_cleared(buffer))->message);
+
+    buffer_free(buffer);
+}
+
+void buffer_cleared_drops_as_oldest_evicted(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(3);
+    _push_num(buffer, 1);
+    _push_num(buffer, 2);
+    _push_num(buffer, 3);
+    buffer_mark_cleared(buffer);
+
+    _push_num(buffer, 4);
+    _push_num(buffer, 5);
+    assert_int_equal(1, buffer_cleared(buffer));
+    assert_string_equal("msg4", buffer_yield_entry(buffer, 1)->message);
+
+    _push_num(buffer, 6);
+    _push_num(buffer, 7);
+    assert_int_equal(0, buffer_cleared(buffer));
+
+    buffer_free(buffer);
+}
+
+void buffer_entry_wrap_reused_for_same_width(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(2);
+    buffer_push(buffer, '-', g_get_real_time(), 0, 0, "", "one two three");
+    ProfBuffEntry *e = buffer_yield_entry(buffer, 0);
+
+    LineLayout *first = buffer_entry_wrap(e, e->message, 0, 10, 0);
+    LineLayout *second = buffer_entry_wrap(e, e->message, 0, 10, 0);
+
+    assert_true(first == second);
+    assert_true(first == e->wrap);
+    assert_int_equal(1, second->count);
+
+    buffer_free(buffer);
+}
+
+void buffer_entry_wrap_rebuilt_when_width_changes(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(2);
+    buffer_push(buffer, '-', g_get_real_time(), 0, 0, "", "one two three");
+    ProfBuffEntry *e = buffer_yield_entry(buffer, 0);
+
+    LineLayout *narrow = buffer_entry_wrap(e, e->message, 0, 10, 0);
+    assert_int_equal(1, narrow->count);
+    assert_int_equal(8, narrow->breaks[0].offset);
+
+    LineLayout *wide = buffer_entry_wrap(e, e->message, 0, 20, 0);
+    assert_int_equal(20, wide->width);
+    assert_int_equal(0, wide->count);
+    assert_true(wide == e->wrap);
+
+    LineLayout *narrower = buffer_entry_wrap(e, e->message, 0, 6, 0);
+    assert_int_equal(6, narrower->width);
+    assert_int_equal(2, narrower->count);
+    assert_int_equal(4, narrower->breaks[0].offset);
+    assert_int_equal(8, narrower->breaks[1].offset);
+
+    buffer_free(buffer);
+}
+
+void buffer_entries_share_sender(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(3);
+    buffer_push(buffer, '-', 0, 0, 0, "bob", "msg1");
+    buffer_push(buffer, '-', 0, 0, 0, "alice", "msg2");
+    buffer_push(buffer, '-', 0, 0, 0, "bob", "msg3");
+
+    assert_string_equal("bob", buffer_yield_entry(buffer, 0)->from);
+    assert_string_equal("alice", buffer_yield_entry(buffer, 1)->from);
+    assert_true(buffer_yield_entry(buffer, 0)->from == buffer_yield_entry(buffer, 2)->from);
+
+    buffer_free(buffer);
+}
+
+void buffer_keeps_sender_after_first_evicted(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(2);
+    buffer_push(buffer, '-', 0, 0, 0, "bob", "msg1");
+    buffer_push(buffer, '-', 0, 0, 0, "bob", "msg2");
+    buffer_push(buffer, '-', 0, 0, 0, "alice", "msg3");
+
+    assert_string_equal("bob", buffer_yield_entry(buffer, 0)->from);
+    assert_string_equal("msg2", buffer_yield_entry(buffer, 0)->message);
+    assert_string_equal("alice", buffer_yield_entry(buffer, 1)->from);
+
+    buffer_free(buffer);
+}
+
+void buffer_keeps_time(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(2);
+    buffer_push(buffer, '-', 1420070400000000, 0, 0, "", "msg1");
+
+    assert_true(buffer_yield_entry(buffer, 0)->time == 1420070400000000);
+
+    buffer_free(buffer);
+}
+
+void buffer_keeps_messages_larger_than_chunk(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(3);
+    GString *large = g_string_new("");
+    while (large->len < 10000) {
+        g_string_append(large, "0123456789");
+    }
+
+    _push_num(buffer, 1);
+    buffer_push(buffer, '-', 0, 0, 0, "", large->str);
+    _push_num(buffer, 2);
+    _push_num(buffer, 3);
+
+    assert_string_equal(large->str, buffer_yield_entry(buffer, 0)->message);
+    assert_string_equal("msg2", buffer_yield_entry(buffer, 1)->message);
+    assert_string_equal("msg3", buffer_yield_entry(buffer, 2)->message);
+
+    g_string_free(large, TRUE);
+    buffer_free(buffer);
+}
+
+void buffer_memory_stays_level_when_full(void **state)
+{
+    ProfBuff buffer = buffer_create_with_capacity(100);
+    int i;
+    for (i = 0; i < 1000; i++) {
+        _push_num(buffer, i % 100);
+    }
+    gsize memory = buffer_memory(buffer);
+
+    for (i = 0; i < 10000; i++) {
+        _push_num(buffer, i % 100);
+    }
+
+    assert_true(buffer_memory(buffer) <= memory);
+
+    buffer_free(buffer);
+}
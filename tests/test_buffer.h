@@ -0,0 +1,16 @@
+void buffer_empty_after_create(void **state);
+void buffer_push_one_increases_size(void **state);
+void buffer_yield_returns_in_push_order(void **state);
+void buffer_size_stops_at_capacity(void **state);
+void buffer_evicts_oldest_when_full(void **state);
+void buffer_wraps_many_times(void **state);
+void buffer_push_has_no_wrap_layout(void **state);
+void buffer_mark_cleared_hides_pushed_entries(void **state);
+void buffer_cleared_drops_as_oldest_evicted(void **state);
+void buffer_entry_wrap_reused_for_same_width(void **state);
+void buffer_entry_wrap_rebuilt_when_width_changes(void **state);
+void buffer_entries_share_sender(void **state);
+void buffer_keeps_sender_after_first_evicted(void **state);
+void buffer_keeps_time(void **state);
+void buffer_keeps_messages_larger_than_chunk(void **state);
+void buffer_memory_stays_level_when_full(void **state);
@@ -0,0 +1,100 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "timers.h"
+#include "xmpp/capabilities.h"
+
+static ProfTimer
+_find_timer(const char * const name)
+{
+    ProfTimer found = NULL;
+    GList *timers = timers_get_all();
+    GList *curr = timers;
+    while (curr) {
+        ProfTimer timer = curr->data;
+        if (g_strcmp0(timerwheel_timer_name(timer), name) == 0 &&
+                timerwheel_timer_pending(timer)) {
+            found = timer;
+        }
+        curr = g_list_next(curr);
+    }
+    g_list_free(timers);
+
+    return found;
+}
+
+static void
+_expire_request(void)
+{
+    ProfTimer timer = _find_timer("caps request");
+    assert_non_null(timer);
+    timers_reset(timer, 0);
+
+    // the wheel may already be on the next tick, run once the clock reaches it
+    g_usleep(2000);
+    timers_run();
+}
+
+void caps_request_queues_while_in_flight(void **state)
+{
+    caps_init();
+
+    assert_false(caps_request_pending("ver1", "node1", "bob@server/res", "caps1"));
+    assert_true(caps_request_pending("ver1", "node1", "alice@server/res", "caps2"));
+    assert_non_null(_find_timer("caps request"));
+
+    caps_close();
+}
+
+void caps_request_asks_next_contact_on_timeout(void **state)
+{
+    caps_init();
+    caps_request_pending("ver1", "node1", "bob@server/res", "caps1");
+    caps_request_pending("ver1", "node1", "alice@server/res", "caps2");
+
+    expect_string(iq_send_caps_request, to, "alice@server/res");
+    expect_string(iq_send_caps_request, node, "node1");
+    expect_string(iq_send_caps_request, ver, "ver1");
+
+    _expire_request();
+
+    assert_non_null(_find_timer("caps request"));
+
+    caps_close();
+}
+
+void caps_request_ignores_reply_after_timeout(void **state)
+{
+    caps_init();
+    caps_request_pending("ver1", "node1", "bob@server/res", "caps1");
+    caps_request_pending("ver1", "node1", "alice@server/res", "caps2");
+    caps_request_pending("ver1", "node1", "carol@server/res", "caps3");
+
+    expect_string(iq_send_caps_request, to, "alice@server/res");
+    expect_string(iq_send_caps_request, node, "node1");
+    expect_string(iq_send_caps_request, ver, "ver1");
+    _expire_request();
+
+    // bob answers late, alice is still being asked
+    caps_request_next("ver1", "caps1");
+
+    caps_close();
+}
+
+void caps_request_done_when_none_waiting(void **state)
+{
+    caps_init();
+    caps_request_pending("ver1", "node1", "bob@server/res", "caps1");
+
+    _expire_request();
+
+    assert_null(_find_timer("caps request"));
+    assert_false(caps_request_pending("ver1", "node1", "alice@server/res", "caps2"));
+
+    caps_close();
+}
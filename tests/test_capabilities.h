@@ -0,0 +1,4 @@
+void caps_request_queues_while_in_flight(void **state);
+void caps_request_asks_next_contact_on_timeout(void **state);
+void caps_request_ignores_reply_after_timeout(void **state);
+void caps_request_done_when_none_waiting(void **state);
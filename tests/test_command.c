@@ -0,0 +1,46 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "command/command.h"
+#include "command/commands.h"
+
+void cmd_get_finds_every_command(void **state)
+{
+    cmd_init();
+
+    int count = 0;
+    Command *all = cmd_get_all(&count);
+    assert_true(count > 0);
+
+    int i;
+    for (i = 0; i < count; i++) {
+        assert_true(cmd_get(all[i].cmd) == &all[i]);
+    }
+
+    cmd_uninit();
+}
+
+void cmd_get_unknown_returns_null(void **state)
+{
+    cmd_init();
+
+    assert_null(cmd_get("/nosuchcommand"));
+    assert_null(cmd_get("help"));
+    assert_null(cmd_get("/hel"));
+    assert_null(cmd_get(""));
+
+    cmd_uninit();
+}
+
+void cmd_get_after_uninit_returns_null(void **state)
+{
+    cmd_init();
+    cmd_uninit();
+
+    assert_null(cmd_get("/help"));
+}
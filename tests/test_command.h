@@ -0,0 +1,3 @@
+void cmd_get_finds_every_command(void **state);
+void cmd_get_unknown_returns_null(void **state);
+void cmd_get_after_uninit_returns_null(void **state);
@@ -46,12 +46,6 @@ void test_p_sha1_hash5(void **state);
 void test_p_sha1_hash6(void **state);
 void test_p_sha1_hash6(void **state);
 void test_p_sha1_hash7(void **state);
-void utf8_display_len_null_str(void **state);
-void utf8_display_len_1_non_wide(void **state);
-void utf8_display_len_1_wide(void **state);
-void utf8_display_len_non_wide(void **state);
-void utf8_display_len_wide(void **state);
-void utf8_display_len_all_wide(void **state);
 void strip_quotes_does_nothing_when_no_quoted(void **state);
 void strip_quotes_strips_first(void **state);
 void strip_quotes_strips_last(void **state);
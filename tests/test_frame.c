@@ -0,0 +1,93 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+
+#include "ui/frame.h"
+
+static void
+_new_frame(int fps)
+{
+    frame_reset();
+    frame_set_rate(fps);
+}
+
+void frame_first_frame_draws_all(void **state)
+{
+    _new_frame(60);
+
+    assert_int_equal(FRAME_ALL, frame_begin(1000));
+    assert_int_equal(1, frame_rendered());
+}
+
+void frame_nothing_dirty_skips_frame(void **state)
+{
+    _new_frame(60);
+    frame_begin(1000);
+
+    assert_int_equal(0, frame_begin(2000));
+    assert_int_equal(1, frame_skipped());
+    assert_int_equal(-1, frame_next_timeout(2000));
+}
+
+void frame_draws_only_dirty_parts(void **state)
+{
+    _new_frame(60);
+    frame_begin(1000);
+
+    frame_mark_dirty(FRAME_STATUSBAR);
+    frame_mark_dirty(FRAME_INPUT);
+
+    assert_int_equal(FRAME_STATUSBAR | FRAME_INPUT, frame_begin(2000));
+    assert_int_equal(0, frame_dirty());
+}
+
+void frame_defers_frame_within_interval(void **state)
+{
+    _new_frame(10);
+    frame_begin(1000);
+
+    frame_mark_dirty(FRAME_WINDOW);
+
+    assert_int_equal(0, frame_begin(1040));
+    assert_int_equal(1, frame_deferred());
+    assert_int_equal(60, frame_next_timeout(1040));
+    assert_int_equal(FRAME_WINDOW, frame_dirty());
+}
+
+void frame_draws_deferred_frame_after_interval(void **state)
+{
+    _new_frame(10);
+    frame_begin(1000);
+
+    frame_mark_dirty(FRAME_WINDOW);
+    frame_begin(1040);
+    frame_mark_dirty(FRAME_TITLEBAR);
+
+    assert_int_equal(FRAME_WINDOW | FRAME_TITLEBAR, frame_begin(1100));
+    assert_int_equal(2, frame_rendered());
+}
+
+void frame_uncapped_never_defers(void **state)
+{
+    _new_frame(0);
+    frame_begin(1000);
+
+    frame_mark_dirty(FRAME_WINDOW);
+
+    assert_int_equal(FRAME_WINDOW, frame_begin(1000));
+    assert_int_equal(0, frame_deferred());
+}
+
+void frame_begin_now_ignores_cap(void **state)
+{
+    _new_frame(1);
+    frame_begin(1000);
+
+    frame_mark_dirty(FRAME_INPUT);
+
+    assert_int_equal(FRAME_INPUT, frame_begin_now(1001));
+    assert_int_equal(-1, frame_next_timeout(1001));
+}
@@ -0,0 +1,7 @@
+void frame_first_frame_draws_all(void **state);
+void frame_nothing_dirty_skips_frame(void **state);
+void frame_draws_only_dirty_parts(void **state);
+void frame_defers_frame_within_interval(void **state);
+void frame_draws_deferred_frame_after_interval(void **state);
+void frame_uncapped_never_defers(void **state);
+void frame_begin_now_ignores_cap(void **state);
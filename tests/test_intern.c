@@ -0,0 +1,95 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools/intern.h"
+
+void intern_equal_strings_share_copy(void **state)
+{
+    char first[] = "bob@server.org";
+    char second[] = "bob@server.org";
+
+    const char *first_ref = intern_ref(first);
+    const char *second_ref = intern_ref(second);
+
+    assert_true(first_ref == second_ref);
+    assert_true(first_ref != first);
+    assert_string_equal("bob@server.org", first_ref);
+
+    intern_unref(first_ref);
+    intern_unref(second_ref);
+}
+
+void intern_different_strings_differ(void **state)
+{
+    const char *bob = intern_ref("bob@server.org");
+    const char *alice = intern_ref("alice@server.org");
+
+    assert_true(bob != alice);
+    assert_string_equal("bob@server.org", bob);
+    assert_string_equal("alice@server.org", alice);
+
+    intern_unref(bob);
+    intern_unref(alice);
+}
+
+void intern_lookup_finds_held_string(void **state)
+{
+    const char *ref = intern_ref("room@conference.server.org");
+
+    assert_true(ref == intern_lookup("room@conference.server.org"));
+
+    intern_unref(ref);
+}
+
+void intern_lookup_unheld_returns_null(void **state)
+{
+    assert_null(intern_lookup("nobody@server.org"));
+}
+
+void intern_string_freed_after_last_unref(void **state)
+{
+    guint count = intern_count();
+    const char *first_ref = intern_ref("carol@server.org");
+    const char *second_ref = intern_ref("carol@server.org");
+
+    assert_int_equal(count + 1, intern_count());
+
+    intern_unref(first_ref);
+    assert_true(second_ref == intern_lookup("carol@server.org"));
+
+    intern_unref(second_ref);
+    assert_null(intern_lookup("carol@server.org"));
+    assert_int_equal(count, intern_count());
+}
+
+void intern_counts_refs_and_saved_bytes(void **state)
+{
+    guint refs = intern_refs();
+    gsize saved = intern_saved();
+
+    const char *first_ref = intern_ref("dave");
+    const char *second_ref = intern_ref("dave");
+    const char *third_ref = intern_ref("dave");
+
+    assert_int_equal(refs + 3, intern_refs());
+    assert_int_equal(saved + 2 * (strlen("dave") + 1), intern_saved());
+
+    intern_unref(first_ref);
+    intern_unref(second_ref);
+    intern_unref(third_ref);
+
+    assert_int_equal(refs, intern_refs());
+    assert_int_equal(saved, intern_saved());
+}
+
+void intern_null_is_null(void **state)
+{
+    assert_null(intern_ref(NULL));
+    assert_null(intern_lookup(NULL));
+    intern_unref(NULL);
+}
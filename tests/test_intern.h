@@ -0,0 +1,7 @@
+void intern_equal_strings_share_copy(void **state);
+void intern_different_strings_differ(void **state);
+void intern_lookup_finds_held_string(void **state);
+void intern_lookup_unheld_returns_null(void **state);
+void intern_string_freed_after_last_unref(void **state);
+void intern_counts_refs_and_saved_bytes(void **state);
+void intern_null_is_null(void **state);
@@ -0,0 +1,143 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+
+#include "tools/intset.h"
+
+static IntSet
+_set_of(int *values, int count)
+{
+    IntSet set = intset_new();
+    int i;
+    for (i = 0; i < count; i++) {
+        intset_add(set, values[i]);
+    }
+
+    return set;
+}
+
+void intset_keeps_values_in_order(void **state)
+{
+    int values[] = { 7, 2, 11, 1, 5 };
+    IntSet set = _set_of(values, 5);
+
+    assert_int_equal(5, intset_size(set));
+    assert_int_equal(1, intset_nth(set, 0));
+    assert_int_equal(2, intset_nth(set, 1));
+    assert_int_equal(5, intset_nth(set, 2));
+    assert_int_equal(7, intset_nth(set, 3));
+    assert_int_equal(11, intset_nth(set, 4));
+
+    intset_free(set);
+}
+
+void intset_add_existing_returns_false(void **state)
+{
+    IntSet set = intset_new();
+
+    assert_true(intset_add(set, 3));
+    assert_false(intset_add(set, 3));
+    assert_int_equal(1, intset_size(set));
+
+    intset_free(set);
+}
+
+void intset_remove_missing_returns_false(void **state)
+{
+    int values[] = { 1, 2, 3 };
+    IntSet set = _set_of(values, 3);
+
+    assert_true(intset_remove(set, 2));
+    assert_false(intset_remove(set, 2));
+    assert_false(intset_contains(set, 2));
+    assert_int_equal(2, intset_size(set));
+
+    intset_free(set);
+}
+
+void intset_next_and_prev_of_member(void **state)
+{
+    int values[] = { 1, 4, 9 };
+    IntSet set = _set_of(values, 3);
+
+    assert_int_equal(9, intset_next(set, 4));
+    assert_int_equal(1, intset_prev(set, 4));
+    assert_int_equal(INTSET_NONE, intset_next(set, 9));
+    assert_int_equal(INTSET_NONE, intset_prev(set, 1));
+
+    intset_free(set);
+}
+
+void intset_next_and_prev_of_non_member(void **state)
+{
+    int values[] = { 1, 4, 9 };
+    IntSet set = _set_of(values, 3);
+
+    assert_int_equal(4, intset_next(set, 2));
+    assert_int_equal(1, intset_prev(set, 2));
+    assert_int_equal(1, intset_next(set, 0));
+    assert_int_equal(9, intset_prev(set, 20));
+
+    intset_free(set);
+}
+
+void intset_first_and_last_of_empty_is_none(void **state)
+{
+    IntSet set = intset_new();
+
+    assert_int_equal(INTSET_NONE, intset_first(set));
+    assert_int_equal(INTSET_NONE, intset_last(set));
+
+    intset_free(set);
+}
+
+void intset_first_gap_when_from_missing(void **state)
+{
+    int values[] = { 3, 4 };
+    IntSet set = _set_of(values, 2);
+
+    assert_int_equal(2, intset_first_gap(set, 2));
+
+    intset_free(set);
+}
+
+void intset_first_gap_inside_run(void **state)
+{
+    int values[] = { 1, 2, 3, 5, 6 };
+    IntSet set = _set_of(values, 5);
+
+    assert_int_equal(4, intset_first_gap(set, 1));
+
+    intset_free(set);
+}
+
+void intset_first_gap_after_run(void **state)
+{
+    IntSet set = intset_new();
+    int i;
+    for (i = 1; i <= 300; i++) {
+        intset_add(set, i);
+    }
+
+    assert_int_equal(301, intset_first_gap(set, 1));
+
+    intset_remove(set, 150);
+    assert_int_equal(150, intset_first_gap(set, 1));
+
+    intset_free(set);
+}
+
+void intset_index_of_value(void **state)
+{
+    int values[] = { 2, 4, 6 };
+    IntSet set = _set_of(values, 3);
+
+    assert_int_equal(1, intset_index(set, 4));
+    assert_int_equal(2, intset_index(set, 5));
+    assert_int_equal(3, intset_index(set, 7));
+
+    intset_free(set);
+}
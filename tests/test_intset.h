@@ -0,0 +1,10 @@
+void intset_keeps_values_in_order(void **state);
+void intset_add_existing_returns_false(void **state);
+void intset_remove_missing_returns_false(void **state);
+void intset_next_and_prev_of_member(void **state);
+void intset_next_and_prev_of_non_member(void **state);
+void intset_first_and_last_of_empty_is_none(void **state);
+void intset_first_gap_when_from_missing(void **state);
+void intset_first_gap_inside_run(void **state);
+void intset_first_gap_after_run(void **state);
+void intset_index_of_value(void **state);
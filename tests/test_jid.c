@@ -3,6 +3,7 @@
 #include <setjmp.h>
 #include <cmocka.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "jid.h"
 
@@ -182,4 +183,116 @@ void returns_barejid_when_fulljid_not_exists(void **state)
     char *result = jid_fulljid_or_barejid(jid);
 
     assert_string_equal("localpart@domainpart", result);
-}
\ No newline at end of file
+}
+void view_from_null_returns_false(void **state)
+{
+    JidView view;
+    assert_false(jid_view_parse(&view, NULL));
+}
+
+void view_from_empty_string_returns_false(void **state)
+{
+    JidView view;
+    assert_false(jid_view_parse(&view, ""));
+}
+
+void view_with_leading_separator_returns_false(void **state)
+{
+    JidView view;
+    assert_false(jid_view_parse(&view, "/laptop"));
+    assert_false(jid_view_parse(&view, "@mydomain"));
+}
+
+void view_from_invalid_utf8_returns_false(void **state)
+{
+    JidView view;
+    assert_false(jid_view_parse(&view, "my\xc3user@mydomain"));
+}
+
+void view_from_full_points_into_string(void **state)
+{
+    const char *str = "myuser@mydomain/laptop";
+    JidView view;
+
+    assert_true(jid_view_parse(&view, str));
+
+    assert_true(str == view.fulljid);
+    assert_true(str + 16 == view.resourcepart);
+    assert_string_equal("myuser@mydomain", view.barejid);
+    assert_true(jid_view_localpart_equals(&view, "myuser"));
+    assert_true(jid_view_domainpart_equals(&view, "mydomain"));
+}
+
+void view_from_bare_has_no_resource(void **state)
+{
+    JidView view;
+
+    assert_true(jid_view_parse(&view, "myuser@mydomain"));
+
+    assert_null(view.fulljid);
+    assert_null(view.resourcepart);
+    assert_string_equal("myuser@mydomain", view.barejid);
+    assert_string_equal("myuser@mydomain", jid_view_fulljid_or_barejid(&view));
+}
+
+void view_from_nolocal_has_no_localpart(void **state)
+{
+    JidView view;
+
+    assert_true(jid_view_parse(&view, "mydomain/laptop"));
+
+    assert_false(jid_view_has_localpart(&view));
+    assert_true(jid_view_localpart_equals(&view, NULL));
+    assert_true(jid_view_domainpart_equals(&view, "mydomain"));
+    assert_false(jid_view_domainpart_equals(&view, "mydomai"));
+    assert_string_equal("laptop", view.resourcepart);
+}
+
+void view_with_at_and_slash_in_resource(void **state)
+{
+    JidView view;
+
+    assert_true(jid_view_parse(&view, "room@conference.domain.org/my@nick/something"));
+
+    assert_true(jid_view_localpart_equals(&view, "room"));
+    assert_true(jid_view_domainpart_equals(&view, "conference.domain.org"));
+    assert_string_equal("my@nick/something", view.resourcepart);
+    assert_string_equal("room@conference.domain.org", view.barejid);
+}
+
+void view_matches_jid_create(void **state)
+{
+    const char *jids[] = { "a@b", "a@b/c", "b/c", "b", "a@b/", "room@conf/nick/", "a@b@c/d" };
+    int i;
+
+    for (i = 0; i < 7; i++) {
+        Jid *jid = jid_create(jids[i]);
+        JidView view;
+        assert_true(jid_view_parse(&view, jids[i]));
+
+        assert_string_equal(jid->barejid, view.barejid);
+        assert_true(jid_view_localpart_equals(&view, jid->localpart));
+        assert_true(jid_view_domainpart_equals(&view, jid->domainpart));
+        if (jid->resourcepart) {
+            assert_string_equal(jid->resourcepart, view.resourcepart);
+            assert_string_equal(jid->fulljid, view.fulljid);
+        } else {
+            assert_null(view.resourcepart);
+        }
+        jid_destroy(jid);
+    }
+}
+
+void view_rejects_too_long(void **state)
+{
+    char str[JID_MAX_LEN + 2];
+    memset(str, 'a', sizeof(str) - 1);
+    str[sizeof(str) - 1] = '\0';
+    JidView view;
+
+    assert_false(jid_view_parse(&view, str));
+
+    str[JID_MAX_LEN] = '\0';
+    assert_true(jid_view_parse(&view, str));
+    assert_int_equal(JID_MAX_LEN, strlen(view.barejid));
+}
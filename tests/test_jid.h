@@ -23,3 +23,13 @@ void create_with_at_and_slash_in_resource(void **state);
 void create_full_with_trailing_slash(void **state);
 void returns_fulljid_when_exists(void **state);
 void returns_barejid_when_fulljid_not_exists(void **state);
+void view_from_null_returns_false(void **state);
+void view_from_empty_string_returns_false(void **state);
+void view_with_leading_separator_returns_false(void **state);
+void view_from_invalid_utf8_returns_false(void **state);
+void view_from_full_points_into_string(void **state);
+void view_from_bare_has_no_resource(void **state);
+void view_from_nolocal_has_no_localpart(void **state);
+void view_with_at_and_slash_in_resource(void **state);
+void view_matches_jid_create(void **state);
+void view_rejects_too_long(void **state);
@@ -0,0 +1,121 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+
+#include "tools/linebreak.h"
+
+void linebreak_display_len_null_str(void **state)
+{
+    int result = linebreak_display_len(NULL);
+
+    assert_int_equal(0, result);
+}
+
+void linebreak_display_len_1_non_wide(void **state)
+{
+    int result = linebreak_display_len("1");
+
+    assert_int_equal(1, result);
+}
+
+void linebreak_display_len_1_wide(void **state)
+{
+    int result = linebreak_display_len("四");
+
+    assert_int_equal(2, result);
+}
+
+void linebreak_display_len_non_wide(void **state)
+{
+    int result = linebreak_display_len("123456789abcdef");
+
+    assert_int_equal(15, result);
+}
+
+void linebreak_display_len_wide(void **state)
+{
+    int result = linebreak_display_len("12三四56");
+
+    assert_int_equal(8, result);
+}
+
+void linebreak_display_len_all_wide(void **state)
+{
+    int result = linebreak_display_len("ひらがな");
+
+    assert_int_equal(8, result);
+}
+
+void linebreak_display_len_combining_is_zero_width(void **state)
+{
+    int result = linebreak_display_len("e\xcc\x81");
+
+    assert_int_equal(1, result);
+}
+
+void linebreak_display_len_long_ascii(void **state)
+{
+    int result = linebreak_display_len("a string longer than sixteen bytes with spaces\nand a newline");
+
+    assert_int_equal(60, result);
+}
+
+void linebreak_no_breaks_when_message_fits(void **state)
+{
+    LineLayout *layout = linebreak_layout("one two three", 0, 20, 0);
+
+    assert_int_equal(0, layout->count);
+
+    linebreak_free(layout);
+}
+
+void linebreak_wraps_word_that_does_not_fit(void **state)
+{
+    LineLayout *layout = linebreak_layout("one two three", 0, 10, 0);
+
+    assert_int_equal(1, layout->count);
+    assert_int_equal(8, layout->breaks[0].offset);
+    assert_int_equal(BREAK_WRAP, layout->breaks[0].type);
+
+    linebreak_free(layout);
+}
+
+void linebreak_wraps_by_display_width(void **state)
+{
+    // each character is two columns wide, so the second word needs 8 columns
+    LineLayout *layout = linebreak_layout("ab \xe4\xb8\x89\xe5\x9b\x9b\xe4\xba\x94\xe5\x85\xad", 0, 10, 0);
+
+    assert_int_equal(1, layout->count);
+    assert_int_equal(3, layout->breaks[0].offset);
+    assert_int_equal(BREAK_WRAP, layout->breaks[0].type);
+
+    linebreak_free(layout);
+}
+
+void linebreak_indents_after_newline(void **state)
+{
+    LineLayout *layout = linebreak_layout("one\ntwo", 11, 40, 11);
+
+    assert_int_equal(1, layout->count);
+    assert_int_equal(3, layout->breaks[0].offset);
+    assert_int_equal(BREAK_NEWLINE, layout->breaks[0].type);
+
+    linebreak_free(layout);
+}
+
+void linebreak_indents_long_word_on_each_row(void **state)
+{
+    LineLayout *layout = linebreak_layout("aaaaaaaaaaaaaaaaaaaa", 8, 12, 8);
+
+    assert_int_equal(4, layout->count);
+    assert_int_equal(4, layout->breaks[0].offset);
+    assert_int_equal(BREAK_INDENT, layout->breaks[0].type);
+    assert_int_equal(8, layout->breaks[1].offset);
+    assert_int_equal(12, layout->breaks[2].offset);
+    assert_int_equal(16, layout->breaks[3].offset);
+
+    linebreak_free(layout);
+}
@@ -0,0 +1,13 @@
+void linebreak_display_len_null_str(void **state);
+void linebreak_display_len_1_non_wide(void **state);
+void linebreak_display_len_1_wide(void **state);
+void linebreak_display_len_non_wide(void **state);
+void linebreak_display_len_wide(void **state);
+void linebreak_display_len_all_wide(void **state);
+void linebreak_display_len_combining_is_zero_width(void **state);
+void linebreak_display_len_long_ascii(void **state);
+void linebreak_no_breaks_when_message_fits(void **state);
+void linebreak_wraps_word_that_does_not_fit(void **state);
+void linebreak_wraps_by_display_width(void **state);
+void linebreak_indents_after_newline(void **state);
+void linebreak_indents_long_word_on_each_row(void **state);
@@ -31,3 +31,70 @@ void statuses_muc_defaults_to_all(void **state)
     assert_non_null(setting);
     assert_string_equal("all", setting);
 }
+
+void peek_string_returns_default(void **state)
+{
+    const char *setting = prefs_peek_string(PREF_TIME);
+
+    assert_string_equal("seconds", setting);
+}
+
+void peek_string_returns_same_value_each_call(void **state)
+{
+    const char *first = prefs_peek_string(PREF_STATUSES_CONSOLE);
+    const char *second = prefs_peek_string(PREF_STATUSES_CONSOLE);
+
+    assert_true(first == second);
+}
+
+void peek_string_returns_value_after_set(void **state)
+{
+    prefs_set_string(PREF_TIME, "minutes");
+
+    assert_string_equal("minutes", prefs_peek_string(PREF_TIME));
+}
+
+void peek_string_returns_default_after_unset(void **state)
+{
+    prefs_set_string(PREF_STATUSES_CONSOLE, "none");
+    prefs_set_string(PREF_STATUSES_CONSOLE, NULL);
+
+    assert_string_equal("all", prefs_peek_string(PREF_STATUSES_CONSOLE));
+}
+
+void get_boolean_returns_value_after_set(void **state)
+{
+    assert_true(prefs_get_boolean(PREF_WRAP));
+
+    prefs_set_boolean(PREF_WRAP, FALSE);
+
+    assert_false(prefs_get_boolean(PREF_WRAP));
+}
+
+void get_reconnect_returns_value_after_set(void **state)
+{
+    assert_int_equal(30, prefs_get_reconnect());
+
+    prefs_set_reconnect(50);
+
+    assert_int_equal(50, prefs_get_reconnect());
+}
+
+void load_raises_no_criticals(void **state)
+{
+    GLogLevelFlags fatal = g_log_set_always_fatal(G_LOG_FATAL_MASK | G_LOG_LEVEL_CRITICAL);
+
+    prefs_close();
+    prefs_load();
+
+    g_log_set_always_fatal(fatal);
+}
+
+void get_frame_rate_returns_value_after_set(void **state)
+{
+    assert_int_equal(60, prefs_get_frame_rate());
+
+    prefs_set_frame_rate(0);
+
+    assert_int_equal(0, prefs_get_frame_rate());
+}
@@ -1,3 +1,11 @@
 void statuses_console_defaults_to_all(void **state);
 void statuses_chat_defaults_to_all(void **state);
 void statuses_muc_defaults_to_all(void **state);
+void peek_string_returns_default(void **state);
+void peek_string_returns_same_value_each_call(void **state);
+void peek_string_returns_value_after_set(void **state);
+void peek_string_returns_default_after_unset(void **state);
+void get_boolean_returns_value_after_set(void **state);
+void get_reconnect_returns_value_after_set(void **state);
+void get_frame_rate_returns_value_after_set(void **state);
+void load_raises_no_criticals(void **state);
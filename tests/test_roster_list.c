@@ -7,6 +7,7 @@
 #include <stdlib.h>
 
 #include "contact.h"
+#include "resource.h"
 #include "roster_list.h"
 
 void empty_list_when_none_added(void **state)
@@ -269,3 +270,195 @@ void find_twice_returns_first_when_two_match_and_reset(void **state)
     free(result2);
     roster_free();
 }
+
+void contacts_ordered_by_name_or_barejid(void **state)
+{
+    roster_init();
+    roster_add("zed@server.org", "alice", NULL, NULL, FALSE);
+    roster_add("bob@server.org", NULL, NULL, NULL, FALSE);
+    roster_add("amy@server.org", "carol", NULL, NULL, FALSE);
+
+    GSList *list = roster_get_contacts();
+
+    assert_int_equal(3, g_slist_length(list));
+    assert_string_equal("zed@server.org", p_contact_barejid(list->data));
+    assert_string_equal("bob@server.org", p_contact_barejid(list->next->data));
+    assert_string_equal("amy@server.org", p_contact_barejid(list->next->next->data));
+    g_slist_free(list);
+    roster_free();
+}
+
+void change_name_moves_contact(void **state)
+{
+    roster_init();
+    roster_add("james@server.org", "James", NULL, NULL, FALSE);
+    roster_add("dave@server.org", "Dave", NULL, NULL, FALSE);
+
+    roster_change_name(roster_get_contact("dave@server.org"), "Zack");
+    GSList *list = roster_get_contacts();
+
+    assert_string_equal("james@server.org", p_contact_barejid(list->data));
+    assert_string_equal("dave@server.org", p_contact_barejid(list->next->data));
+    g_slist_free(list);
+    roster_free();
+}
+
+void presence_change_moves_contact_between_presences(void **state)
+{
+    roster_init();
+    roster_add("james@server.org", NULL, NULL, NULL, FALSE);
+    roster_add("dave@server.org", NULL, NULL, NULL, FALSE);
+
+    Resource *resource = resource_new("laptop", RESOURCE_AWAY, NULL, 0);
+    roster_update_presence("dave@server.org", resource, NULL);
+    GSList *away = roster_get_contacts_by_presence("away");
+    GSList *offline = roster_get_contacts_by_presence("offline");
+    GSList *online = roster_get_contacts_online();
+
+    assert_int_equal(1, g_slist_length(away));
+    assert_string_equal("dave@server.org", p_contact_barejid(away->data));
+    assert_int_equal(1, g_slist_length(offline));
+    assert_string_equal("james@server.org", p_contact_barejid(offline->data));
+    assert_int_equal(1, g_slist_length(online));
+    assert_string_equal("dave@server.org", p_contact_barejid(online->data));
+    g_slist_free(away);
+    g_slist_free(offline);
+    g_slist_free(online);
+    roster_free();
+}
+
+void offline_moves_contact_back_to_offline(void **state)
+{
+    roster_init();
+    roster_add("james@server.org", NULL, NULL, NULL, FALSE);
+    roster_add("dave@server.org", NULL, NULL, NULL, FALSE);
+    Resource *resource = resource_new("laptop", RESOURCE_DND, NULL, 0);
+    roster_update_presence("dave@server.org", resource, NULL);
+
+    roster_contact_offline("dave@server.org", "laptop", NULL);
+    GSList *dnd = roster_get_contacts_by_presence("dnd");
+    GSList *offline = roster_get_contacts_by_presence("offline");
+
+    assert_null(dnd);
+    assert_int_equal(2, g_slist_length(offline));
+    assert_string_equal("dave@server.org", p_contact_barejid(offline->data));
+    assert_string_equal("james@server.org", p_contact_barejid(offline->next->data));
+    g_slist_free(offline);
+    roster_free();
+}
+
+void update_groups_moves_contact_between_groups(void **state)
+{
+    roster_init();
+    GSList *groups = g_slist_append(NULL, strdup("friends"));
+    roster_add("james@server.org", NULL, groups, NULL, FALSE);
+    roster_add("dave@server.org", NULL, NULL, NULL, FALSE);
+
+    roster_update("james@server.org", NULL, g_slist_append(NULL, strdup("work")), NULL, FALSE);
+    roster_update("dave@server.org", NULL, g_slist_append(NULL, strdup("friends")), NULL, FALSE);
+    GSList *friends = roster_get_group("friends");
+    GSList *work = roster_get_group("work");
+    GSList *nogroup = roster_get_nogroup();
+
+    assert_int_equal(1, g_slist_length(friends));
+    assert_string_equal("dave@server.org", p_contact_barejid(friends->data));
+    assert_int_equal(1, g_slist_length(work));
+    assert_string_equal("james@server.org", p_contact_barejid(work->data));
+    assert_null(nogroup);
+    g_slist_free(friends);
+    g_slist_free(work);
+    roster_free();
+}
+
+void remove_drops_contact_from_indexes(void **state)
+{
+    roster_init();
+    GSList *groups = g_slist_append(NULL, strdup("friends"));
+    roster_add("james@server.org", NULL, groups, NULL, FALSE);
+    roster_add("dave@server.org", NULL, NULL, NULL, FALSE);
+
+    roster_remove("james@server.org", "james@server.org");
+    GSList *all = roster_get_contacts();
+    GSList *friends = roster_get_group("friends");
+    GSList *offline = roster_get_contacts_by_presence("offline");
+
+    assert_int_equal(1, g_slist_length(all));
+    assert_null(friends);
+    assert_int_equal(1, g_slist_length(offline));
+    g_slist_free(all);
+    g_slist_free(offline);
+    roster_free();
+}
+
+void count_online_follows_presence(void **state)
+{
+    roster_init();
+    roster_add("james@server.org", NULL, NULL, NULL, FALSE);
+    roster_add("dave@server.org", NULL, NULL, NULL, FALSE);
+    roster_add("bob@server.org", NULL, NULL, NULL, FALSE);
+
+    assert_int_equal(0, roster_count_online());
+
+    roster_update_presence("dave@server.org", resource_new("laptop", RESOURCE_AWAY, NULL, 0), NULL);
+    roster_update_presence("bob@server.org", resource_new("laptop", RESOURCE_ONLINE, NULL, 0), NULL);
+    assert_int_equal(2, roster_count_online());
+
+    roster_contact_offline("dave@server.org", "laptop", NULL);
+    assert_int_equal(1, roster_count_online());
+    roster_free();
+}
+
+void load_orders_and_completes_contacts(void **state)
+{
+    roster_init();
+    roster_load_begin();
+    roster_add("james@server.org", NULL, g_slist_append(NULL, strdup("work")), NULL, FALSE);
+    roster_add("dave@server.org", NULL, NULL, NULL, FALSE);
+    roster_add("bob@server.org", "zack", g_slist_append(NULL, strdup("work")), NULL, FALSE);
+    roster_add("alice@server.org", NULL, g_slist_append(NULL, strdup("friends")), NULL, FALSE);
+    roster_load_end();
+
+    GSList *all = roster_get_contacts();
+    GSList *work = roster_get_group("work");
+    GSList *nogroup = roster_get_nogroup();
+
+    assert_int_equal(4, g_slist_length(all));
+    assert_string_equal("alice@server.org", p_contact_barejid(all->data));
+    assert_string_equal("dave@server.org", p_contact_barejid(all->next->data));
+    assert_string_equal("james@server.org", p_contact_barejid(all->next->next->data));
+    assert_string_equal("bob@server.org", p_contact_barejid(all->next->next->next->data));
+    assert_int_equal(2, g_slist_length(work));
+    assert_string_equal("james@server.org", p_contact_barejid(work->data));
+    assert_string_equal("bob@server.org", p_contact_barejid(work->next->data));
+    assert_int_equal(1, g_slist_length(nogroup));
+
+    char *name = roster_contact_autocomplete("za");
+    char *group = roster_group_autocomplete("w");
+    char *barejid = roster_barejid_autocomplete("b");
+    assert_string_equal("zack", name);
+    assert_string_equal("work", group);
+    assert_string_equal("bob@server.org", barejid);
+    free(name);
+    free(group);
+    free(barejid);
+    g_slist_free(all);
+    g_slist_free(work);
+    g_slist_free(nogroup);
+    roster_free();
+}
+
+void load_ignores_duplicate_contacts(void **state)
+{
+    roster_init();
+    roster_load_begin();
+    roster_add("james@server.org", NULL, NULL, NULL, FALSE);
+    gboolean added = roster_add("james@server.org", NULL, NULL, NULL, FALSE);
+    roster_load_end();
+
+    GSList *all = roster_get_contacts();
+
+    assert_false(added);
+    assert_int_equal(1, g_slist_length(all));
+    g_slist_free(all);
+    roster_free();
+}
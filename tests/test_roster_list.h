@@ -16,3 +16,12 @@ void find_on_empty_returns_null(void **state);
 void find_twice_returns_second_when_two_match(void **state);
 void find_five_times_finds_fifth(void **state);
 void find_twice_returns_first_when_two_match_and_reset(void **state);
+void contacts_ordered_by_name_or_barejid(void **state);
+void change_name_moves_contact(void **state);
+void presence_change_moves_contact_between_presences(void **state);
+void offline_moves_contact_back_to_offline(void **state);
+void update_groups_moves_contact_between_groups(void **state);
+void remove_drops_contact_from_indexes(void **state);
+void count_online_follows_presence(void **state);
+void load_orders_and_completes_contacts(void **state);
+void load_ignores_duplicate_contacts(void **state);
@@ -210,3 +210,41 @@ void lost_connection_clears_chat_sessions(void **state)
     assert_null(session1);
     assert_null(session2);
 }
+
+void console_doesnt_show_online_presence_during_login_burst(void **state)
+{
+    prefs_set_string(PREF_STATUSES_CONSOLE, "all");
+    chat_sessions_init();
+    roster_init();
+    roster_add("test1@server", "bob", NULL, "both", FALSE);
+    Resource *resource = resource_new("resource", RESOURCE_ONLINE, NULL, 10);
+
+    handle_roster_received();
+    handle_contact_online("test1@server", resource, NULL);
+
+    expect_any_cons_show_error();
+    handle_lost_connection();
+    roster_clear();
+}
+
+void console_shows_online_presence_after_login_burst_cancelled(void **state)
+{
+    prefs_set_string(PREF_STATUSES_CONSOLE, "all");
+    chat_sessions_init();
+    roster_init();
+    handle_roster_received();
+    expect_any_cons_show_error();
+    handle_lost_connection();
+
+    roster_add("test1@server", "bob", NULL, "both", FALSE);
+    Resource *resource = resource_new("resource", RESOURCE_ONLINE, NULL, 10);
+    PContact contact = roster_get_contact("test1@server");
+
+    expect_memory(cons_show_contact_online, contact, contact, sizeof(contact));
+    expect_memory(cons_show_contact_online, resource, resource, sizeof(resource));
+    expect_value(cons_show_contact_online, last_activity, NULL);
+
+    handle_contact_online("test1@server", resource, NULL);
+
+    roster_clear();
+}
@@ -12,3 +12,5 @@ void handle_presence_error_when_no_recipient(void **state);
 void handle_presence_error_when_from_recipient(void **state);
 void handle_offline_removes_chat_session(void **state);
 void lost_connection_clears_chat_sessions(void **state);
+void console_doesnt_show_online_presence_during_login_burst(void **state);
+void console_shows_online_presence_after_login_burst_cancelled(void **state);
@@ -0,0 +1,125 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+
+#include "tools/spscqueue.h"
+
+#define THREAD_ITEMS 100000
+
+void
+spscqueue_pop_empty_returns_null(void **state)
+{
+    SpscQueue queue = spscqueue_new(4);
+
+    assert_null(spscqueue_pop(queue));
+    assert_true(spscqueue_is_empty(queue));
+
+    spscqueue_free(queue);
+}
+
+void
+spscqueue_pops_in_push_order(void **state)
+{
+    SpscQueue queue = spscqueue_new(4);
+    int items[] = { 1, 2, 3 };
+
+    spscqueue_push(queue, &items[0]);
+    spscqueue_push(queue, &items[1]);
+    spscqueue_push(queue, &items[2]);
+
+    assert_true(spscqueue_pop(queue) == &items[0]);
+    assert_true(spscqueue_pop(queue) == &items[1]);
+    assert_true(spscqueue_pop(queue) == &items[2]);
+    assert_null(spscqueue_pop(queue));
+
+    spscqueue_free(queue);
+}
+
+void
+spscqueue_push_full_returns_false(void **state)
+{
+    SpscQueue queue = spscqueue_new(3);
+    int item = 1;
+
+    // rounded up, one slot is kept free
+    assert_true(spscqueue_push(queue, &item));
+    assert_true(spscqueue_push(queue, &item));
+    assert_true(spscqueue_push(queue, &item));
+    assert_false(spscqueue_push(queue, &item));
+
+    spscqueue_pop(queue);
+    assert_true(spscqueue_push(queue, &item));
+
+    spscqueue_free(queue);
+}
+
+void
+spscqueue_holds_requested_capacity(void **state)
+{
+    SpscQueue queue = spscqueue_new(8);
+    int item = 1;
+
+    int i;
+    for (i = 0; i < 8; i++) {
+        assert_true(spscqueue_push(queue, &item));
+    }
+
+    spscqueue_free(queue);
+}
+
+void
+spscqueue_wraps_around(void **state)
+{
+    SpscQueue queue = spscqueue_new(2);
+    int items[10];
+
+    int i;
+    for (i = 0; i < 10; i++) {
+        assert_true(spscqueue_push(queue, &items[i]));
+        assert_true(spscqueue_pop(queue) == &items[i]);
+    }
+    assert_true(spscqueue_is_empty(queue));
+
+    spscqueue_free(queue);
+}
+
+static gpointer
+_produce(gpointer data)
+{
+    SpscQueue queue = data;
+
+    glong i;
+    for (i = 1; i <= THREAD_ITEMS; i++) {
+        while (!spscqueue_push(queue, GINT_TO_POINTER(i))) {
+            g_thread_yield();
+        }
+    }
+
+    return NULL;
+}
+
+void
+spscqueue_passes_items_between_threads(void **state)
+{
+    SpscQueue queue = spscqueue_new(16);
+    GThread *producer = g_thread_new("producer", _produce, queue);
+
+    glong expected = 1;
+    while (expected <= THREAD_ITEMS) {
+        void *item = spscqueue_pop(queue);
+        if (item == NULL) {
+            g_thread_yield();
+        } else {
+            assert_int_equal(GPOINTER_TO_INT(item), expected);
+            expected++;
+        }
+    }
+
+    g_thread_join(producer);
+    assert_true(spscqueue_is_empty(queue));
+
+    spscqueue_free(queue);
+}
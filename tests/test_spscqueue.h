@@ -0,0 +1,6 @@
+void spscqueue_pop_empty_returns_null(void **state);
+void spscqueue_pops_in_push_order(void **state);
+void spscqueue_push_full_returns_false(void **state);
+void spscqueue_holds_requested_capacity(void **state);
+void spscqueue_wraps_around(void **state);
+void spscqueue_passes_items_between_threads(void **state);
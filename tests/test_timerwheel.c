@@ -0,0 +1,190 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+
+#include "tools/timerwheel.h"
+
+static gint64 now_ms;
+static int fired;
+static gint next_delay;
+static TimerWheel test_wheel;
+static ProfTimer test_timer;
+
+static gint64
+_clock(void)
+{
+    return now_ms;
+}
+
+static gint
+_count(void *data)
+{
+    fired++;
+    return next_delay;
+}
+
+static gint
+_remove_self(void *data)
+{
+    fired++;
+    timerwheel_remove(test_wheel, test_timer);
+    return 10;
+}
+
+static TimerWheel
+_new_wheel(void)
+{
+    now_ms = 1000;
+    fired = 0;
+    next_delay = TIMER_STOP;
+    return timerwheel_new(_clock);
+}
+
+void timerwheel_runs_timer_when_due(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    timerwheel_add(wheel, "test", 100, _count, NULL);
+
+    now_ms += 99;
+    timerwheel_run(wheel);
+    assert_int_equal(0, fired);
+
+    now_ms += 1;
+    timerwheel_run(wheel);
+    assert_int_equal(1, fired);
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_stops_timer_when_func_returns_stop(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    ProfTimer timer = timerwheel_add(wheel, "test", 10, _count, NULL);
+
+    now_ms += 10;
+    timerwheel_run(wheel);
+    now_ms += 1000;
+    timerwheel_run(wheel);
+
+    assert_int_equal(1, fired);
+    assert_false(timerwheel_timer_pending(timer));
+    assert_int_equal(-1, timerwheel_timer_remaining(wheel, timer));
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_runs_timer_again_after_returned_delay(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    timerwheel_add(wheel, "test", 10, _count, NULL);
+    next_delay = 50;
+
+    now_ms += 10;
+    timerwheel_run(wheel);
+    now_ms += 49;
+    timerwheel_run(wheel);
+    assert_int_equal(1, fired);
+
+    now_ms += 1;
+    timerwheel_run(wheel);
+    assert_int_equal(2, fired);
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_next_timeout_is_earliest_timer(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    timerwheel_add(wheel, "later", 90000, _count, NULL);
+    timerwheel_add(wheel, "sooner", 5000, _count, NULL);
+    timerwheel_add(wheel, "stopped", TIMER_STOP, _count, NULL);
+
+    assert_int_equal(5000, timerwheel_next_timeout(wheel));
+
+    now_ms += 2000;
+    assert_int_equal(3000, timerwheel_next_timeout(wheel));
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_next_timeout_none_when_all_stopped(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    timerwheel_add(wheel, "stopped", TIMER_STOP, _count, NULL);
+
+    assert_int_equal(-1, timerwheel_next_timeout(wheel));
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_reset_moves_timer(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    ProfTimer timer = timerwheel_add(wheel, "test", 100, _count, NULL);
+
+    timerwheel_reset(wheel, timer, 300);
+    now_ms += 100;
+    timerwheel_run(wheel);
+    assert_int_equal(0, fired);
+    assert_int_equal(200, timerwheel_next_timeout(wheel));
+
+    now_ms += 200;
+    timerwheel_run(wheel);
+    assert_int_equal(1, fired);
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_runs_timer_beyond_first_level(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    timerwheel_add(wheel, "hour", 3600000, _count, NULL);
+
+    now_ms += 3599999;
+    timerwheel_run(wheel);
+    assert_int_equal(0, fired);
+    assert_int_equal(1, timerwheel_next_timeout(wheel));
+
+    now_ms += 1;
+    timerwheel_run(wheel);
+    assert_int_equal(1, fired);
+
+    timerwheel_free(wheel);
+}
+
+void timerwheel_remove_from_own_func(void **state)
+{
+    test_wheel = _new_wheel();
+    test_timer = timerwheel_add(test_wheel, "test", 10, _remove_self, NULL);
+
+    now_ms += 10;
+    timerwheel_run(test_wheel);
+    now_ms += 10;
+    timerwheel_run(test_wheel);
+
+    assert_int_equal(1, fired);
+    assert_null(timerwheel_timers(test_wheel));
+
+    timerwheel_free(test_wheel);
+}
+
+void timerwheel_timers_ordered_by_due(void **state)
+{
+    TimerWheel wheel = _new_wheel();
+    timerwheel_add(wheel, "stopped", TIMER_STOP, _count, NULL);
+    timerwheel_add(wheel, "later", 2000, _count, NULL);
+    timerwheel_add(wheel, "sooner", 1000, _count, NULL);
+
+    GList *timers = timerwheel_timers(wheel);
+
+    assert_int_equal(3, g_list_length(timers));
+    assert_string_equal("sooner", timerwheel_timer_name(timers->data));
+    assert_string_equal("later", timerwheel_timer_name(timers->next->data));
+    assert_string_equal("stopped", timerwheel_timer_name(timers->next->next->data));
+
+    g_list_free(timers);
+    timerwheel_free(wheel);
+}
@@ -0,0 +1,9 @@
+void timerwheel_runs_timer_when_due(void **state);
+void timerwheel_stops_timer_when_func_returns_stop(void **state);
+void timerwheel_runs_timer_again_after_returned_delay(void **state);
+void timerwheel_next_timeout_is_earliest_timer(void **state);
+void timerwheel_next_timeout_none_when_all_stopped(void **state);
+void timerwheel_reset_moves_timer(void **state);
+void timerwheel_runs_timer_beyond_first_level(void **state);
+void timerwheel_remove_from_own_func(void **state);
+void timerwheel_timers_ordered_by_due(void **state);
@@ -0,0 +1,129 @@
+#include <glib.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tools/trie.h"
+
+static int freed;
+
+static void
+_count_free(gpointer value)
+{
+    freed++;
+}
+
+void trie_lookup_empty_returns_null(void **state)
+{
+    Trie trie = trie_new(NULL);
+
+    assert_null(trie_lookup(trie, "/msg"));
+    assert_null(trie_lookup_prefix(trie, "/msg bob", NULL));
+
+    trie_free(trie);
+}
+
+void trie_lookup_finds_inserted(void **state)
+{
+    Trie trie = trie_new(NULL);
+    trie_insert(trie, "/msg", "msg");
+    trie_insert(trie, "/me", "me");
+    trie_insert(trie, "/join", "join");
+
+    assert_string_equal("msg", trie_lookup(trie, "/msg"));
+    assert_string_equal("me", trie_lookup(trie, "/me"));
+    assert_string_equal("join", trie_lookup(trie, "/join"));
+
+    trie_free(trie);
+}
+
+void trie_lookup_needs_whole_key(void **state)
+{
+    Trie trie = trie_new(NULL);
+    trie_insert(trie, "/msg", "msg");
+
+    assert_null(trie_lookup(trie, "/ms"));
+    assert_null(trie_lookup(trie, "/msgs"));
+
+    trie_free(trie);
+}
+
+void trie_insert_replaces_value(void **state)
+{
+    Trie trie = trie_new(NULL);
+    trie_insert(trie, "/msg", "first");
+    trie_insert(trie, "/msg", "second");
+
+    assert_string_equal("second", trie_lookup(trie, "/msg"));
+
+    trie_free(trie);
+}
+
+void trie_insert_frees_replaced_value(void **state)
+{
+    freed = 0;
+    Trie trie = trie_new(_count_free);
+    trie_insert(trie, "/msg", "first");
+    trie_insert(trie, "/msg", "first");
+    trie_insert(trie, "/msg", "second");
+
+    assert_int_equal(1, freed);
+
+    trie_free(trie);
+}
+
+void trie_prefix_finds_longest_key(void **state)
+{
+    Trie trie = trie_new(NULL);
+    trie_insert(trie, "/field", "field");
+    trie_insert(trie, "/join ", "join");
+    trie_insert(trie, "/join room ", "room");
+
+    assert_string_equal("field", trie_lookup_prefix(trie, "/field3 val", NULL));
+    assert_string_equal("join", trie_lookup_prefix(trie, "/join roo", NULL));
+    assert_string_equal("room", trie_lookup_prefix(trie, "/join room nick", NULL));
+
+    trie_free(trie);
+}
+
+void trie_prefix_stores_length(void **state)
+{
+    Trie trie = trie_new(NULL);
+    trie_insert(trie, "/join ", "join");
+    int len = 0;
+
+    trie_lookup_prefix(trie, "/join room@server", &len);
+
+    assert_int_equal(6, len);
+
+    trie_free(trie);
+}
+
+void trie_prefix_no_match_returns_null(void **state)
+{
+    Trie trie = trie_new(NULL);
+    trie_insert(trie, "/join ", "join");
+    int len = 5;
+
+    assert_null(trie_lookup_prefix(trie, "/join", &len));
+    assert_int_equal(0, len);
+    assert_null(trie_lookup_prefix(trie, "/msg bob", NULL));
+
+    trie_free(trie);
+}
+
+void trie_free_frees_values(void **state)
+{
+    freed = 0;
+    Trie trie = trie_new(_count_free);
+    trie_insert(trie, "/msg", "msg");
+    trie_insert(trie, "/me", "me");
+    trie_insert(trie, "/m", "m");
+
+    trie_free(trie);
+
+    assert_int_equal(3, freed);
+}
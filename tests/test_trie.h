@@ -0,0 +1,9 @@
+void trie_lookup_empty_returns_null(void **state);
+void trie_lookup_finds_inserted(void **state);
+void trie_lookup_needs_whole_key(void **state);
+void trie_insert_replaces_value(void **state);
+void trie_insert_frees_replaced_value(void **state);
+void trie_prefix_finds_longest_key(void **state);
+void trie_prefix_stores_length(void **state);
+void trie_prefix_no_match_returns_null(void **state);
+void trie_free_frees_values(void **state);
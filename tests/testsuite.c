@@ -35,6 +35,16 @@
 #include "test_cmd_win.h"
 #include "test_cmd_disconnect.h"
 #include "test_form.h"
+#include "test_buffer.h"
+#include "test_linebreak.h"
+#include "test_timerwheel.h"
+#include "test_spscqueue.h"
+#include "test_frame.h"
+#include "test_intset.h"
+#include "test_intern.h"
+#include "test_trie.h"
+#include "test_capabilities.h"
+#include "test_command.h"
 
 int main(int argc, char* argv[]) {
     const UnitTest all_tests[] = {
@@ -85,12 +95,6 @@ int main(int argc, char* argv[]) {
         unit_test(test_p_sha1_hash5),
         unit_test(test_p_sha1_hash6),
         unit_test(test_p_sha1_hash7),
-        unit_test(utf8_display_len_null_str),
-        unit_test(utf8_display_len_1_non_wide),
-        unit_test(utf8_display_len_1_wide),
-        unit_test(utf8_display_len_non_wide),
-        unit_test(utf8_display_len_wide),
-        unit_test(utf8_display_len_all_wide),
         unit_test(strip_quotes_does_nothing_when_no_quoted),
         unit_test(strip_quotes_strips_first),
         unit_test(strip_quotes_strips_last),
@@ -106,6 +110,18 @@ int main(int argc, char* argv[]) {
         unit_test(add_two_adds_two),
         unit_test(add_two_same_adds_one),
         unit_test(add_two_same_updates),
+        unit_test(add_all_adds_sorted_without_duplicates),
+        unit_test(add_all_merges_with_existing),
+        unit_test(fuzzy_not_used_when_disabled),
+        unit_test(fuzzy_not_used_for_plain_autocomplete),
+        unit_test(fuzzy_finds_subsequence),
+        unit_test(fuzzy_ignores_case),
+        unit_test(fuzzy_prefers_prefix_matches),
+        unit_test(fuzzy_ranks_and_cycles_matches),
+        unit_test(fuzzy_ranks_recently_used_first),
+        unit_test(fuzzy_cycle_survives_remove),
+        unit_test(reset_all_restarts_search),
+        unit_test(reset_all_leaves_new_search_alone),
 
         unit_test(previous_on_empty_returns_null),
         unit_test(next_on_empty_returns_null),
@@ -146,6 +162,16 @@ int main(int argc, char* argv[]) {
         unit_test(create_full_with_trailing_slash),
         unit_test(returns_fulljid_when_exists),
         unit_test(returns_barejid_when_fulljid_not_exists),
+        unit_test(view_from_null_returns_false),
+        unit_test(view_from_empty_string_returns_false),
+        unit_test(view_with_leading_separator_returns_false),
+        unit_test(view_from_invalid_utf8_returns_false),
+        unit_test(view_from_full_points_into_string),
+        unit_test(view_from_bare_has_no_resource),
+        unit_test(view_from_nolocal_has_no_localpart),
+        unit_test(view_with_at_and_slash_in_resource),
+        unit_test(view_matches_jid_create),
+        unit_test(view_rejects_too_long),
 
         unit_test(parse_null_returns_null),
         unit_test(parse_empty_returns_null),
@@ -216,6 +242,15 @@ int main(int argc, char* argv[]) {
         unit_test(find_twice_returns_second_when_two_match),
         unit_test(find_five_times_finds_fifth),
         unit_test(find_twice_returns_first_when_two_match_and_reset),
+        unit_test(contacts_ordered_by_name_or_barejid),
+        unit_test(change_name_moves_contact),
+        unit_test(presence_change_moves_contact_between_presences),
+        unit_test(offline_moves_contact_back_to_offline),
+        unit_test(update_groups_moves_contact_between_groups),
+        unit_test(remove_drops_contact_from_indexes),
+        unit_test(count_online_follows_presence),
+        unit_test(load_orders_and_completes_contacts),
+        unit_test(load_ignores_duplicate_contacts),
 
         unit_test_setup_teardown(returns_false_when_chat_session_does_not_exist,
             init_chat_sessions,
@@ -438,6 +473,30 @@ int main(int argc, char* argv[]) {
         unit_test_setup_teardown(statuses_muc_defaults_to_all,
             load_preferences,
             close_preferences),
+        unit_test_setup_teardown(peek_string_returns_default,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(peek_string_returns_same_value_each_call,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(peek_string_returns_value_after_set,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(peek_string_returns_default_after_unset,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(get_boolean_returns_value_after_set,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(get_reconnect_returns_value_after_set,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(get_frame_rate_returns_value_after_set,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(load_raises_no_criticals,
+            load_preferences,
+            close_preferences),
 
         unit_test_setup_teardown(console_doesnt_show_online_presence_when_set_none,
             load_preferences,
@@ -469,6 +528,12 @@ int main(int argc, char* argv[]) {
         unit_test(handle_presence_error_when_from_recipient),
         unit_test(handle_offline_removes_chat_session),
         unit_test(lost_connection_clears_chat_sessions),
+        unit_test_setup_teardown(console_doesnt_show_online_presence_during_login_burst,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(console_shows_online_presence_after_login_burst_cancelled,
+            load_preferences,
+            close_preferences),
 
         unit_test(cmd_alias_add_shows_usage_when_no_args),
         unit_test(cmd_alias_add_shows_usage_when_no_value),
@@ -490,6 +555,16 @@ int main(int argc, char* argv[]) {
             load_preferences,
             close_preferences),
 
+        unit_test_setup_teardown(cmd_get_finds_every_command,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(cmd_get_unknown_returns_null,
+            load_preferences,
+            close_preferences),
+        unit_test_setup_teardown(cmd_get_after_uninit_returns_null,
+            load_preferences,
+            close_preferences),
+
         unit_test_setup_teardown(test_muc_invites_add, muc_before_test, muc_after_test),
         unit_test_setup_teardown(test_muc_remove_invite, muc_before_test, muc_after_test),
         unit_test_setup_teardown(test_muc_invites_count_0, muc_before_test, muc_after_test),
@@ -626,6 +701,96 @@ int main(int argc, char* argv[]) {
         unit_test(remove_text_multi_value_removes_when_many),
 
         unit_test(clears_chat_sessions),
+
+        unit_test(buffer_empty_after_create),
+        unit_test(buffer_push_one_increases_size),
+        unit_test(buffer_yield_returns_in_push_order),
+        unit_test(buffer_size_stops_at_capacity),
+        unit_test(buffer_evicts_oldest_when_full),
+        unit_test(buffer_wraps_many_times),
+        unit_test(buffer_push_has_no_wrap_layout),
+        unit_test(buffer_mark_cleared_hides_pushed_entries),
+        unit_test(buffer_cleared_drops_as_oldest_evicted),
+        unit_test(buffer_entry_wrap_reused_for_same_width),
+        unit_test(buffer_entry_wrap_rebuilt_when_width_changes),
+        unit_test(buffer_entries_share_sender),
+        unit_test(buffer_keeps_sender_after_first_evicted),
+        unit_test(buffer_keeps_time),
+        unit_test(buffer_keeps_messages_larger_than_chunk),
+        unit_test(buffer_memory_stays_level_when_full),
+
+        unit_test(linebreak_display_len_null_str),
+        unit_test(linebreak_display_len_1_non_wide),
+        unit_test(linebreak_display_len_1_wide),
+        unit_test(linebreak_display_len_non_wide),
+        unit_test(linebreak_display_len_wide),
+        unit_test(linebreak_display_len_all_wide),
+        unit_test(linebreak_display_len_combining_is_zero_width),
+        unit_test(linebreak_display_len_long_ascii),
+        unit_test(linebreak_no_breaks_when_message_fits),
+        unit_test(linebreak_wraps_word_that_does_not_fit),
+        unit_test(linebreak_wraps_by_display_width),
+        unit_test(linebreak_indents_after_newline),
+        unit_test(linebreak_indents_long_word_on_each_row),
+
+        unit_test(timerwheel_runs_timer_when_due),
+        unit_test(timerwheel_stops_timer_when_func_returns_stop),
+        unit_test(timerwheel_runs_timer_again_after_returned_delay),
+        unit_test(timerwheel_next_timeout_is_earliest_timer),
+        unit_test(timerwheel_next_timeout_none_when_all_stopped),
+        unit_test(timerwheel_reset_moves_timer),
+        unit_test(timerwheel_runs_timer_beyond_first_level),
+        unit_test(timerwheel_remove_from_own_func),
+        unit_test(timerwheel_timers_ordered_by_due),
+
+        unit_test(spscqueue_pop_empty_returns_null),
+        unit_test(spscqueue_pops_in_push_order),
+        unit_test(spscqueue_push_full_returns_false),
+        unit_test(spscqueue_holds_requested_capacity),
+        unit_test(spscqueue_wraps_around),
+        unit_test(spscqueue_passes_items_between_threads),
+
+        unit_test(frame_first_frame_draws_all),
+        unit_test(frame_nothing_dirty_skips_frame),
+        unit_test(frame_draws_only_dirty_parts),
+        unit_test(frame_defers_frame_within_interval),
+        unit_test(frame_draws_deferred_frame_after_interval),
+        unit_test(frame_uncapped_never_defers),
+        unit_test(frame_begin_now_ignores_cap),
+
+        unit_test(intset_keeps_values_in_order),
+        unit_test(intset_add_existing_returns_false),
+        unit_test(intset_remove_missing_returns_false),
+        unit_test(intset_next_and_prev_of_member),
+        unit_test(intset_next_and_prev_of_non_member),
+        unit_test(intset_first_and_last_of_empty_is_none),
+        unit_test(intset_first_gap_when_from_missing),
+        unit_test(intset_first_gap_inside_run),
+        unit_test(intset_first_gap_after_run),
+        unit_test(intset_index_of_value),
+
+        unit_test(intern_equal_strings_share_copy),
+        unit_test(intern_different_strings_differ),
+        unit_test(intern_lookup_finds_held_string),
+        unit_test(intern_lookup_unheld_returns_null),
+        unit_test(intern_string_freed_after_last_unref),
+        unit_test(intern_counts_refs_and_saved_bytes),
+        unit_test(intern_null_is_null),
+
+        unit_test(trie_lookup_empty_returns_null),
+        unit_test(trie_lookup_finds_inserted),
+        unit_test(trie_lookup_needs_whole_key),
+        unit_test(trie_insert_replaces_value),
+        unit_test(trie_insert_frees_replaced_value),
+        unit_test(trie_prefix_finds_longest_key),
+        unit_test(trie_prefix_stores_length),
+        unit_test(trie_prefix_no_match_returns_null),
+        unit_test(trie_free_frees_values),
+
+        unit_test(caps_request_queues_while_in_flight),
+        unit_test(caps_request_asks_next_contact_on_timeout),
+        unit_test(caps_request_ignores_reply_after_timeout),
+        unit_test(caps_request_done_when_none_waiting),
     };
 
     return run_tests(all_tests);
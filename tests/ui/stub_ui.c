@@ -56,6 +56,7 @@ expect_ui_current_print_formatted_line(char show_char, int attrs, char *message)
 void ui_init(void) {}
 void ui_load_colours(void) {}
 void ui_update(void) {}
+void ui_update_now(void) {}
 void ui_close(void) {}
 void ui_redraw(void) {}
 void ui_resize(void) {}
@@ -73,6 +74,8 @@ gboolean ui_switch_win(const int i)
 
 void ui_next_win(void) {}
 void ui_previous_win(void) {}
+void ui_next_unread_win(void) {}
+void ui_next_mention_win(void) {}
 
 void ui_gone_secure(const char * const barejid, gboolean trusted) {}
 void ui_gone_insecure(const char * const barejid) {}
@@ -106,6 +109,11 @@ gint ui_unread(void)
     return 0;
 }
 
+gint ui_mentions(void)
+{
+    return 0;
+}
+
 void ui_close_connected_win(int index) {}
 int ui_close_all_wins(void)
 {
@@ -263,6 +271,7 @@ gboolean ui_chat_win_exists(const char * const barejid)
 }
 
 void ui_contact_offline(char *barejid, char *resource, char *status) {}
+void ui_contact_presence_changed(const char * const barejid) {}
 
 void ui_handle_recipient_not_found(const char * const recipient, const char * const err_msg)
 {
@@ -331,7 +340,6 @@ char * ui_readline(void)
 void ui_inp_history_append(char *inp) {}
 
 void ui_input_clear(void) {}
-void ui_input_nonblocking(gboolean reset) {}
 
 void ui_invalid_command_usage(const char * const usage, void (*setting_func)(void)) {}
 
@@ -398,6 +406,8 @@ void cons_show_roster(GSList * list)
 
 void cons_show_roster_group(const char * const group, GSList * list) {}
 void cons_show_wins(void) {}
+void cons_show_stats(void) {}
+void cons_show_timers(void) {}
 void cons_show_status(const char * const barejid) {}
 void cons_show_info(PContact pcontact) {}
 void cons_show_caps(const char * const fulljid, resource_presence_t presence) {}
@@ -447,10 +457,12 @@ void cons_occupants_setting(void) {}
 void cons_roster_setting(void) {}
 void cons_presence_setting(void) {}
 void cons_wrap_setting(void) {}
+void cons_fuzzy_setting(void) {}
 void cons_time_setting(void) {}
 void cons_mouse_setting(void) {}
 void cons_statuses_setting(void) {}
 void cons_titlebar_setting(void) {}
+void cons_frame_rate_setting(void) {}
 void cons_notify_setting(void) {}
 void cons_states_setting(void) {}
 void cons_outtype_setting(void) {}
@@ -465,7 +477,6 @@ void cons_reconnect_setting(void) {}
 void cons_autoping_setting(void) {}
 void cons_priority_setting(void) {}
 void cons_autoconnect_setting(void) {}
-void cons_inpblock_setting(void) {}
 
 void cons_show_contact_online(PContact contact, Resource *resource, GDateTime *last_activity)
 {
@@ -479,6 +490,8 @@ void cons_theme_colours(void) {}
 
 // roster window
 void rosterwin_roster(void) {}
+void rosterwin_draw(ProfLayoutSplit *layout) {}
+void rosterwin_forget(void) {}
 
 // occupants window
 void occupantswin_occupants(const char * const room) {}
@@ -490,7 +503,7 @@ void notify_typing(const char * const handle) {}
 void notify_message(const char * const handle, int win, const char * const text) {}
 void notify_room_message(const char * const handle, const char * const room,
     int win, const char * const text) {}
-void notify_remind(void) {}
+void notify_remind_reset(void) {}
 void notify_invite(const char * const from, const char * const room,
     const char * const reason) {}
 void notify_subscription(const char * const from) {}
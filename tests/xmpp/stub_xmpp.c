@@ -26,12 +26,22 @@ jabber_conn_status_t jabber_connect_with_account(const ProfAccount * const accou
 
 void jabber_disconnect(void) {}
 void jabber_shutdown(void) {}
-void jabber_process_events(void) {}
+void jabber_process_events(int millis) {}
+void jabber_set_xmlconsole(gboolean open) {}
+int jabber_get_fd(void)
+{
+    return -1;
+}
 const char * jabber_get_fulljid(void)
 {
     return (char *)mock();
 }
 
+const char * jabber_get_barejid(void)
+{
+    return NULL;
+}
+
 const char * jabber_get_domain(void)
 {
     return NULL;
@@ -136,7 +146,12 @@ void iq_submit_room_config(const char * const room, DataForm *form) {}
 void iq_room_config_cancel(const char * const room_jid) {}
 void iq_send_ping(const char * const target) {}
 void iq_send_caps_request(const char * const to, const char * const id,
-    const char * const node, const char * const ver) {}
+    const char * const node, const char * const ver)
+{
+    check_expected(to);
+    check_expected(node);
+    check_expected(ver);
+}
 void iq_send_caps_request_for_jid(const char * const to, const char * const id,
     const char * const node, const char * const ver) {}
 void iq_send_caps_request_legacy(const char * const to, const char * const id,
@@ -150,15 +165,6 @@ void iq_room_role_set(const char * const room, const char * const nick, char *ro
     const char * const reason) {}
 void iq_room_role_list(const char * const room, char *role) {}
 
-// caps functions
-Capabilities* caps_lookup(const char * const jid)
-{
-    return NULL;
-}
-
-void caps_close(void) {}
-void caps_destroy(Capabilities *caps) {}
-
 gboolean bookmark_add(const char *jid, const char *nick, const char *password, const char *autojoin_str)
 {
     check_expected(jid);